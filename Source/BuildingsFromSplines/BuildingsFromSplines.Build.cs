@@ -27,7 +27,10 @@ public class BuildingsFromSplines : ModuleRules
 				"CoreUObject",
 				"Engine",
 				"GeometryCore",
+				"DynamicMesh",
+				"ModelingOperators",
 				"GeometryScriptingCore",
+				"Landscape",
 				"SlateCore",
 
 				// Landscape Combinator Dependencies
@@ -3,6 +3,8 @@
 
 #include "BuildingsFromSplines/Building.h"
 #include "BuildingsFromSplines/LogBuildingsFromSplines.h"
+#include "BuildingsFromSplines/PolygonOffset.h"
+#include "BuildingsFromSplines/MeshFunctions.h"
 #include "OSMUserData/OSMUserData.h"
 #include "LCCommon/LCBlueprintLibrary.h"
 #include "LCCommon/Expression.h"
@@ -27,6 +29,7 @@
 #include "Logging/StructuredLog.h"
 #include "Polygon2.h"
 #include "Algo/Reverse.h"
+#include "Algo/BinarySearch.h"
 #include "Stats/Stats.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "Misc/MessageDialog.h"
@@ -38,6 +41,12 @@
 
 #include "GeometryScript/CreateNewAssetUtilityFunctions.h"
 #include "AssetUtils/CreateStaticMeshUtil.h"
+#include "DynamicMesh/DynamicMesh3.h"
+#include "DynamicMesh/DynamicMeshAttributeSet.h"
+#include "DynamicMesh/MeshTransforms.h"
+#include "Hash/xxhash.h"
+#include "UObject/UObjectHash.h"
+#include "Misc/PackageName.h"
 #include "Editor/EditorEngine.h"
 
 
@@ -137,9 +146,13 @@ void ABuilding::ComputeBaseVertices()
 	TRACE_CPUPROFILER_EVENT_SCOPE_STR("ComputeBaseVertices");
 
 	int NumPoints = SplineComponent->GetNumberOfSplinePoints();
-	if (NumPoints == 0) return;
+	SplineNumPoints = NumPoints;
+	bSplineIsClosedLoop = SplineComponent->IsClosedLoop();
 
 	BaseVertices2D.Empty();
+	BaseClockwiseDistances.Empty();
+	if (NumPoints == 0) return;
+
 	SplineIndexToBaseSplineIndex.Empty();
 	SplineIndexToBaseSplineIndex.SetNum(NumPoints + 1);
 
@@ -157,7 +170,7 @@ void ABuilding::ComputeBaseVertices()
 		float Length = Distance2 - Distance1;
 
 		if (Length == 0) continue;
-		if (i == NumPoints - 1 && !SplineComponent->IsClosedLoop()) continue;
+		if (i == NumPoints - 1 && !bSplineIsClosedLoop) continue;
 
 		for (int j = 0; j < BCfg->WallSubdivisions; j++)
 		{
@@ -187,7 +200,7 @@ void ABuilding::ComputeBaseVertices()
 
 	// clockwise for TPolygon2 is counter-clockwise in game (inverted Y axis)
 	// (we only switch the order for closed loops)
-	if (SplineComponent->IsClosedLoop() && BasePolygon.IsClockwise())
+	if (bSplineIsClosedLoop && BasePolygon.IsClockwise())
 	{
 		ClockwiseBaseVertices2D[0] = BaseVertices2D[0];
 		for (int i = 1; i < NumSubPoints; i++)
@@ -198,56 +211,74 @@ void ABuilding::ComputeBaseVertices()
 		BaseVertices2D = ClockwiseBaseVertices2D;
 	}
 	
-	/* Initialize the new spline corresponding to these base vertices */
-	
+	/* Distances along the base polygon, which has linear segments (the closing segment of an open spline has length 0) */
+
+	BaseClockwiseDistances.SetNum(NumSubPoints + 1);
+	BaseClockwiseDistances[0] = 0;
+	for (int i = 1; i <= NumSubPoints; i++)
+	{
+		const bool bHasSegment = i < NumSubPoints || bSplineIsClosedLoop;
+		const double SegmentLength = bHasSegment ? FVector2D::Distance(BaseVertices2D[i - 1], BaseVertices2D[i % NumSubPoints]) : 0;
+		BaseClockwiseDistances[i] = BaseClockwiseDistances[i - 1] + SegmentLength;
+	}
+}
+
+void ABuilding::UpdateBaseClockwiseSplineComponent()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("UpdateBaseClockwiseSplineComponent");
+
 	BaseClockwiseSplineComponent->ClearSplinePoints();
-	for (int i = 0; i < NumSubPoints; i++)
+	for (int i = 0; i < BaseVertices2D.Num(); i++)
 	{
 		FVector2D Point2D = BaseVertices2D[i];
 		BaseClockwiseSplineComponent->AddSplinePoint(FVector(Point2D[0], Point2D[1], MinHeightLocal), ESplineCoordinateSpace::Local, false);
 		BaseClockwiseSplineComponent->SetSplinePointType(i, ESplinePointType::Linear, false);
 	}
-	BaseClockwiseSplineComponent->SetClosedLoop(SplineComponent->IsClosedLoop());
+	BaseClockwiseSplineComponent->SetClosedLoop(bSplineIsClosedLoop);
 	BaseClockwiseSplineComponent->UpdateSpline();
+}
 
-	
-	/* Sample transform splines from the new spline */
-
-	FGeometryScriptSplineSamplingOptions SamplingOptions;
-	SamplingOptions.SampleSpacing = EGeometryScriptSampleSpacing::UniformTime;
-	SamplingOptions.NumSamples = BaseClockwiseSplineComponent->GetNumberOfSplinePoints();
-
-	UGeometryScriptLibrary_PolyPathFunctions::SampleSplineToTransforms(
-		BaseClockwiseSplineComponent,
-		BaseClockwiseFrames,
-		BaseClockwiseFramesTimes,
-		SamplingOptions,
-		FTransform()
-	);
+double ABuilding::GetBaseLength() const
+{
+	return BaseClockwiseDistances.IsEmpty() ? 0 : BaseClockwiseDistances.Last();
+}
+
+FVector2D ABuilding::GetBaseLocationAtDistance(double Distance) const
+{
+	const int NumVertices = BaseVertices2D.Num();
+	if (NumVertices == 0) return FVector2D::ZeroVector;
+
+	Distance = FMath::Clamp(Distance, 0.0, GetBaseLength());
+
+	// index of the segment that contains Distance
+	const int Index = FMath::Clamp(Algo::UpperBound(BaseClockwiseDistances, Distance) - 1, 0, NumVertices - 1);
+	const double SegmentLength = BaseClockwiseDistances[Index + 1] - BaseClockwiseDistances[Index];
+	if (SegmentLength <= 0) return BaseVertices2D[Index];
+
+	const double Alpha = (Distance - BaseClockwiseDistances[Index]) / SegmentLength;
+	return FMath::Lerp(BaseVertices2D[Index], BaseVertices2D[(Index + 1) % NumVertices], Alpha);
+}
+
+int ABuilding::ResolveMaterial(const FString &ExprStr) const
+{
+	return BCfg->ResolveMaterial(ExprStr, MaterialNamesArray);
 }
 
 void ABuilding::AddExternalThickness(double Thickness)
 {
 	if (ExternalWallPolygons.Contains(Thickness)) return;
-	int NumFrames = BaseClockwiseFrames.Num();
-	ExternalWallPolygons.Add(Thickness, TArray<FVector2D>());
-	ExternalWallPolygons[Thickness].Reserve(NumFrames);
-	for (int i = 0; i < NumFrames; i++)
-		ExternalWallPolygons[Thickness].Add(GetShiftedPoint(BaseClockwiseFrames, i, - Thickness, true));
+	PolygonOffset::Shift(BaseVertices2D, - Thickness, ExternalWallPolygons.Add(Thickness));
 }
 
 void ABuilding::AddInternalThickness(double Thickness)
 {
 	if (InternalWallPolygons.Contains(Thickness)) return;
-	int NumFrames = BaseClockwiseFrames.Num();
-	InternalWallPolygons.Add(Thickness, TArray<FVector2D>());
-	InternalWallPolygons[Thickness].Reserve(NumFrames);
-	IndexToInternalIndex.Add(Thickness, TArray<int>());
-	DeflateFrames(
-		BaseClockwiseFrames,
-		InternalWallPolygons[Thickness],
-		IndexToInternalIndex[Thickness],
-		Thickness
+	PolygonOffset::Deflate(
+		BaseVertices2D,
+		BaseVertices2D,
+		Thickness,
+		InternalWallPolygons.Add(Thickness),
+		IndexToInternalIndex.Add(Thickness)
 	);
 }
 
@@ -255,7 +286,7 @@ void ABuilding::ComputeOffsetPolygons()
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE_STR("ComputeOffsetPolygons");
 
-	if (BaseClockwiseFrames.Num() == 0) return;
+	if (BaseVertices2D.Num() == 0) return;
 	
 	ExternalWallPolygons.Empty();
 	InternalWallPolygons.Empty();
@@ -293,132 +324,7 @@ FVector To3D(FVector2D Vector)
 	return FVector(Vector[0], Vector[1], 0);
 }
 
-FVector2D ABuilding::GetShiftedPoint(TArray<FTransform> Frames, int Index, double Offset, bool bIsLoop)
-{
-	TRACE_CPUPROFILER_EVENT_SCOPE_STR("GetShiftedPoint");
-
-	int NumFrames = Frames.Num();
-	check(0 <= Index);
-	check(Index < NumFrames);
-
-	int PrevIndex = (Index + NumFrames - 1) % NumFrames;
-	int NextIndex = (Index + 1) % NumFrames;
-	FVector2D PrevPoint = To2D(Frames[PrevIndex].GetLocation());
-	FVector2D Point = To2D(Frames[Index].GetLocation());
-	FVector2D NextPoint = To2D(Frames[NextIndex].GetLocation());
-
-	if (NumFrames == 1)
-	{
-		return Point;
-	}
-
-	if (Offset == 0)
-	{
-		return Point;
-	}
-
-	FVector2D WallDirection2 = (NextPoint - Point).GetSafeNormal();
-	FVector2D InsideDirection2 = WallDirection2.GetRotated(90);
-	FVector2D WallDirection1 = (Point - PrevPoint).GetSafeNormal();
-	FVector2D InsideDirection1 = WallDirection1.GetRotated(90);
-
-
-	FVector2D PointShift1 = Point + Offset * InsideDirection1;
-	FVector2D PointShift2 = Point + Offset * InsideDirection2;
-
-	if (Index == 0 && !bIsLoop)
-	{
-		return PointShift2;
-	}
-
-	if (Index == NumFrames - 1 && !bIsLoop)
-	{
-		return PointShift1;
-	}
-
-	return GetIntersection(PointShift1, WallDirection1, PointShift2, WallDirection2);
-}
-
-FVector2D ABuilding::GetIntersection(FVector2D Point1, FVector2D Direction1, FVector2D Point2, FVector2D Direction2)
-{
-	TRACE_CPUPROFILER_EVENT_SCOPE_STR("GetIntersection");
-
-	// Point1.X + t * Direction1.X = Point2.X + t' * Direction2.X
-	// Point1.Y + t * Direction1.Y = Point2.Y + t' * Direction2.Y
-
-	// t * Direction1.X - t' * Direction2.X = Point2.X - Point1.X
-	// t * Direction1.Y - t' * Direction2.Y = Point2.Y - Point1.Y
-
-	double Det = -Direction1.X * Direction2.Y + Direction1.Y * Direction2.X;
-
-	FVector2D Intersection;
-
-	if (FMath::IsNearlyEqual(Det, 0, MILLIMETER))
-	{
-		Intersection = Point2;
-	}
-	else
-	{
-		double Num = -(Point2.X - Point1.X) * Direction2.Y + (Point2.Y - Point1.Y) * Direction2.X;
-		double t = Num / Det;
-		Intersection = Point1 + t * Direction1;
-	}
-
-	return Intersection;
-}
-
-void ABuilding::DeflateFrames(TArray<FTransform> Frames, TArray<FVector2D>& OutOffsetPolygon, TArray<int>& OutIndexToOffsetIndex, double Offset)
-{
-	TRACE_CPUPROFILER_EVENT_SCOPE_STR("DeflateFrames");
-
-	int NumFrames = Frames.Num();
-	int NumVertices = BaseVertices2D.Num();
-
-	OutOffsetPolygon.Empty();
-	OutIndexToOffsetIndex.Empty();
-	OutIndexToOffsetIndex.SetNum(NumFrames);
-
-	for (int i = 0; i < NumFrames; i++)
-	{
-		FVector2D Point = GetShiftedPoint(Frames, i, Offset, true);
-
-		bool bIsTooClose = false;
-		
-		// When deflating a polygon, some points might be too close to an edge, we don't add those
-		// TODO: Remove expensive check and implement a proper polygon deflate algorithm
-		// TPolygon2::PolyOffset doesn't help as it has the same artefacts
-		if (Offset > 0)
-		{
-			for (int j = 0; j < NumVertices; j++)
-			{
-				double Distance = TSegment2<double>::FastDistanceSquared(BaseVertices2D[j], BaseVertices2D[(j + 1) % NumVertices], Point);
-				if (Distance < Offset * Offset - MILLIMETER)
-				{
-					bIsTooClose = true;
-					break;
-				}
-			}
-		}
-		
-		if (!bIsTooClose)
-		{
-			OutOffsetPolygon.Add(Point);
-		}
-
-		if (OutOffsetPolygon.IsEmpty())
-		{
-			OutIndexToOffsetIndex[i] = 0;
-		}
-		else
-		{
-			OutIndexToOffsetIndex[i] = OutOffsetPolygon.Num() - 1;
-		}
-	}
-
-	return;
-}
-
-void ABuilding::AppendAlongSpline(UDynamicMesh* TargetMesh, bool bInternalWall, double BeginDistance, double Length, double Height, double ZOffset, double Thickness, int MaterialID)
+void ABuilding::AppendAlongSpline(FDynamicMesh3 &TargetMesh, bool bInternalWall, double BeginDistance, double Length, double Height, double ZOffset, double Thickness, int MaterialID)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE_STR("AppendAlongSpline");
 
@@ -426,13 +332,12 @@ void ABuilding::AppendAlongSpline(UDynamicMesh* TargetMesh, bool bInternalWall,
 	
 	TArray<FVector2D> Polygon = MakePolygon(bInternalWall, BeginDistance, Length, Thickness);
 
-	/* Allocate and build WallMesh */
+	/* Build WallMesh */
 
-	TObjectPtr<UDynamicMesh> WallMesh = NewObject<UDynamicMesh>(this);
+	FDynamicMesh3 WallMesh;
 
-	UGeometryScriptLibrary_MeshPrimitiveFunctions::AppendSimpleExtrudePolygon(
+	MeshFunctions::AppendSimpleExtrudePolygon(
 		WallMesh,
-		FGeometryScriptPrimitiveOptions(),
 		FTransform(FVector(0, 0, ZOffset)),
 		Polygon,
 		Height
@@ -440,26 +345,17 @@ void ABuilding::AppendAlongSpline(UDynamicMesh* TargetMesh, bool bInternalWall,
 	
 	/* Remap the material ID */
 
-	UGeometryScriptLibrary_MeshMaterialFunctions::RemapMaterialIDs(WallMesh, 0, MaterialID);
+	MeshFunctions::RemapMaterialIDs(WallMesh, 0, MaterialID);
 
 
 	/* Add the WallMesh to our TargetMesh */
 
-	UGeometryScriptLibrary_MeshBasicEditFunctions::AppendMesh(TargetMesh, WallMesh, FTransform(), true);
-
-	WallMesh->MarkAsGarbage();
+	MeshFunctions::AppendMesh(TargetMesh, WallMesh, FTransform());
 }
 
-bool SetPolygroupMaterialID(UDynamicMesh *Mesh, int Index, int MaterialID)
+bool SetPolygroupMaterialID(FDynamicMesh3 &Mesh, int Index, int MaterialID)
 {
-	FGeometryScriptIndexList PolygroupIDs0;
-	UGeometryScriptLibrary_MeshPolygroupFunctions::GetPolygroupIDsInMesh(
-		Mesh,
-		FGeometryScriptGroupLayer(),
-		PolygroupIDs0
-	);
-
-	TArray<int> PolygroupIDs = *PolygroupIDs0.List;
+	TArray<int> PolygroupIDs = MeshFunctions::GetPolygroupIDs(Mesh);
 
 	if (Index >= PolygroupIDs.Num())
 	{
@@ -467,55 +363,33 @@ bool SetPolygroupMaterialID(UDynamicMesh *Mesh, int Index, int MaterialID)
 		return false;
 	}
 
-	bool bIsValidPolygroupID;
-	UGeometryScriptLibrary_MeshMaterialFunctions::SetPolygroupMaterialID(
-		Mesh,
-		FGeometryScriptGroupLayer(),
-		PolygroupIDs[Index],
-		MaterialID,
-		bIsValidPolygroupID,
-		false,
-		nullptr
-	);
+	MeshFunctions::SetPolygroupMaterialID(Mesh, PolygroupIDs[Index], MaterialID);
 
 	return true;
 }
 
-bool ABuilding::AppendFloors(UDynamicMesh* TargetMesh)
+bool ABuilding::AppendFloors(FDynamicMesh3 &TargetMesh)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE_STR("AppendFloors");
 
 	/* Create one floor tile in FloorMesh */
 
-	TObjectPtr<UDynamicMesh> FloorMesh = nullptr;
-	
-	if (!Concurrency::RunOnGameThreadAndWait([this, &FloorMesh]() {
-		FloorMesh = NewObject<UDynamicMesh>(this);
-		return IsValid(FloorMesh);
-	}))
-	{
-		LCReporter::ShowError(
-			LOCTEXT("NewObjectError", "Internal Error: Could not create new object")
-		);
-		return false;
-	}
+	FDynamicMesh3 FloorMesh;
 
-	UGeometryScriptLibrary_MeshPrimitiveFunctions::AppendSimpleExtrudePolygon(FloorMesh, FGeometryScriptPrimitiveOptions(), FTransform(), BaseVertices2D, 1);
+	MeshFunctions::AppendSimpleExtrudePolygon(FloorMesh, FTransform(), BaseVertices2D, 1);
 
 	{
 		TRACE_CPUPROFILER_EVENT_SCOPE_STR("AppendBuilding/AutoGenerateXAtlasMeshUVsFloors");
 
 		if (BCfg->bAutoGenerateXAtlasMeshUVsFloors)
 		{
-			UGeometryScriptLibrary_MeshUVFunctions::AutoGenerateXAtlasMeshUVs(FloorMesh, 0, FGeometryScriptXAtlasOptions());
+			MeshFunctions::AutoGenerateXAtlasUVs(FloorMesh);
 		}
 	}
 
 	/* Set the Polygroup ID of ceiling to CeilingMaterialID in FloorMesh */
 
-	FGeometryScriptIndexList PolygroupIDs0;
-	UGeometryScriptLibrary_MeshPolygroupFunctions::GetPolygroupIDsInMesh(FloorMesh, FGeometryScriptGroupLayer(), PolygroupIDs0);
-	TArray<int> PolygroupIDs = *PolygroupIDs0.List;
+	TArray<int> PolygroupIDs = MeshFunctions::GetPolygroupIDs(FloorMesh);
 
 	if (PolygroupIDs.Num() < 3)
 	{
@@ -525,7 +399,7 @@ bool ABuilding::AppendFloors(UDynamicMesh* TargetMesh)
 
 	/* Add several copies of the FloorMesh at every floor */
 
-	double CurrentHeight = MinHeightLocal + BCfg->ExtraWallBottom;
+	double CurrentHeight = MinHeightLocal + ExtraWallBottom;
 	for (auto &LevelDescriptionKey: ExpandedLevelDescriptionsKeys)
 	{
 		if (!BCfg->CheckValidKey(LevelDescriptionKey)) return false;
@@ -534,53 +408,34 @@ bool ABuilding::AppendFloors(UDynamicMesh* TargetMesh)
 
 		if (BCfg->bBuildFloorTiles)
 		{
-			
-			bool bIsValidPolygroupID;
-			UGeometryScriptLibrary_MeshMaterialFunctions::SetPolygroupMaterialID(
+			MeshFunctions::SetPolygroupMaterialID(
 				FloorMesh,
-				FGeometryScriptGroupLayer(),
 				PolygroupIDs[2], // polygroup ID of the ceiling, is there a way to ensure it?
-				BCfg->ResolveMaterial(LevelDescription->UnderFloorMaterialExpr),
-				bIsValidPolygroupID,
-				false,
-				nullptr
+				ResolveMaterial(LevelDescription->UnderFloorMaterialExpr)
 			);
-			UGeometryScriptLibrary_MeshMaterialFunctions::SetPolygroupMaterialID(
+			MeshFunctions::SetPolygroupMaterialID(
 				FloorMesh,
-				FGeometryScriptGroupLayer(),
 				PolygroupIDs[3], // polygroup ID of the floor, is there a way to ensure it?
-				BCfg->ResolveMaterial(LevelDescription->FloorMaterialExpr),
-				bIsValidPolygroupID,
-				false,
-				nullptr
+				ResolveMaterial(LevelDescription->FloorMaterialExpr)
 			);
-			UGeometryScriptLibrary_MeshMaterialFunctions::SetPolygroupMaterialID(
+			MeshFunctions::SetPolygroupMaterialID(
 				FloorMesh,
-				FGeometryScriptGroupLayer(),
 				PolygroupIDs[0], // maybe the sides of the floor
-				BCfg->ResolveMaterial(LevelDescription->FloorMaterialExpr),
-				bIsValidPolygroupID,
-				false,
-				nullptr
+				ResolveMaterial(LevelDescription->FloorMaterialExpr)
 			);
-			UGeometryScriptLibrary_MeshMaterialFunctions::SetPolygroupMaterialID(
+			MeshFunctions::SetPolygroupMaterialID(
 				FloorMesh,
-				FGeometryScriptGroupLayer(),
 				PolygroupIDs[1], // maybe the sides of the floor
-				BCfg->ResolveMaterial(LevelDescription->FloorMaterialExpr),
-				bIsValidPolygroupID,
-				false,
-				nullptr
+				ResolveMaterial(LevelDescription->FloorMaterialExpr)
 			);
 
-			UGeometryScriptLibrary_MeshBasicEditFunctions::AppendMesh(
+			MeshFunctions::AppendMesh(
 				TargetMesh, FloorMesh,
 				FTransform(
 					FRotator::ZeroRotator,
 					FVector(0, 0, CurrentHeight),
 					FVector(1, 1, LevelDescription->FloorThickness)
-				),
-				true
+				)
 			);
 		}
 
@@ -592,88 +447,65 @@ bool ABuilding::AppendFloors(UDynamicMesh* TargetMesh)
 	/* Add the last floor with roof material for flat roof kind */
 	if (BCfg->RoofKind == ERoofKind::Flat)
 	{
-		UGeometryScriptLibrary_MeshMaterialFunctions::RemapMaterialIDs(FloorMesh, 0, BCfg->ResolveMaterial(BCfg->RoofMaterialExpr));
-		if (!SetPolygroupMaterialID(FloorMesh, 2, BCfg->ResolveMaterial(BCfg->UnderRoofMaterialExpr))) return false;
+		MeshFunctions::RemapMaterialIDs(FloorMesh, 0, ResolveMaterial(BCfg->RoofMaterialExpr));
+		if (!SetPolygroupMaterialID(FloorMesh, 2, ResolveMaterial(BCfg->UnderRoofMaterialExpr))) return false;
 	
-		UGeometryScriptLibrary_MeshBasicEditFunctions::AppendMesh(
+		MeshFunctions::AppendMesh(
 			TargetMesh, FloorMesh,
 			FTransform(
 				FRotator::ZeroRotator,
 				FVector(0, 0, CurrentHeight),
 				FVector(1, 1, 20)
-			),
-			true
+			)
 		);
 	}
 
-	FloorMesh->MarkAsGarbage();
-
 	return true;
 }
 
-bool ABuilding::AppendBuildingWithoutInside(UDynamicMesh* TargetMesh)
+bool ABuilding::AppendBuildingWithoutInside(FDynamicMesh3 &TargetMesh)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE_STR("AppendBuildingWithoutInside");
 
-	TObjectPtr<UDynamicMesh> SimpleBuildingMesh = NewObject<UDynamicMesh>(this);
+	FDynamicMesh3 SimpleBuildingMesh;
 
-	UGeometryScriptLibrary_MeshPrimitiveFunctions::AppendSimpleExtrudePolygon(
+	MeshFunctions::AppendSimpleExtrudePolygon(
 		SimpleBuildingMesh,
-		FGeometryScriptPrimitiveOptions(),
 		FTransform(FVector(0, 0, 0)),
 		BaseVertices2D,
-		BCfg->ExtraWallBottom + LevelsHeightsSum + BCfg->ExtraWallTop
+		ExtraWallBottom + LevelsHeightsSum + BCfg->ExtraWallTop
 	);
 
 
 	/* Set the Polygroup ID of roof in SimpleBuildingMesh */
 
-	FGeometryScriptIndexList PolygroupIDs0;
-	UGeometryScriptLibrary_MeshPolygroupFunctions::GetPolygroupIDsInMesh(
-		SimpleBuildingMesh,
-		FGeometryScriptGroupLayer(),
-		PolygroupIDs0
-	);
-
-	TArray<int> PolygroupIDs = *PolygroupIDs0.List;
+	TArray<int> PolygroupIDs = MeshFunctions::GetPolygroupIDs(SimpleBuildingMesh);
 
 	if (PolygroupIDs.Num() < 4)
 	{
 		UE_LOG(LogBuildingsFromSplines, Error, TEXT("Internal error: something went wrong with the simple building materials"));
-		SimpleBuildingMesh->MarkAsGarbage();
 		return false;
 	}
 
-	bool bIsValidPolygroupID;
-	UGeometryScriptLibrary_MeshMaterialFunctions::SetPolygroupMaterialID(
+	MeshFunctions::SetPolygroupMaterialID(
 		SimpleBuildingMesh,
-		FGeometryScriptGroupLayer(),
 		PolygroupIDs[0], // TODO: polygroup ID of the sides of the polygon, is there a way to ensure it?
-		BCfg->ResolveMaterial(BCfg->ExteriorMaterialExpr),
-		bIsValidPolygroupID,
-		false,
-		nullptr
+		ResolveMaterial(BCfg->ExteriorMaterialExpr)
 	);
 
 	if (BCfg->RoofKind == ERoofKind::None || BCfg->RoofKind == ERoofKind::Flat)
 	{
-		UGeometryScriptLibrary_MeshMaterialFunctions::SetPolygroupMaterialID(
+		MeshFunctions::SetPolygroupMaterialID(
 			SimpleBuildingMesh,
-			FGeometryScriptGroupLayer(),
 			PolygroupIDs[3], // TODO: polygroup ID of the top of the polygon, is there a way to ensure it?
-			BCfg->ResolveMaterial(BCfg->RoofMaterialExpr),
-			bIsValidPolygroupID,
-			false,
-			nullptr
+			ResolveMaterial(BCfg->RoofMaterialExpr)
 		);
 	}
 
-	UGeometryScriptLibrary_MeshBasicEditFunctions::AppendMesh(
+	MeshFunctions::AppendMesh(
 		TargetMesh, SimpleBuildingMesh,
-		FTransform(FVector(0, 0, MinHeightLocal)),
-		true
+		FTransform(FVector(0, 0, MinHeightLocal))
 	);
-	SimpleBuildingMesh->MarkAsGarbage();
 	
 	return true;
 }
@@ -684,33 +516,30 @@ TArray<FVector2D> ABuilding::MakePolygon(bool bInternalWall, double BeginDistanc
 
 	TArray<FVector2D> Result;
 
-	FTransform FirstTransform = BaseClockwiseSplineComponent->GetTransformAtDistanceAlongSpline(BeginDistance, ESplineCoordinateSpace::Local);
-	FTransform LastTransform = BaseClockwiseSplineComponent->GetTransformAtDistanceAlongSpline(BeginDistance + Length, ESplineCoordinateSpace::Local);
+	const double FirstDistance = BeginDistance;
+	const double LastDistance = BeginDistance + Length;
 
-	FVector2D FirstLocation = To2D(FirstTransform.GetLocation());
-	FVector2D LastLocation = To2D(LastTransform.GetLocation());
+	FVector2D FirstLocation = GetBaseLocationAtDistance(FirstDistance);
+	FVector2D LastLocation = GetBaseLocationAtDistance(LastDistance);
 
-	double FirstTime = BaseClockwiseSplineComponent->GetTimeAtDistanceAlongSpline(BeginDistance);
-	double LastTime = BaseClockwiseSplineComponent->GetTimeAtDistanceAlongSpline(BeginDistance + Length);
+	/* Add to Result all the base vertices whose distance is between FirstDistance and LastDistance */
 
-	/* Add to Result all the frames whose frame time is between FirstTime and LastTime */
-
-	int NumFrames = BaseClockwiseFrames.Num();
+	int NumFrames = BaseVertices2D.Num();
 
 	bool bStartOnSplinePoint = false;
 	bool bEndOnSplinePoint = false;
 	for (int i = 0; i < NumFrames; i++)
 	{
-		if ((To2D(BaseClockwiseFrames[i].GetLocation()) - FirstLocation).IsNearlyZero(MILLIMETER)) bStartOnSplinePoint = true;
-		if ((To2D(BaseClockwiseFrames[i].GetLocation()) - LastLocation).IsNearlyZero(MILLIMETER)) bEndOnSplinePoint = true;
+		if ((BaseVertices2D[i] - FirstLocation).IsNearlyZero(MILLIMETER)) bStartOnSplinePoint = true;
+		if ((BaseVertices2D[i] - LastLocation).IsNearlyZero(MILLIMETER)) bEndOnSplinePoint = true;
 	}
 	
 	// We add a millimeter tolerance, otherwise we might skip a point and increment 'i' beyond the actual beginning
-	double SplineLength = BaseClockwiseSplineComponent->GetSplineLength();
+	double SplineLength = GetBaseLength();
 	int i = 0;
-	while (i < NumFrames && BaseClockwiseFramesTimes[i] + MILLIMETER / SplineLength < FirstTime) i++;
+	while (i < NumFrames && BaseClockwiseDistances[i] + MILLIMETER < FirstDistance) i++;
 
-	// from here, all frames with an index higher or equal than `i` have frame times larger or equal to `FirstTime`
+	// from here, all vertices with an index higher or equal than `i` have distances larger or equal to `FirstDistance`
 
 	// we only add a frame if its location is different from the previous one
 	auto Add = [this, &Result](FVector2D Location)
@@ -726,24 +555,24 @@ TArray<FVector2D> ABuilding::MakePolygon(bool bInternalWall, double BeginDistanc
 
 	bool bAddedPoints = false;
 
-	while (i < NumFrames && BaseClockwiseFramesTimes[i] <= LastTime)
+	while (i < NumFrames && BaseClockwiseDistances[i] <= LastDistance)
 	{
-		Add(To2D(BaseClockwiseFrames[i].GetLocation()));
+		Add(BaseVertices2D[i]);
 		i++;
 		bAddedPoints = true;
 	}
 	int LastIndex = i - 1;
 
-	if (FMath::IsNearlyEqual(LastTime, 1, MILLIMETER / SplineLength))
+	if (FMath::IsNearlyEqual(LastDistance, SplineLength, MILLIMETER))
 	{
-		if (SplineComponent->IsClosedLoop())
+		if (bSplineIsClosedLoop)
 		{
-			Add(To2D(BaseClockwiseFrames[0].GetLocation()));
+			Add(BaseVertices2D[0]);
 			LastIndex = NumFrames;
 		}
 		else
 		{
-			Add(To2D(BaseClockwiseFrames[NumFrames - 1].GetLocation()));
+			Add(BaseVertices2D[NumFrames - 1]);
 			LastIndex = NumFrames - 1;
 		}
 	}
@@ -842,7 +671,7 @@ void ABuilding::AddSplineMesh(UStaticMesh* StaticMesh, double BeginDistance, dou
 	SplineMeshComponent->MarkRenderStateDirty();
 }
 
-bool ABuilding::AppendWallsWithHoles(UDynamicMesh* TargetMesh, bool bInternalWall, double ZOffset, int FloorIndex, ULevelDescription *LevelDescription)
+bool ABuilding::AppendWallsWithHoles(FDynamicMesh3 &TargetMesh, bool bInternalWall, double ZOffset, int FloorIndex, ULevelDescription *LevelDescription)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE_STR("AppendWallsWithHoles");
 
@@ -861,17 +690,17 @@ bool ABuilding::AppendWallsWithHoles(UDynamicMesh* TargetMesh, bool bInternalWal
 	}
 
 	// original number of spline points (without subdivisions)
-	const int NumSplinePoints = SplineComponent->GetNumberOfSplinePoints();
+	const int NumSplinePoints = SplineNumPoints;
 	int NumIterations = 1; // when !bResetWallSegmentsOnCorners
 	if (LevelDescription->bResetWallSegmentsOnCorners)
 	{
-		if (SplineComponent->IsClosedLoop()) NumIterations = NumSplinePoints;
+		if (bSplineIsClosedLoop) NumIterations = NumSplinePoints;
 		else NumIterations = NumSplinePoints - 1;
 	}
 
 	for (int i = 0; i < NumIterations; i++)
 	{
-		double CurrentDistance = BaseClockwiseSplineComponent->GetDistanceAlongSplineAtSplinePoint(SplineIndexToBaseSplineIndex[i]);
+		double CurrentDistance = BaseClockwiseDistances[SplineIndexToBaseSplineIndex[i]];
 		for (auto WallSegment : WallSegmentsAtFloorAndSplinePoint[FloorIndex][i])
 		{
 			if (!WallSegment) continue;
@@ -897,7 +726,7 @@ bool ABuilding::AppendWallsWithHoles(UDynamicMesh* TargetMesh, bool bInternalWal
 				AppendAlongSpline(
 					TargetMesh, bInternalWall, CurrentDistance, FinalSegmentLength,
 					LevelDescription->LevelHeight - OffsetIfInternal, ZOffset + OffsetIfInternal, Thickness,
-					BCfg->ResolveMaterial(bInternalWall ? WallSegment->InteriorWallMaterialExpr : WallSegment->ExteriorWallMaterialExpr)
+					ResolveMaterial(bInternalWall ? WallSegment->InteriorWallMaterialExpr : WallSegment->ExteriorWallMaterialExpr)
 				);
 				CurrentDistance += FinalSegmentLength;
 				break;
@@ -911,7 +740,7 @@ bool ABuilding::AppendWallsWithHoles(UDynamicMesh* TargetMesh, bool bInternalWal
 					AppendAlongSpline(
 						TargetMesh, bInternalWall, CurrentDistance, FinalSegmentLength,
 						BelowHoleHeight, ZOffset + OffsetIfInternal, Thickness,
-						BCfg->ResolveMaterial(bInternalWall ? WallSegment->UnderHoleInteriorMaterialExpr : WallSegment->UnderHoleExteriorMaterialExpr)
+						ResolveMaterial(bInternalWall ? WallSegment->UnderHoleInteriorMaterialExpr : WallSegment->UnderHoleExteriorMaterialExpr)
 					);
 				}
 
@@ -922,7 +751,7 @@ bool ABuilding::AppendWallsWithHoles(UDynamicMesh* TargetMesh, bool bInternalWal
 					AppendAlongSpline(
 						TargetMesh, bInternalWall, CurrentDistance, FinalSegmentLength,
 						RemainingHeight, ZOffset + OffsetIfInternal + BelowHoleHeight + WallSegment->HoleHeight, Thickness,
-						BCfg->ResolveMaterial(bInternalWall ? WallSegment->OverHoleInteriorMaterialExpr : WallSegment->OverHoleExteriorMaterialExpr)
+						ResolveMaterial(bInternalWall ? WallSegment->OverHoleInteriorMaterialExpr : WallSegment->OverHoleExteriorMaterialExpr)
 					);
 				}
 
@@ -936,31 +765,31 @@ bool ABuilding::AppendWallsWithHoles(UDynamicMesh* TargetMesh, bool bInternalWal
 	return true;
 }
 
-bool ABuilding::AppendWallsWithHoles(UDynamicMesh* TargetMesh)
+bool ABuilding::AppendWallsWithHoles(FDynamicMesh3 &TargetMesh)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE_STR("AppendWallsWithHoles3");
 
 	// ExtraWallBottom (inside wall)
 
-	if (BCfg->InternalWallThickness > 0 && BCfg->ExtraWallBottom > 0)
+	if (BCfg->InternalWallThickness > 0 && ExtraWallBottom > 0)
 	{
 		AppendAlongSpline(
-			TargetMesh, true, 0, BaseClockwiseSplineComponent->GetSplineLength(),
-			BCfg->ExtraWallBottom, MinHeightLocal,
+			TargetMesh, true, 0, GetBaseLength(),
+			ExtraWallBottom, MinHeightLocal,
 			BCfg->InternalWallThickness,
-			BCfg->ResolveMaterial(BCfg->InteriorMaterialExpr)
+			ResolveMaterial(BCfg->InteriorMaterialExpr)
 		);
 	}
 
 	// ExtraWallBottom (outside wall)
 
-	if (BCfg->ExternalWallThickness > 0 && BCfg->ExtraWallBottom > 0)
+	if (BCfg->ExternalWallThickness > 0 && ExtraWallBottom > 0)
 	{
 		AppendAlongSpline(
-			TargetMesh, false, 0, BaseClockwiseSplineComponent->GetSplineLength(),
-			BCfg->ExtraWallBottom, MinHeightLocal,
+			TargetMesh, false, 0, GetBaseLength(),
+			ExtraWallBottom, MinHeightLocal,
 			BCfg->ExternalWallThickness,
-			BCfg->ResolveMaterial(BCfg->ExteriorMaterialExpr)
+			ResolveMaterial(BCfg->ExteriorMaterialExpr)
 		);
 	}
 
@@ -969,11 +798,11 @@ bool ABuilding::AppendWallsWithHoles(UDynamicMesh* TargetMesh)
 	if (BCfg->InternalWallThickness > 0 && BCfg->ExtraWallTop > 0)
 	{
 		AppendAlongSpline(
-			TargetMesh, true, 0, BaseClockwiseSplineComponent->GetSplineLength(),
+			TargetMesh, true, 0, GetBaseLength(),
 			BCfg->ExtraWallTop,
-			MinHeightLocal + BCfg->ExtraWallBottom + LevelsHeightsSum,
+			MinHeightLocal + ExtraWallBottom + LevelsHeightsSum,
 			BCfg->InternalWallThickness,
-			BCfg->ResolveMaterial(BCfg->InteriorMaterialExpr)
+			ResolveMaterial(BCfg->InteriorMaterialExpr)
 		);
 	}
 
@@ -982,39 +811,35 @@ bool ABuilding::AppendWallsWithHoles(UDynamicMesh* TargetMesh)
 	if (BCfg->ExternalWallThickness > 0 && BCfg->ExtraWallTop > 0)
 	{
 		AppendAlongSpline(
-			TargetMesh, false, 0, BaseClockwiseSplineComponent->GetSplineLength(),
+			TargetMesh, false, 0, GetBaseLength(),
 			BCfg->ExtraWallTop,
-			MinHeightLocal + BCfg->ExtraWallBottom + LevelsHeightsSum,
+			MinHeightLocal + ExtraWallBottom + LevelsHeightsSum,
 			BCfg->ExternalWallThickness,
-			BCfg->ResolveMaterial(BCfg->ExteriorMaterialExpr)
+			ResolveMaterial(BCfg->ExteriorMaterialExpr)
 		);
 	}
 
-	TMap<ULevelDescription*, UDynamicMesh*> LevelMeshes;
+	TMap<ULevelDescription*, FDynamicMesh3> LevelMeshes;
 
-	auto AddMesh = [this, TargetMesh, &LevelMeshes](int FloorIndex, ULevelDescription *LevelDescription, double CurrentHeight) -> bool
+	auto AddMesh = [this, &TargetMesh, &LevelMeshes](int FloorIndex, ULevelDescription *LevelDescription, double CurrentHeight) -> bool
 	{
 		if (!BCfg->bCacheLevelsWithinBuilding || !LevelMeshes.Contains(LevelDescription))
 		{
-			if (LevelMeshes.Contains(LevelDescription) && IsValid(LevelMeshes[LevelDescription])) LevelMeshes[LevelDescription]->MarkAsGarbage();
-
-			UDynamicMesh *DynamicMesh = NewObject<UDynamicMesh>(this);
-			LevelMeshes.Add(LevelDescription, DynamicMesh);
+			FDynamicMesh3 &LevelMesh = LevelMeshes.Add(LevelDescription, FDynamicMesh3());
 
-			if (!AppendWallsWithHoles(DynamicMesh, true, 0, FloorIndex, LevelDescription)) return false;
-			if (!AppendWallsWithHoles(DynamicMesh, false, 0, FloorIndex, LevelDescription)) return false;
+			if (!AppendWallsWithHoles(LevelMesh, true, 0, FloorIndex, LevelDescription)) return false;
+			if (!AppendWallsWithHoles(LevelMesh, false, 0, FloorIndex, LevelDescription)) return false;
 		}
 
-		UGeometryScriptLibrary_MeshBasicEditFunctions::AppendMesh(
+		MeshFunctions::AppendMesh(
 			TargetMesh, LevelMeshes[LevelDescription],
-			FTransform(FVector(0, 0, CurrentHeight)),
-			true
+			FTransform(FVector(0, 0, CurrentHeight))
 		);
 
 		return true;
 	};
 	
-	double CurrentHeigth = MinHeightLocal + BCfg->ExtraWallBottom;
+	double CurrentHeigth = MinHeightLocal + ExtraWallBottom;
 	int NumFloors = ExpandedLevelDescriptionsKeys.Num();
 	for (int FloorIndex = 0; FloorIndex < NumFloors; FloorIndex++)
 	{
@@ -1026,24 +851,19 @@ bool ABuilding::AppendWallsWithHoles(UDynamicMesh* TargetMesh)
 		CurrentHeigth += BCfg->LevelsMap[LevelDescriptionKey]->LevelHeight;
 	}
 
-	for (auto& [_, LevelMesh] : LevelMeshes)
-		if (IsValid(LevelMesh)) LevelMesh->MarkAsGarbage();
-
 	return true;
 }
 
-void ABuilding::AppendRoof(UDynamicMesh* TargetMesh)
+void ABuilding::AppendRoof(FDynamicMesh3 &TargetMesh)
 {
-	/* Allocate RoofMesh */
-
-	TObjectPtr<UDynamicMesh> RoofMesh = NewObject<UDynamicMesh>(this);
+	FDynamicMesh3 RoofMesh;
 	
 	/* Top of the roof */
 	
-	int NumFrames = BaseClockwiseFrames.Num();
+	int NumFrames = BaseVertices2D.Num();
 	if (NumFrames == 0) return;
 	
-	const double WallTopHeight = MinHeightLocal + BCfg->ExtraWallBottom + LevelsHeightsSum + BCfg->ExtraWallTop;
+	const double WallTopHeight = MinHeightLocal + ExtraWallBottom + LevelsHeightsSum + BCfg->ExtraWallTop;
 	const double RoofTopHeight = WallTopHeight + BCfg->RoofHeight;
 
 
@@ -1056,10 +876,7 @@ void ABuilding::AppendRoof(UDynamicMesh* TargetMesh)
 		double TanAngle = FMath::Tan(FMath::DegreesToRadians(BCfg->RoofAngle));
 
 		TArray<FVector2D> OuterRoofVertices;
-		for (int i = 0; i < BaseVertices2D.Num(); i++)
-		{
-			OuterRoofVertices.Add(GetShiftedPoint(BaseClockwiseFrames, i, - BCfg->OuterRoofDistance, true));
-		}
+		PolygonOffset::Shift(BaseVertices2D, - BCfg->OuterRoofDistance, OuterRoofVertices);
 
 		FStraightSkeleton StraightSkeleton;
 
@@ -1099,7 +916,7 @@ void ABuilding::AppendRoof(UDynamicMesh* TargetMesh)
 
 			for (int EdgeIndex = 0; EdgeIndex < StraightSkeleton.Edges.Num(); EdgeIndex++)
 			{
-				TObjectPtr<UDynamicMesh> RoofFace = NewObject<UDynamicMesh>(this);
+				FDynamicMesh3 RoofFace;
 				const FSkeletonEdgeResult &EdgeResult = StraightSkeleton.Edges[EdgeIndex];
 
 				FVector2D EdgeDir = (EdgeResult.End - EdgeResult.Begin).GetSafeNormal();
@@ -1122,24 +939,21 @@ void ABuilding::AppendRoof(UDynamicMesh* TargetMesh)
 						To3D(BaseVertices2D[(EdgeIndex+1) % StraightSkeleton.Edges.Num()]) +
 						FVector(0, 0, WallTopHeight);
 
-					UGeometryScriptLibrary_MeshPrimitiveFunctions::AppendSimpleExtrudePolygon(
+					MeshFunctions::AppendSimpleExtrudePolygon(
 						RoofFace,
-						FGeometryScriptPrimitiveOptions(),
 						// move the roof down a bit so that it touches the top of the wall
 						FTransform(EdgeAngleYaw + FRotator(0,0,-90), GablePosition),
 						{ FVector2D(0, 0), FVector2D(OriginalEdgeLength, 0), FVector2D(OriginalEdgeLength / 2, TopVertexHeight) },
 						BCfg->RoofThickness
 					);
-					UGeometryScriptLibrary_MeshMaterialFunctions::RemapMaterialIDs(RoofFace, 0, BCfg->ResolveMaterial(BCfg->GableMaterialExpr));
-					UGeometryScriptLibrary_MeshBasicEditFunctions::AppendMesh(TargetMesh, RoofFace, FTransform(), true);
-					RoofFace->MarkAsGarbage();
+					MeshFunctions::RemapMaterialIDs(RoofFace, 0, ResolveMaterial(BCfg->GableMaterialExpr));
+					MeshFunctions::AppendMesh(TargetMesh, RoofFace, FTransform());
 				}
 				// build roof faces
 				else
 				{
-					UGeometryScriptLibrary_MeshPrimitiveFunctions::AppendSimpleExtrudePolygon(
+					MeshFunctions::AppendSimpleExtrudePolygon(
 						RoofFace,
-						FGeometryScriptPrimitiveOptions(),
 						// move the roof down a bit so that it touches the top of the wall
 						FTransform(FVector(0, 0, WallTopHeight - (BCfg->OuterRoofDistance - LastFloorExternalWallThickness) * TanAngle)),
 						// FTransform(FVector(0, 0, WallTopHeight)),
@@ -1147,9 +961,9 @@ void ABuilding::AppendRoof(UDynamicMesh* TargetMesh)
 						BCfg->RoofThickness
 					);
 
-					for (int32 VID : RoofFace->GetMeshRef().VertexIndicesItr())
+					for (int32 VID : RoofFace.VertexIndicesItr())
 					{
-						FVector V = RoofFace->GetMeshRef().GetVertex(VID);
+						FVector V = RoofFace.GetVertex(VID);
 						FVector2D V2 = FVector2D(V.X, V.Y);
 						V.Z += StraightSkeleton.Distances.FindRef(V2) * TanAngle;
 						
@@ -1161,18 +975,16 @@ void ABuilding::AppendRoof(UDynamicMesh* TargetMesh)
 							V.X = MidPoint.X;
 							V.Y = MidPoint.Y;
 						}
-						RoofFace->GetMeshRef().SetVertex(VID, V);
+						RoofFace.SetVertex(VID, V);
 					}
-					UGeometryScriptLibrary_MeshUVFunctions::SetMeshUVsFromBoxProjection(RoofFace, 0, BoxTransform, FGeometryScriptMeshSelection());
-					UGeometryScriptLibrary_MeshUVFunctions::ScaleMeshUVs(RoofFace, 0, FVector2D(MaxCoordinate / 100, MaxCoordinate / 100), FVector2D(), FGeometryScriptMeshSelection());
+					MeshFunctions::SetUVsFromBoxProjection(RoofFace, BoxTransform);
+					MeshFunctions::ScaleUVs(RoofFace, FVector2D(MaxCoordinate / 100, MaxCoordinate / 100));
 
-					UGeometryScriptLibrary_MeshBasicEditFunctions::AppendMesh(RoofMesh, RoofFace, FTransform(), true);
-					RoofFace->MarkAsGarbage();
+					MeshFunctions::AppendMesh(RoofMesh, RoofFace, FTransform());
 				}
 			}
-			UGeometryScriptLibrary_MeshMaterialFunctions::RemapMaterialIDs(RoofMesh, 0, BCfg->ResolveMaterial(BCfg->RoofMaterialExpr));
-			UGeometryScriptLibrary_MeshBasicEditFunctions::AppendMesh(TargetMesh, RoofMesh, FTransform(), true);
-			RoofMesh->MarkAsGarbage();
+			MeshFunctions::RemapMaterialIDs(RoofMesh, 0, ResolveMaterial(BCfg->RoofMaterialExpr));
+			MeshFunctions::AppendMesh(TargetMesh, RoofMesh, FTransform());
 
 			return;
 		}
@@ -1181,15 +993,12 @@ void ABuilding::AppendRoof(UDynamicMesh* TargetMesh)
 	}
 
 	// we continue here if we failed for gable or hip roof, or if we're using inner spline or point options
-	TArray<FTransform> Frames;
-	Frames.Append(BaseClockwiseFrames);
-
 	TArray<FVector2D> RoofPolygon;
 	TArray<int> IndexToRoofIndex;
 
 	if (BCfg->RoofKind == ERoofKind::InnerSpline)
 	{
-		DeflateFrames(Frames, RoofPolygon, IndexToRoofIndex, BCfg->InnerRoofDistance);
+		PolygonOffset::Deflate(BaseVertices2D, BaseVertices2D, BCfg->InnerRoofDistance, RoofPolygon, IndexToRoofIndex);
 	}
 	else
 	{
@@ -1216,16 +1025,15 @@ void ABuilding::AppendRoof(UDynamicMesh* TargetMesh)
 	}
 	else
 	{
-		UGeometryScriptLibrary_MeshPrimitiveFunctions::AppendSimpleExtrudePolygon(
+		MeshFunctions::AppendSimpleExtrudePolygon(
 			RoofMesh,
-			FGeometryScriptPrimitiveOptions(),
 			FTransform(FVector(0, 0, RoofTopHeight)),
 			RoofPolygon,
 			BCfg->RoofThickness
 		);
 
-		UGeometryScriptLibrary_MeshMaterialFunctions::RemapMaterialIDs(RoofMesh, 0, BCfg->ResolveMaterial(BCfg->RoofMaterialExpr));
-		if (!SetPolygroupMaterialID(RoofMesh, 2, BCfg->ResolveMaterial(BCfg->UnderRoofMaterialExpr))) return;
+		MeshFunctions::RemapMaterialIDs(RoofMesh, 0, ResolveMaterial(BCfg->RoofMaterialExpr));
+		if (!SetPolygroupMaterialID(RoofMesh, 2, ResolveMaterial(BCfg->UnderRoofMaterialExpr))) return;
 	}
 
 
@@ -1263,15 +1071,13 @@ void ABuilding::AppendRoof(UDynamicMesh* TargetMesh)
 		SweepPath.Add(NewTransform);
 	}
 
-	FGeometryScriptPrimitiveOptions Options;
-	Options.bFlipOrientation = true;
-	UGeometryScriptLibrary_MeshPrimitiveFunctions::AppendSweepPolyline(
-		RoofMesh, Options,
-		FTransform(), { {0, 0}, {0, 0.01}, {0, 0.02}, {0, 0.05}, {0, 0.1}, {0, 0.2}, {0, 0.4}, {0, 0.6}, {0, 0.8},  {0, 0.9},  {0, 0.95},  {0, 0.98},  {0, 0.99}, {0, 1} },
-		SweepPath, {}, {}, true
+	MeshFunctions::AppendSweepPolyline(
+		RoofMesh,
+		{ {0, 0}, {0, 0.01}, {0, 0.02}, {0, 0.05}, {0, 0.1}, {0, 0.2}, {0, 0.4}, {0, 0.6}, {0, 0.8},  {0, 0.9},  {0, 0.95},  {0, 0.98},  {0, 0.99}, {0, 1} },
+		SweepPath, true, /* bFlipOrientation */ true
 	);
 
-	UGeometryScriptLibrary_MeshMaterialFunctions::RemapMaterialIDs(RoofMesh, 0, BCfg->ResolveMaterial(BCfg->RoofMaterialExpr));
+	MeshFunctions::RemapMaterialIDs(RoofMesh, 0, ResolveMaterial(BCfg->RoofMaterialExpr));
 
 	/* Connection from the walls to the roof, inside */
 
@@ -1300,21 +1106,18 @@ void ABuilding::AppendRoof(UDynamicMesh* TargetMesh)
 			SweepPath.Add(NewTransform);
 		}
 
-		Options.bFlipOrientation = false;
-		UGeometryScriptLibrary_MeshPrimitiveFunctions::AppendSweepPolyline(
-			RoofMesh, Options,
-			FTransform(), { {0, 0}, {0, 0.01}, {0, 0.02}, {0, 0.05}, {0, 0.1}, {0, 0.2}, {0, 0.4}, {0, 0.6}, {0, 0.8},  {0, 0.9},  {0, 0.95},  {0, 0.98},  {0, 0.99}, {0, 1} },
-			SweepPath, {}, {}, true
+		MeshFunctions::AppendSweepPolyline(
+			RoofMesh,
+			{ {0, 0}, {0, 0.01}, {0, 0.02}, {0, 0.05}, {0, 0.1}, {0, 0.2}, {0, 0.4}, {0, 0.6}, {0, 0.8},  {0, 0.9},  {0, 0.95},  {0, 0.98},  {0, 0.99}, {0, 1} },
+			SweepPath, true, /* bFlipOrientation */ false
 		);
-		UGeometryScriptLibrary_MeshMaterialFunctions::RemapMaterialIDs(RoofMesh, 0, BCfg->ResolveMaterial(BCfg->InteriorMaterialExpr));
+		MeshFunctions::RemapMaterialIDs(RoofMesh, 0, ResolveMaterial(BCfg->InteriorMaterialExpr));
 	}
 	
 
 	/* Add the RoofMesh to our TargetMesh */
 
-	UGeometryScriptLibrary_MeshBasicEditFunctions::AppendMesh(TargetMesh, RoofMesh, FTransform(), true);
-
-	RoofMesh->MarkAsGarbage();
+	MeshFunctions::AppendMesh(TargetMesh, RoofMesh, FTransform());
 }
 
 void ABuilding::ComputeMinMaxHeight()
@@ -1356,7 +1159,7 @@ void ABuilding::SetReceivesDecals()
 bool ABuilding::InitializeWallSegments()
 {
 	// original number of spline points (without subdivisions)
-	const int NumSplinePoints = SplineComponent->GetNumberOfSplinePoints();
+	const int NumSplinePoints = SplineNumPoints;
 	if (NumSplinePoints == 0)
 	{
 		LCReporter::ShowError(LOCTEXT("EmptySpline", "Attempting to create a building with an empty spline"));
@@ -1390,7 +1193,7 @@ bool ABuilding::InitializeWallSegments()
 		int NumIterations = 1; // when !bResetWallSegmentsOnCorners
 		if (LevelDescription->bResetWallSegmentsOnCorners)
 		{
-			if (SplineComponent->IsClosedLoop()) NumIterations = NumSplinePoints;
+			if (bSplineIsClosedLoop) NumIterations = NumSplinePoints;
 			else NumIterations = NumSplinePoints - 1;
 		}
 		for (int SplinePointIndex = 0; SplinePointIndex < NumIterations; SplinePointIndex++)
@@ -1401,13 +1204,13 @@ bool ABuilding::InitializeWallSegments()
 			{
 				int BaseIndex = SplineIndexToBaseSplineIndex[SplinePointIndex];
 				int BaseIndexNext = SplineIndexToBaseSplineIndex[SplinePointIndex + 1];
-				double Distance1 = BaseClockwiseSplineComponent->GetDistanceAlongSplineAtSplinePoint(BaseIndex);
-				double Distance2 = BaseClockwiseSplineComponent->GetDistanceAlongSplineAtSplinePoint(BaseIndexNext);
+				double Distance1 = BaseClockwiseDistances[BaseIndex];
+				double Distance2 = BaseClockwiseDistances[BaseIndexNext];
 				Length = Distance2 - Distance1;
 			}
 			else
 			{
-				Length = BaseClockwiseSplineComponent->GetSplineLength();
+				Length = GetBaseLength();
 			}
 
 			
@@ -1498,11 +1301,37 @@ bool ABuilding::GenerateBuilding_Internal(FName SpawnedActorsPathOverride)
 		bIsGenerating = false;
 	};
 	
-	if (!Concurrency::RunOnGameThreadAndWait([this]() -> bool { return Execute_Cleanup(this, false); }))
+	if (!Concurrency::RunOnGameThreadAndWait([this]() -> bool { return PrepareGeneration(); }))
 	{
 		return false;
 	}
 
+	if (!GenerateGeometry()) return false;
+
+	return Concurrency::RunOnGameThreadAndWait([this, &SpawnedActorsPathOverride]() -> bool
+	{
+		if (!CommitGeneration(SpawnedActorsPathOverride)) return false;
+
+		if (BCfg->bAttemptToPushOutOfCollision)
+		{
+			TArray<FCollisionFootprint> Footprints = { GetCollisionFootprint() };
+			CollisionResolver().Resolve(GetWorld(), Footprints);
+		}
+
+#if WITH_EDITOR
+		if (GEditor) GEditor->NoteSelectionChange();
+#endif
+
+		return true;
+	});
+}
+
+bool ABuilding::PrepareGeneration()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("PrepareGeneration");
+
+	if (!Execute_Cleanup(this, false)) return false;
+
 	if (!IsValid(BCfg))
 	{
 		LCReporter::ShowError(
@@ -1513,24 +1342,25 @@ bool ABuilding::GenerateBuilding_Internal(FName SpawnedActorsPathOverride)
 	
 	LastFloorExternalWallThickness = 0;
 
-	BCfg->MaterialNamesArray.Empty();
-	BCfg->MaterialsArray.Empty();
+	MaterialNamesArray.Empty();
+	MaterialsArray.Empty();
 	for (auto &[Name, Material]: BCfg->Materials)
 	{
-		BCfg->MaterialNamesArray.Add(Name);
-		BCfg->MaterialsArray.Add(Material);
+		MaterialNamesArray.Add(Name);
+		MaterialsArray.Add(Material);
 	}
 
 	UOSMUserData *BuildingOSMUserData = Cast<UOSMUserData>(GetRootComponent()->GetAssetUserDataOfClass(UOSMUserData::StaticClass()));
-	bool bFetchFromUserData = BCfg->AutoComputeNumFloors(BuildingOSMUserData);
+	BuildingNumFloors = BCfg->NumFloors;
+	bool bFetchFromUserData = BCfg->AutoComputeNumFloors(BuildingOSMUserData, BuildingNumFloors);
 
 	if (!bFetchFromUserData && BCfg->bUseRandomNumFloors)
 	{
-		BCfg->NumFloors = UKismetMathLibrary::RandomIntegerInRange(BCfg->MinNumFloors, BCfg->MaxNumFloors);
+		BuildingNumFloors = UKismetMathLibrary::RandomIntegerInRange(BCfg->MinNumFloors, BCfg->MaxNumFloors);
 	}
 
 	if (!FExpression::Expand(
-		BCfg->NumFloors,
+		BuildingNumFloors,
 		BCfg->LevelsExpression,
 		[](FString LevelDescriptionKey) -> double { return 1; },
 		ExpandedLevelDescriptionsKeys
@@ -1554,8 +1384,33 @@ bool ABuilding::GenerateBuilding_Internal(FName SpawnedActorsPathOverride)
 		);
 		return false;
 	}
-	
-	if (!AppendBuilding(DynamicMeshComponent->GetDynamicMesh(), SpawnedActorsPathOverride)) return false;
+
+	ComputeMinMaxHeight();
+	ComputeBaseVertices();
+
+	return true;
+}
+
+bool ABuilding::GenerateGeometry()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("GenerateGeometry");
+
+	GeneratedMesh = FDynamicMesh3();
+	return AppendBuildingGeometry(GeneratedMesh);
+}
+
+bool ABuilding::CommitGeneration(FName SpawnedActorsPathOverride)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("CommitGeneration");
+
+	if (!IsValid(DynamicMeshComponent)) return false;
+
+	DynamicMeshComponent->GetDynamicMesh()->SetMesh(MoveTemp(GeneratedMesh));
+	GeneratedMesh = FDynamicMesh3();
+
+	UpdateBaseClockwiseSplineComponent();
+
+	if (!AddBuildingComponents(SpawnedActorsPathOverride)) return false;
 
 	SetReceivesDecals();
 
@@ -1571,12 +1426,36 @@ bool ABuilding::GenerateBuilding_Internal(FName SpawnedActorsPathOverride)
 		DynamicMeshComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 	}
 
-	if (BCfg->bAttemptToPushOutOfCollision)
+	return true;
+}
+
+FCollisionFootprint ABuilding::GetCollisionFootprint()
+{
+	FCollisionFootprint Footprint;
+	Footprint.Actor = this;
+	Footprint.bPushOutOfCollision = BCfg->bAttemptToPushOutOfCollision;
+	Footprint.bBlocksOthers = BCfg->bEnableComplexCollision;
+	Footprint.MaxSteps = BCfg->PushMaxSteps;
+	Footprint.StepSize = BCfg->PushStepSize;
+
+	// the external walls are the outer boundary of the building
+	const TArray<FVector2D> *ExternalPolygon = ExternalWallPolygons.Find(BCfg->ExternalWallThickness);
+	const TArray<FVector2D> &LocalPolygon = ExternalPolygon ? *ExternalPolygon : BaseVertices2D;
+
+	const FTransform Transform = GetActorTransform();
+	Footprint.Polygon.Reserve(LocalPolygon.Num());
+	for (const FVector2D &Vertex : LocalPolygon)
 	{
-		ULCBlueprintLibrary::PushOutOfCollision(this, BCfg->PushMaxSteps, BCfg->PushStepSize);
+		Footprint.Polygon.Add(To2D(Transform.TransformPosition(To3D(Vertex))));
 	}
 
-	return true;
+	FVector Origin;
+	FVector HalfExtent;
+	GetActorBounds(/* bOnlyCollidingComponents */ false, Origin, HalfExtent);
+	Footprint.MinZ = Origin.Z - HalfExtent.Z;
+	Footprint.MaxZ = Origin.Z + HalfExtent.Z;
+
+	return Footprint;
 }
 
 bool ABuilding::OnGenerate(FName SpawnedActorsPathOverride, bool bIsUserInitiated)
@@ -1611,7 +1490,10 @@ TArray<UObject *> ABuilding::GetGeneratedObjects() const
 	return Result;
 }
 
-bool ABuilding::AddAttachments(int FloorIndex, ULevelDescription* LevelDescription, double ZOffset)
+bool ABuilding::AddAttachments(
+	int FloorIndex, ULevelDescription* LevelDescription, double ZOffset,
+	const FRandomStream &RandomStream, TMap<UStaticMesh*, TArray<FTransform>> &OutInstances
+)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE_STR("AddAttachments");
 
@@ -1620,14 +1502,14 @@ bool ABuilding::AddAttachments(int FloorIndex, ULevelDescription* LevelDescripti
 	const int MaxIterations = LevelDescription->bResetWallSegmentsOnCorners ? NumSplinePoints : 1;
 	for (int i = 0; i < NumSplinePoints; i++)
 	{
-		double CurrentDistance = BaseClockwiseSplineComponent->GetDistanceAlongSplineAtSplinePoint(SplineIndexToBaseSplineIndex[i]);
+		double CurrentDistance = BaseClockwiseDistances[SplineIndexToBaseSplineIndex[i]];
 		for (auto &WallSegment : WallSegmentsAtFloorAndSplinePoint[FloorIndex][i])
 		{
 			double FinalSegmentLength = WallSegment->bAutoExpand ? FillersSizeAtFloorAndSplinePoint[FloorIndex][i] : WallSegment->SegmentLength;
 			
 			for (auto &Attachment: WallSegment->Attachments)
 			{
-				if (Attachment.Probability == 0 || FMath::RandRange(0.0, 1.0) > Attachment.Probability) continue;
+				if (Attachment.Probability == 0 || RandomStream.FRandRange(0.0, 1.0) > Attachment.Probability) continue;
 
 				double TargetWidth = Attachment.bFitToWallSegmentWidth ? FinalSegmentLength : Attachment.OverrideWidth;
 				double TargetHeight = Attachment.bFitToHoleHeight ? WallSegment->HoleHeight : (Attachment.bFitToWallSegmentHeight ? LevelDescription->LevelHeight : Attachment.OverrideHeight);
@@ -1686,32 +1568,9 @@ bool ABuilding::AddAttachments(int FloorIndex, ULevelDescription* LevelDescripti
 				{
 					case EAttachmentKind::InstancedStaticMeshComponent:
 					{
-						UStaticMesh *Mesh = Cast<UStaticMesh>(FWeightedObject::GetRandomObject(Attachment.MeshSelection));
+						UStaticMesh *Mesh = Cast<UStaticMesh>(FWeightedObject::GetRandomObject(Attachment.MeshSelection, RandomStream));
 						if (!IsValid(Mesh)) break;
 
-						UInstancedStaticMeshComponent *ISM = nullptr;
-						if (!MeshToISM.Contains(Mesh))
-						{
-							ISM = NewObject<UInstancedStaticMeshComponent>(RootComponent);
-							ISM->SetStaticMesh(Mesh);
-							ISM->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
-							ISM->CreationMethod = EComponentCreationMethod::UserConstructionScript;
-							ISM->RegisterComponent(); 
-							AddInstanceComponent(ISM);
-							MeshToISM.Add(Mesh, ISM);
-							InstancedStaticMeshComponents.Add(ISM);
-						}
-						else
-						{
-							ISM = MeshToISM[Mesh];
-						}
-
-						if (!ISM)
-						{
-							UE_LOG(LogBuildingsFromSplines, Error, TEXT("Could not create ISM for window meshes"));
-							return false;
-						}
-						
 						FBox BoundingBox = Mesh->GetBoundingBox();
 						FVector Extent = BoundingBox.GetExtent();
 						FVector Scale(
@@ -1731,12 +1590,12 @@ bool ABuilding::AddAttachments(int FloorIndex, ULevelDescription* LevelDescripti
 						Transform.SetLocation(AttachmentLocation + RotatedOffset + FVector(0, 0, ZOffset));
 						Transform.SetRotation(AttachmentRotation * FQuat(Attachment.ExtraRotation));
 						Transform.SetScale3D(Scale);
-						ISM->AddInstance(Transform, true);
+						OutInstances.FindOrAdd(Mesh).Add(Transform);
 						break;
 					}
 					case EAttachmentKind::SplineMeshComponent:
 					{
-						UStaticMesh *Mesh = Cast<UStaticMesh>(FWeightedObject::GetRandomObject(Attachment.MeshSelection));
+						UStaticMesh *Mesh = Cast<UStaticMesh>(FWeightedObject::GetRandomObject(Attachment.MeshSelection, RandomStream));
 						if (!IsValid(Mesh)) break;
 
 						double Width = TargetWidth > 0 ? TargetWidth : FinalSegmentLength;
@@ -1793,11 +1652,27 @@ bool ABuilding::AddAttachments(int FloorIndex, ULevelDescription* LevelDescripti
 	return true;
 }
 	
+int32 ABuilding::GetAttachmentsSeed() const
+{
+	// the seed only depends on the (rounded) locations of the spline points
+	uint32 Hash = 0;
+	const int NumSplinePoints = SplineComponent->GetNumberOfSplinePoints();
+	for (int i = 0; i < NumSplinePoints; i++)
+	{
+		const FVector Location = SplineComponent->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World);
+		Hash = HashCombine(Hash, GetTypeHash(FIntVector(FMath::RoundToInt(Location.X), FMath::RoundToInt(Location.Y), FMath::RoundToInt(Location.Z))));
+	}
+	return (int32) Hash;
+}
+
 bool ABuilding::AddAttachments()
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE_STR("AddAttachments");
 
-	double CurrentHeight = BCfg->ExtraWallBottom;
+	const FRandomStream RandomStream(GetAttachmentsSeed());
+	TMap<UStaticMesh*, TArray<FTransform>> Instances;
+
+	double CurrentHeight = ExtraWallBottom;
 
 	int NumFloors = ExpandedLevelDescriptionsKeys.Num();
 	for (int FloorIndex = 0; FloorIndex < NumFloors; FloorIndex++)
@@ -1808,22 +1683,48 @@ bool ABuilding::AddAttachments()
 
 		ULevelDescription *LevelDescription = BCfg->LevelsMap[LevelDescriptionKey];
 
-		if (!AddAttachments(FloorIndex, LevelDescription, CurrentHeight)) return false;
+		if (!AddAttachments(FloorIndex, LevelDescription, CurrentHeight, RandomStream, Instances)) return false;
 
 		CurrentHeight += LevelDescription->LevelHeight;
 	}
 
+	for (auto &[Mesh, Transforms] : Instances)
+	{
+		UInstancedStaticMeshComponent *ISM = nullptr;
+		if (!MeshToISM.Contains(Mesh))
+		{
+			ISM = NewObject<UInstancedStaticMeshComponent>(RootComponent);
+			ISM->SetStaticMesh(Mesh);
+			ISM->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
+			ISM->CreationMethod = EComponentCreationMethod::UserConstructionScript;
+			ISM->RegisterComponent(); 
+			AddInstanceComponent(ISM);
+			MeshToISM.Add(Mesh, ISM);
+			InstancedStaticMeshComponents.Add(ISM);
+		}
+		else
+		{
+			ISM = MeshToISM[Mesh];
+		}
+
+		if (!ISM)
+		{
+			UE_LOG(LogBuildingsFromSplines, Error, TEXT("Could not create ISM for window meshes"));
+			return false;
+		}
+
+		ISM->AddInstances(Transforms, false, true);
+	}
+
 	return true;
 }
 
-void ABuilding::AppendBuildingStructure(UDynamicMesh* TargetMesh)
+void ABuilding::AppendBuildingStructure(FDynamicMesh3 &TargetMesh)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE_STR("AppendBuildingStructure");
 
-	if (BCfg->bAutoPadWallBottom)
-	{
-		BCfg->ExtraWallBottom = MaxHeightLocal - MinHeightLocal + BCfg->PadBottom;
-	}
+	// the configuration can be shared by several buildings generated in parallel, so the wall bottom of this building is kept here
+	ExtraWallBottom = BCfg->bAutoPadWallBottom ? MaxHeightLocal - MinHeightLocal + BCfg->PadBottom : BCfg->ExtraWallBottom;
 
 	if (
 		BCfg->BuildingGeometry == EBuildingGeometry::BuildingWithFloorsAndEmptyInside ||
@@ -1847,19 +1748,11 @@ void ABuilding::AppendBuildingStructure(UDynamicMesh* TargetMesh)
 	{
 		AppendBuildingWithoutInside(TargetMesh);
 	}
-
-	Concurrency::RunOnGameThread([this]() {
-		for (int i = 0; i < BCfg->MaterialsArray.Num(); i++)
-			DynamicMeshComponent->SetMaterial(i, BCfg->MaterialsArray[i]);
-	});
 }
 
-bool ABuilding::AppendBuilding(UDynamicMesh* TargetMesh, FName SpawnedActorsPathOverride)
+bool ABuilding::AppendBuildingGeometry(FDynamicMesh3 &TargetMesh)
 {
-	TRACE_CPUPROFILER_EVENT_SCOPE_STR("AppendBuilding");
-
-	ComputeMinMaxHeight();
-	ComputeBaseVertices();
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("AppendBuildingGeometry");
 
 	if (!InitializeWallSegments()) return false;
 
@@ -1872,75 +1765,379 @@ bool ABuilding::AppendBuilding(UDynamicMesh* TargetMesh, FName SpawnedActorsPath
 	{
 		AppendRoof(TargetMesh);
 	}
-	
 
-	return Concurrency::RunOnGameThreadAndWait([this, &TargetMesh, &SpawnedActorsPathOverride]()
 	{
-		{
-			TRACE_CPUPROFILER_EVENT_SCOPE_STR("AppendBuilding/ComputeSplitNormals");
+		TRACE_CPUPROFILER_EVENT_SCOPE_STR("AppendBuilding/ComputeSplitNormals");
+
+		MeshFunctions::ComputeSplitNormals(TargetMesh);
+	}
+
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE_STR("AppendBuilding/AutoGenerateXAtlasMeshUVs");
 
-			UGeometryScriptLibrary_MeshNormalsFunctions::ComputeSplitNormals(TargetMesh, FGeometryScriptSplitNormalsOptions(), FGeometryScriptCalculateNormalsOptions());
+		// the dynamic mesh is emptied when it is converted to a static mesh or a volume
+#if WITH_EDITOR
+		const bool bMeshIsConverted = BCfg->bConvertToStaticMesh || BCfg->bConvertToVolume;
+#else
+		const bool bMeshIsConverted = false;
+#endif
+
+		if (BCfg->bAutoGenerateXAtlasMeshUVs && !bMeshIsConverted)
+		{
+			MeshFunctions::AutoGenerateXAtlasUVs(TargetMesh);
 		}
+	}
+
+	return true;
+}
+
+bool ABuilding::AddBuildingComponents(FName SpawnedActorsPathOverride)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("AddBuildingComponents");
+
+	for (int i = 0; i < MaterialsArray.Num(); i++)
+		DynamicMeshComponent->SetMaterial(i, MaterialsArray[i]);
+
+#if WITH_EDITOR
+	if (BCfg->bConvertToStaticMesh)
+	{
+		GenerateStaticMesh();
+	}
+
+	if (BCfg->bConvertToVolume)
+	{
+		GenerateVolume(SpawnedActorsPathOverride);
+	}
+
+	if (BCfg->bConvertToStaticMesh || BCfg->bConvertToVolume)
+	{
+		DynamicMeshComponent->GetDynamicMesh()->Reset();
+	}
+
+#else
+
+	if (BCfg->bConvertToStaticMesh || BCfg->bConvertToVolume)
+	{
+		UE_LOG(LogBuildingsFromSplines, Warning, TEXT("Cannot convert building to static mesh or volume at runtime"));
+	}
+
+#endif
+
+	AddAttachments();
+	BaseClockwiseSplineComponent->ClearSplinePoints();
+
+	return true;
+}
+
+bool ABuilding::AppendBuilding(UDynamicMesh* TargetMesh, FName SpawnedActorsPathOverride)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("AppendBuilding");
+
+	if (!IsValid(TargetMesh)) return false;
+
+	Concurrency::RunOnGameThreadAndWait([this]() -> bool
+	{
+		ComputeMinMaxHeight();
+		ComputeBaseVertices();
+		return true;
+	});
+
+	FDynamicMesh3 BuildingMesh;
+	if (!AppendBuildingGeometry(BuildingMesh)) return false;
+
+	return Concurrency::RunOnGameThreadAndWait([this, TargetMesh, &BuildingMesh, &SpawnedActorsPathOverride]()
+	{
+		TargetMesh->EditMesh([&BuildingMesh](FDynamicMesh3 &EditMesh)
+		{
+			MeshFunctions::AppendMesh(EditMesh, BuildingMesh, FTransform());
+		});
+
+		UpdateBaseClockwiseSplineComponent();
+
+		if (!AddBuildingComponents(SpawnedActorsPathOverride)) return false;
 
 	#if WITH_EDITOR
-		if (BCfg->bConvertToStaticMesh)
+		if (GEditor) GEditor->NoteSelectionChange();
+	#endif
+
+		return true;
+	});
+}
+
+#if WITH_EDITOR
+
+namespace
+{
+	const TCHAR* SharedStaticMeshPrefix = TEXT("/Game/Buildings/SM_SharedBuilding_");
+
+	// static meshes shared by identical buildings, keyed by package path
+	TMap<FString, TWeakObjectPtr<UStaticMesh>> SharedStaticMeshes;
+
+	int64 Quantize(double Value, double Precision)
+	{
+		return FMath::RoundToInt64(Value / Precision);
+	}
+
+	void UpdateString(FXxHash64Builder &Builder, const FString &String)
+	{
+		Builder.Update(*String, String.Len() * sizeof(TCHAR));
+	}
+
+	/* Rigid transform from the local space of a building to a frame where identical footprints have the same coordinates,
+	 * whatever their start vertex and their rotation. Each candidate start vertex gives a frame with the start vertex at the
+	 * origin and its outgoing edge along X (the Z origin being MinZ). The footprint coordinates in these frames are compared
+	 * lexicographically, and the smallest one is kept, the first candidate winning ties (for symmetric footprints).
+	 * OutKey receives the quantized coordinates of the footprint in the chosen frame, and whether each vertex is a corner. */
+	FTransform GetCanonicalFootprintTransform(
+		const TArray<FVector2D> &Vertices, const TArray<bool> &IsCorner, const TArray<int> &Candidates, double MinZ,
+		TArray<int64> &OutKey
+	)
+	{
+		const int NumVertices = Vertices.Num();
+		FTransform Result = FTransform::Identity;
+		OutKey.Empty();
+
+		auto IsLess = [](const TArray<int64> &A, const TArray<int64> &B)
 		{
-			GenerateStaticMesh();
+			for (int i = 0; i < A.Num() && i < B.Num(); i++)
+			{
+				if (A[i] != B[i]) return A[i] < B[i];
+			}
+			return A.Num() < B.Num();
+		};
+
+		for (int Start : Candidates)
+		{
+			const FVector2D Origin = Vertices[Start];
+
+			// direction of the outgoing edge, skipping duplicate vertices
+			FVector2D Direction = FVector2D::ZeroVector;
+			for (int k = 1; k < NumVertices && Direction.IsNearlyZero(); k++)
+			{
+				Direction = (Vertices[(Start + k) % NumVertices] - Origin).GetSafeNormal();
+			}
+			if (Direction.IsNearlyZero()) Direction = FVector2D(1, 0);
+
+			const double Yaw = FMath::RadiansToDegrees(FMath::Atan2(Direction.Y, Direction.X));
+			const FTransform Transform = FTransform(FVector(-Origin.X, -Origin.Y, -MinZ)) * FTransform(FRotator(0, -Yaw, 0));
+
+			TArray<int64> Key;
+			Key.Reserve(3 * NumVertices);
+			for (int k = 0; k < NumVertices; k++)
+			{
+				const int Index = (Start + k) % NumVertices;
+				const FVector Position = Transform.TransformPosition(FVector(Vertices[Index], 0));
+				Key.Add(Quantize(Position.X, MILLIMETER));
+				Key.Add(Quantize(Position.Y, MILLIMETER));
+				Key.Add(IsCorner[Index] ? 1 : 0);
+			}
+
+			if (OutKey.IsEmpty() || IsLess(Key, OutKey))
+			{
+				OutKey = MoveTemp(Key);
+				Result = Transform;
+			}
 		}
 
-		if (BCfg->bConvertToVolume)
+		return Result;
+	}
+
+	/* Hash of the properties of the configuration, and of its levels and wall segments. References to objects are hashed
+	 * by path, relative to the configuration for its own subobjects, so that identical configurations on different actors match. */
+	void HashConfiguration(FXxHash64Builder &Builder, const UBuildingConfiguration *BCfg)
+	{
+		const FString RootPath = BCfg->GetPathName();
+
+		auto HashProperties = [&](const UObject *Object, const UClass *FirstClass)
+		{
+			for (TFieldIterator<FProperty> It(Object->GetClass()); It; ++It)
+			{
+				if (It->HasAnyPropertyFlags(CPF_Transient)) continue;
+
+				// skip the properties of the actor component itself
+				if (FirstClass && !It->GetOwnerClass()->IsChildOf(FirstClass)) continue;
+
+				FString Value;
+				It->ExportText_InContainer(0, Value, Object, nullptr, nullptr, PPF_None);
+				Value.ReplaceInline(*RootPath, TEXT(""));
+
+				UpdateString(Builder, It->GetName());
+				UpdateString(Builder, Value);
+			}
+		};
+
+		HashProperties(BCfg, UBuildingConfiguration::StaticClass());
+
+		TArray<UObject*> Subobjects;
+		GetObjectsWithOuter(BCfg, Subobjects, /* bIncludeNestedObjects */ true);
+		Subobjects.Sort([BCfg](const UObject &A, const UObject &B) { return A.GetPathName(BCfg) < B.GetPathName(BCfg); });
+
+		for (const UObject *Subobject : Subobjects)
 		{
-			GenerateVolume(SpawnedActorsPathOverride);
+			UpdateString(Builder, Subobject->GetPathName(BCfg));
+			UpdateString(Builder, Subobject->GetClass()->GetPathName());
+			HashProperties(Subobject, nullptr);
 		}
+	}
+
+	/* Geometry of a mesh which is already in the canonical frame. The vertices, and the triangles with their material IDs,
+	 * are sorted by quantized position, so that the hash doesn't depend on the order in which they were generated
+	 * (which follows the spline, and not the canonical start vertex). */
+	void HashCanonicalMesh(FXxHash64Builder &Builder, const FDynamicMesh3 &Mesh)
+	{
+		auto QuantizePosition = [](const FVector3d &Position)
+		{
+			return FInt64Vector3(Quantize(Position.X, MILLIMETER), Quantize(Position.Y, MILLIMETER), Quantize(Position.Z, MILLIMETER));
+		};
 
-		if (BCfg->bConvertToStaticMesh || BCfg->bConvertToVolume)
+		auto IsLess = [](const FInt64Vector4 &A, const FInt64Vector4 &B)
 		{
-			DynamicMeshComponent->GetDynamicMesh()->Reset();
+			if (A.X != B.X) return A.X < B.X;
+			if (A.Y != B.Y) return A.Y < B.Y;
+			if (A.Z != B.Z) return A.Z < B.Z;
+			return A.W < B.W;
+		};
+
+		TArray<FInt64Vector4> Vertices;
+		Vertices.Reserve(Mesh.VertexCount());
+		for (int VertexID : Mesh.VertexIndicesItr())
+		{
+			Vertices.Add(FInt64Vector4(QuantizePosition(Mesh.GetVertex(VertexID)), 0));
 		}
+		Vertices.Sort(IsLess);
 
-	#else
+		const FDynamicMeshMaterialAttribute *MaterialIDs = Mesh.HasAttributes() ? Mesh.Attributes()->GetMaterialID() : nullptr;
 
-		if (BCfg->bConvertToStaticMesh || BCfg->bConvertToVolume)
+		// triangles are identified by their centroid, scaled by 3 to stay on the quantization grid
+		TArray<FInt64Vector4> Triangles;
+		Triangles.Reserve(Mesh.TriangleCount());
+		for (int TriangleID : Mesh.TriangleIndicesItr())
 		{
-			UE_LOG(LogBuildingsFromSplines, Warning, TEXT("Cannot convert building to static mesh or volume at runtime"));
+			FVector3d A, B, C;
+			Mesh.GetTriVertices(TriangleID, A, B, C);
+			Triangles.Add(FInt64Vector4(QuantizePosition(A + B + C), MaterialIDs ? MaterialIDs->GetValue(TriangleID) : 0));
 		}
+		Triangles.Sort(IsLess);
 
-	#endif
+		const int NumVertices = Vertices.Num();
+		const int NumTriangles = Triangles.Num();
+		Builder.Update(&NumVertices, sizeof(NumVertices));
+		Builder.Update(Vertices.GetData(), Vertices.Num() * sizeof(FInt64Vector4));
+		Builder.Update(&NumTriangles, sizeof(NumTriangles));
+		Builder.Update(Triangles.GetData(), Triangles.Num() * sizeof(FInt64Vector4));
+	}
 
+	UStaticMesh* FindSharedStaticMesh(const FString &PackagePath)
+	{
+		if (TWeakObjectPtr<UStaticMesh> *SharedStaticMesh = SharedStaticMeshes.Find(PackagePath))
 		{
-			TRACE_CPUPROFILER_EVENT_SCOPE_STR("AppendBuilding/AutoGenerateXAtlasMeshUVs");
+			if (SharedStaticMesh->IsValid()) return SharedStaticMesh->Get();
+		}
 
-			if (BCfg->bAutoGenerateXAtlasMeshUVs)
+		// the asset might have been created in a previous session
+		const FString ObjectPath = PackagePath + "." + FPackageName::GetShortName(PackagePath);
+		UStaticMesh *StaticMesh = FindObject<UStaticMesh>(nullptr, *ObjectPath);
+		if (!IsValid(StaticMesh) && FPackageName::DoesPackageExist(PackagePath))
+		{
+			StaticMesh = LoadObject<UStaticMesh>(nullptr, *ObjectPath, nullptr, LOAD_NoWarn | LOAD_Quiet);
+		}
+
+		if (!IsValid(StaticMesh)) return nullptr;
+
+		SharedStaticMeshes.Add(PackagePath, StaticMesh);
+		return StaticMesh;
+	}
+}
+
+void ABuilding::GenerateStaticMesh()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("GenerateStaticMesh");
+
+	/* When sharing static meshes, buildings are keyed by their footprint in a canonical frame, by their configuration,
+	 * and by their geometry in that frame (which differs when random choices differ). The mesh is stored in the canonical
+	 * frame, and the static mesh component is placed with the inverse transform, so that identical footprints with
+	 * a different start vertex or rotation share the mesh. */
+
+	bool bShareStaticMesh = false;
+	FTransform CanonicalTransform = FTransform::Identity;
+	FDynamicMesh3 CanonicalMesh;
+	UStaticMesh *StaticMesh = nullptr;
+
+	if (BCfg->bShareIdenticalStaticMeshes && !BaseVertices2D.IsEmpty())
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE_STR("GenerateStaticMesh/HashBuilding");
+
+		// the wall segments restart at every corner only when all levels reset them,
+		// otherwise they start at the first spline point, which must then stay the start vertex
+		bool bAnyCornerCanStart = bSplineIsClosedLoop;
+		for (const FString &LevelDescriptionKey : ExpandedLevelDescriptionsKeys)
+		{
+			const TObjectPtr<ULevelDescription> *LevelDescription = BCfg->LevelsMap.Find(LevelDescriptionKey);
+			if (!LevelDescription || !IsValid(*LevelDescription) || !(*LevelDescription)->bResetWallSegmentsOnCorners)
 			{
-				UGeometryScriptLibrary_MeshUVFunctions::AutoGenerateXAtlasMeshUVs(TargetMesh, 0, FGeometryScriptXAtlasOptions());
+				bAnyCornerCanStart = false;
 			}
+		}
 
+		TArray<bool> IsCorner;
+		IsCorner.SetNumZeroed(BaseVertices2D.Num());
+		TArray<int> Candidates;
+		for (int i = 0; i < SplineNumPoints && i < SplineIndexToBaseSplineIndex.Num(); i++)
+		{
+			const int BaseIndex = SplineIndexToBaseSplineIndex[i];
+			if (!BaseVertices2D.IsValidIndex(BaseIndex)) continue;
+			IsCorner[BaseIndex] = true;
+			if (bAnyCornerCanStart || i == 0) Candidates.AddUnique(BaseIndex);
 		}
 
+		TArray<int64> FootprintKey;
+		CanonicalTransform = GetCanonicalFootprintTransform(BaseVertices2D, IsCorner, Candidates, MinHeightLocal, FootprintKey);
 
-		AddAttachments();
-		BaseClockwiseSplineComponent->ClearSplinePoints();
+		FXxHash64Builder Builder;
+		Builder.Update(FootprintKey.GetData(), FootprintKey.Num() * sizeof(int64));
+		Builder.Update(&bSplineIsClosedLoop, sizeof(bSplineIsClosedLoop));
 
-	#if WITH_EDITOR
-		if (GEditor) GEditor->NoteSelectionChange();
-	#endif
+		const int64 QuantizedExtraWallBottom = Quantize(ExtraWallBottom, MILLIMETER);
+		Builder.Update(&QuantizedExtraWallBottom, sizeof(QuantizedExtraWallBottom));
+		for (const FString &LevelDescriptionKey : ExpandedLevelDescriptionsKeys)
+		{
+			UpdateString(Builder, LevelDescriptionKey);
+		}
 
-		return true;
-	});
-}
+		HashConfiguration(Builder, BCfg);
+		for (UMaterialInterface *Material : DynamicMeshComponent->GetMaterials())
+		{
+			UpdateString(Builder, IsValid(Material) ? Material->GetPathName() : FString());
+		}
 
-#if WITH_EDITOR
+		DynamicMeshComponent->GetDynamicMesh()->ProcessMesh([&](const FDynamicMesh3 &Mesh)
+		{
+			if (Mesh.TriangleCount() == 0) return;
+			CanonicalMesh = Mesh;
+			bShareStaticMesh = true;
+		});
 
-void ABuilding::GenerateStaticMesh()
-{
-	TRACE_CPUPROFILER_EVENT_SCOPE_STR("GenerateStaticMesh");
-	EGeometryScriptOutcomePins Outcome;
+		if (bShareStaticMesh)
+		{
+			MeshTransforms::ApplyTransform(CanonicalMesh, FTransformSRT3d(CanonicalTransform), true);
+			HashCanonicalMesh(Builder, CanonicalMesh);
 
-	FString Unused;
-	FGeometryScriptUniqueAssetNameOptions GeometryScriptUniqueAssetNameOptions;
-	GeometryScriptUniqueAssetNameOptions.UniqueIDDigits = 18;
-	if (StaticMeshPath.IsEmpty())
+			StaticMeshPath = FString::Printf(TEXT("%s%016llx"), SharedStaticMeshPrefix, Builder.Finalize().Hash);
+			StaticMesh = FindSharedStaticMesh(StaticMeshPath);
+		}
+		else
+		{
+			CanonicalTransform = FTransform::Identity;
+		}
+	}
+	
+	// a shared static mesh must never be overwritten by a single building
+	if (!bShareStaticMesh && (StaticMeshPath.IsEmpty() || StaticMeshPath.StartsWith(SharedStaticMeshPrefix)))
 	{
+		EGeometryScriptOutcomePins Outcome;
+		FString Unused;
+		FGeometryScriptUniqueAssetNameOptions GeometryScriptUniqueAssetNameOptions;
+		GeometryScriptUniqueAssetNameOptions.UniqueIDDigits = 18;
 		UGeometryScriptLibrary_CreateNewAssetFunctions::CreateUniqueNewAssetPathName(
 			FString("/Game/Buildings"),
 			FString("SM_Building"),
@@ -1959,35 +2156,58 @@ void ABuilding::GenerateStaticMesh()
 		}
 	}
 
-	UE::AssetUtils::FStaticMeshAssetOptions StaticMeshAssetOptions;
-	StaticMeshAssetOptions.NewAssetPath = StaticMeshPath;
-	StaticMeshAssetOptions.NumMaterialSlots = DynamicMeshComponent->GetNumMaterials();
-	StaticMeshAssetOptions.bGenerateNaniteEnabledMesh = BCfg->bEnableNanite;
-	StaticMeshAssetOptions.NaniteSettings.bEnabled = true;
-	StaticMeshAssetOptions.AssetMaterials = DynamicMeshComponent->GetMaterials();
-	StaticMeshAssetOptions.SourceMeshes.DynamicMeshes.Add(DynamicMeshComponent->GetDynamicMesh()->GetMeshPtr());
-
-	UE::AssetUtils::FStaticMeshResults StaticMeshResults;
-	if (UE::AssetUtils::CreateStaticMeshAsset(StaticMeshAssetOptions, StaticMeshResults) != UE::AssetUtils::ECreateStaticMeshResult::Ok)
+	if (!StaticMesh)
 	{
-		LCReporter::ShowError(
-			LOCTEXT("StaticMeshError", "Internal error while creating static mesh from dynamic mesh, please check log output.")
-		);
-		return;
-	}
+		TRACE_CPUPROFILER_EVENT_SCOPE_STR("GenerateStaticMesh/CreateStaticMeshAsset");
 
-	UStaticMesh *StaticMesh = StaticMeshResults.StaticMesh;
-	if (!IsValid(StaticMesh))
+		// the dynamic mesh is kept in place, as it is also used to create the volume
+		FDynamicMesh3 SourceMesh;
+		if (bShareStaticMesh)
+		{
+			SourceMesh = MoveTemp(CanonicalMesh);
+		}
+		else
+		{
+			DynamicMeshComponent->GetDynamicMesh()->ProcessMesh([&](const FDynamicMesh3 &Mesh) { SourceMesh = Mesh; });
+		}
+
+		UE::AssetUtils::FStaticMeshAssetOptions StaticMeshAssetOptions;
+		StaticMeshAssetOptions.NewAssetPath = StaticMeshPath;
+		StaticMeshAssetOptions.NumMaterialSlots = DynamicMeshComponent->GetNumMaterials();
+		StaticMeshAssetOptions.bGenerateNaniteEnabledMesh = BCfg->bEnableNanite;
+		StaticMeshAssetOptions.NaniteSettings.bEnabled = true;
+		StaticMeshAssetOptions.AssetMaterials = DynamicMeshComponent->GetMaterials();
+		StaticMeshAssetOptions.SourceMeshes.DynamicMeshes.Add(&SourceMesh);
+
+		UE::AssetUtils::FStaticMeshResults StaticMeshResults;
+		if (UE::AssetUtils::CreateStaticMeshAsset(StaticMeshAssetOptions, StaticMeshResults) != UE::AssetUtils::ECreateStaticMeshResult::Ok)
+		{
+			LCReporter::ShowError(
+				LOCTEXT("StaticMeshError", "Internal error while creating static mesh from dynamic mesh, please check log output.")
+			);
+			return;
+		}
+
+		StaticMesh = StaticMeshResults.StaticMesh;
+		if (!IsValid(StaticMesh))
+		{
+			LCReporter::ShowError(
+				LOCTEXT("StaticMeshError", "Internal error while creating static mesh from dynamic mesh, invalid pointer, please check log output.")
+			);
+			return;
+		}
+
+		if (bShareStaticMesh) SharedStaticMeshes.Add(StaticMeshPath, StaticMesh);
+	}
+	else
 	{
-		LCReporter::ShowError(
-			LOCTEXT("StaticMeshError", "Internal error while creating static mesh from dynamic mesh, invalid pointer, please check log output.")
-		);
-		return;
+		UE_LOG(LogBuildingsFromSplines, Verbose, TEXT("Reusing static mesh %s for building %s"), *StaticMeshPath, *GetActorNameOrLabel());
 	}
 
 	StaticMeshComponent = NewObject<UStaticMeshComponent>(RootComponent);
 	StaticMeshComponent->SetStaticMesh(StaticMesh);
 	StaticMeshComponent->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
+	StaticMeshComponent->SetRelativeTransform(CanonicalTransform.Inverse());
 	StaticMeshComponent->CreationMethod = EComponentCreationMethod::UserConstructionScript;
 	StaticMeshComponent->RegisterComponent();
 
@@ -25,7 +25,7 @@ UBuildingConfiguration::UBuildingConfiguration()
 {
 }
 
-int UBuildingConfiguration::ResolveMaterial(FString ExprStr)
+int UBuildingConfiguration::ResolveMaterial(FString ExprStr, const TArray<FString> &MaterialNames) const
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE_STR("ResolveMaterial");
 
@@ -37,12 +37,12 @@ int UBuildingConfiguration::ResolveMaterial(FString ExprStr)
 	Expr->MakeChoices();
 	if (Expr->Children.IsEmpty()) return 0;
 
-	int Index = MaterialNamesArray.IndexOfByKey(Expr->Children[0]->Symbol);
+	int Index = MaterialNames.IndexOfByKey(Expr->Children[0]->Symbol);
 	if (Index >= 0) return Index;
 	else return 0;
 }
 
-bool UBuildingConfiguration::AutoComputeNumFloors(UOSMUserData *BuildingOSMUserData)
+bool UBuildingConfiguration::AutoComputeNumFloors(UOSMUserData *BuildingOSMUserData, int &OutNumFloors) const
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE_STR("AutoComputeNumFloors");
 
@@ -55,8 +55,7 @@ bool UBuildingConfiguration::AutoComputeNumFloors(UOSMUserData *BuildingOSMUserD
 		int NumLevels = FCString::Atoi(*LevelsString);
 		if (NumLevels > 0)
 		{
-			bUseRandomNumFloors = false;
-			NumFloors = NumLevels;
+			OutNumFloors = NumLevels;
 			return true;
 		}
 		// we don't return false to give a chance to the 'height' field below
@@ -72,8 +71,7 @@ bool UBuildingConfiguration::AutoComputeNumFloors(UOSMUserData *BuildingOSMUserD
 		double Height = FCString::Atod(*HeightString);
 		if (Height > 0)
 		{
-			bUseRandomNumFloors = false;
-			NumFloors = FMath::Max(1, Height * 100 / 300);
+			OutNumFloors = FMath::Max(1, Height * 100 / 300);
 			return true;
 		}
 		else if (!HeightString.IsEmpty())
@@ -12,6 +12,7 @@
 #include "Logging/StructuredLog.h"
 #include "Kismet/GameplayStatics.h"
 #include "Misc/MessageDialog.h"
+#include "Misc/ScopeExit.h"
 #include "TransactionCommon.h" 
 #include "Engine/World.h"
 #include "Engine/Engine.h"
@@ -88,14 +89,133 @@ bool ABuildingsFromSplines::GenerateBuildings(FName SpawnedActorsPathOverride, b
 	const int NumComponents = SplineComponents.Num();
 	UE_LOG(LogBuildingsFromSplines, Log, TEXT("Found %d spline components to create buildings"), NumComponents);
 
+	TArray<USplineComponent*> SplinesToProcess;
 	for (TObjectPtr<USplineComponent> SplineComponent : SplineComponents)
 	{
 		if (bSkipExistingBuildings && ProcessedSplines.Contains(SplineComponent)) continue;
+		SplinesToProcess.Add(SplineComponent);
+	}
+
+	/* Buildings are generated in batches: they are spawned on the game thread, their geometry is then computed
+	 * in parallel, and their components are finally added on the game thread. */
+
+	const int BatchSize = 256;
+
+	// buildings of all batches are pushed out of collision against each other with their footprints
+	CollisionResolver Resolver;
+
+	for (int BatchStart = 0; BatchStart < SplinesToProcess.Num(); BatchStart += BatchSize)
+	{
+		const int BatchEnd = FMath::Min(BatchStart + BatchSize, SplinesToProcess.Num());
+		TArray<ABuilding*> BatchBuildings;
+		TArray<USplineComponent*> BatchSplines;
 
-		if (GenerateBuilding(SplineComponent, SpawnedActorsPathOverride, bIsUserInitiated))
-			ProcessedSplines.Add(SplineComponent);
-		else if (!bContinueDespiteErrors)
+		if (!Concurrency::RunOnGameThreadAndWait([&]() -> bool
+		{
+			if (!IsValid(GetWorld())) return false; // fail silently, the game has probably ended
+
+			for (int i = BatchStart; i < BatchEnd; i++)
+			{
+				USplineComponent *SplineComponent = SplinesToProcess[i];
+				if (!IsValid(SplineComponent)) continue;
+
+				if (SplineComponent->GetNumberOfSplinePoints() <= 1)
+				{
+					UE_LOG(LogBuildingsFromSplines, Log, TEXT("Skipping building with zero or one point"));
+					ProcessedSplines.Add(SplineComponent);
+					continue;
+				}
+
+				ABuilding *Building = SpawnBuilding(SplineComponent, SpawnedActorsPathOverride);
+
+				// the building is already being generated on its own (for instance after one of its properties changed)
+				if (IsValid(Building) && Building->bIsGenerating)
+				{
+					UE_LOG(LogBuildingsFromSplines, Log, TEXT("Skipping building %s, which is already being generated"), *Building->GetActorNameOrLabel());
+					continue;
+				}
+
+				// the flag is cleared once the batch is committed
+				if (IsValid(Building)) Building->bIsGenerating = true;
+
+				if (IsValid(Building) && Building->PrepareGeneration())
+				{
+					BatchBuildings.Add(Building);
+					BatchSplines.Add(SplineComponent);
+				}
+				else
+				{
+					if (IsValid(Building)) Building->bIsGenerating = false;
+					if (!bContinueDespiteErrors) return false;
+				}
+			}
+			return true;
+		}))
+		{
 			return false;
+		}
+
+		TArray<bool> GeometryResults;
+		if (IsInGameThread())
+		{
+			for (ABuilding *Building : BatchBuildings)
+			{
+				const bool bSuccess = Building->GenerateGeometry();
+				GeometryResults.Add(bSuccess);
+				if (!bSuccess && !bContinueDespiteErrors) break;
+			}
+		}
+		else
+		{
+			LCCancellationToken Cancellation;
+			Concurrency::RunArrayAndWait<ABuilding*, bool>(
+				BatchBuildings, GeometryResults,
+				[this, &Cancellation](ABuilding *Building, bool &bOutSuccess) -> bool
+				{
+					bOutSuccess = Building->GenerateGeometry();
+					if (!bOutSuccess && !bContinueDespiteErrors) Cancellation.Cancel();
+					return bOutSuccess;
+				},
+				EConcurrencyResource::CPU, &Cancellation
+			);
+		}
+
+		if (!Concurrency::RunOnGameThreadAndWait([&]() -> bool
+		{
+			ON_SCOPE_EXIT
+			{
+				for (ABuilding *Building : BatchBuildings)
+				{
+					if (IsValid(Building)) Building->bIsGenerating = false;
+				}
+			};
+
+			TArray<FCollisionFootprint> Footprints;
+			for (int i = 0; i < BatchBuildings.Num(); i++)
+			{
+				const bool bGeometryGenerated = GeometryResults.IsValidIndex(i) && GeometryResults[i];
+				if (bGeometryGenerated && IsValid(BatchBuildings[i]) && BatchBuildings[i]->CommitGeneration(SpawnedActorsPathOverride))
+				{
+					ProcessedSplines.Add(BatchSplines[i]);
+
+					const UBuildingConfiguration *BCfg = BatchBuildings[i]->BCfg;
+					if (BCfg->bAttemptToPushOutOfCollision || BCfg->bEnableComplexCollision)
+					{
+						Footprints.Add(BatchBuildings[i]->GetCollisionFootprint());
+					}
+				}
+				else if (!bContinueDespiteErrors)
+				{
+					return false;
+				}
+			}
+
+			Resolver.Resolve(GetWorld(), Footprints);
+			return true;
+		}))
+		{
+			return false;
+		}
 	}
 
 
@@ -113,17 +233,11 @@ void ABuildingsFromSplines::ClearBuildings()
 	Execute_Cleanup(this, false);
 }
 
-bool ABuildingsFromSplines::GenerateBuilding(USplineComponent* SplineComponent, FName SpawnedActorsPathOverride, bool bIsUserInitiated)
+ABuilding* ABuildingsFromSplines::SpawnBuilding(USplineComponent* SplineComponent, FName SpawnedActorsPathOverride)
 {
-	TWeakObjectPtr<ABuildingsFromSplines> WeakThis(this);
+	check(IsInGameThread());
 
 	int NumPoints = SplineComponent->GetNumberOfSplinePoints();
-	if (NumPoints <= 1)
-	{
-		UE_LOG(LogBuildingsFromSplines, Log, TEXT("Skipping building with zero or one point"));
-		return true;
-	}
-
 	FVector Location = SplineComponent->GetWorldLocationAtSplinePoint(0);
 
 	/* Determine the rotation of the longest segment */
@@ -148,49 +262,44 @@ bool ABuildingsFromSplines::GenerateBuilding(USplineComponent* SplineComponent,
 		}
 	}
 
-	ABuilding* Building = nullptr;
-	
-	return Concurrency::RunOnGameThreadAndWait([WeakThis, &Building, &Location, &RotatorForLargestSegment, &SpawnedActorsPathOverride, NumPoints, SplineComponent]() -> bool
+	ABuilding *Building = GetWorld()->SpawnActor<ABuilding>(Location, RotatorForLargestSegment);
+	if (!IsValid(Building))
 	{
-		if (!WeakThis.IsValid() || !IsValid(WeakThis->GetWorld())) return false; // fail silently, the game has probably ended
-		Building = WeakThis->GetWorld()->SpawnActor<ABuilding>(Location, RotatorForLargestSegment);
-		if (!IsValid(Building))
-		{
-			LCReporter::ShowError(
-				LOCTEXT("CannotSpawnBuilding", "Internal Error: Cannot Spawn Building")
-			);
-			return false;
-		}
+		LCReporter::ShowError(
+			LOCTEXT("CannotSpawnBuilding", "Internal Error: Cannot Spawn Building")
+		);
+		return nullptr;
+	}
 
 #if WITH_EDITOR
-		ULCBlueprintLibrary::SetFolderPath2(Building, SpawnedActorsPathOverride, WeakThis->SpawnedActorsPath);
+	ULCBlueprintLibrary::SetFolderPath2(Building, SpawnedActorsPathOverride, SpawnedActorsPath);
 #endif
 
-		WeakThis->Buildings.Add(Building);
-        Building->BCfg = FWeightedBuildingConfiguration::GetRandomBuildingConfiguration(WeakThis->BuildingConfigurations);
+	Buildings.Add(Building);
+	Building->BCfg = FWeightedBuildingConfiguration::GetRandomBuildingConfiguration(BuildingConfigurations);
 
-		Building->SplineComponent->ClearSplinePoints();
-		for (int i = 0; i < NumPoints; i++)
-		{
-			Building->SplineComponent->AddSplinePoint(SplineComponent->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World), ESplineCoordinateSpace::World, false);
-			Building->SplineComponent->SetSplinePointType(i, SplineComponent->GetSplinePointType(i), false);
-		}
-		Building->SplineComponent->UpdateSpline();
-		
-		UOSMUserData *SplineOSMUserData = Cast<UOSMUserData>(SplineComponent->GetAssetUserDataOfClass(UOSMUserData::StaticClass()));
+	Building->SplineComponent->ClearSplinePoints();
+	for (int i = 0; i < NumPoints; i++)
+	{
+		Building->SplineComponent->AddSplinePoint(SplineComponent->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World), ESplineCoordinateSpace::World, false);
+		Building->SplineComponent->SetSplinePointType(i, SplineComponent->GetSplinePointType(i), false);
+	}
+	Building->SplineComponent->UpdateSpline();
+	
+	UOSMUserData *SplineOSMUserData = Cast<UOSMUserData>(SplineComponent->GetAssetUserDataOfClass(UOSMUserData::StaticClass()));
 
-		if (IsValid(SplineOSMUserData) && Building->GetRootComponent())
-		{
-			UOSMUserData *BuildingOSMUserData = NewObject<UOSMUserData>(Building->GetRootComponent());
-			BuildingOSMUserData->Fields = SplineOSMUserData->Fields;
-			Building->GetRootComponent()->AddAssetUserData(BuildingOSMUserData);
-		}
+	if (IsValid(SplineOSMUserData) && Building->GetRootComponent())
+	{
+		UOSMUserData *BuildingOSMUserData = NewObject<UOSMUserData>(Building->GetRootComponent());
+		BuildingOSMUserData->Fields = SplineOSMUserData->Fields;
+		Building->GetRootComponent()->AddAssetUserData(BuildingOSMUserData);
+	}
 
 #if WITH_EDITOR
-		Building->SetIsSpatiallyLoaded(WeakThis->bBuildingsSpatiallyLoaded);
+	Building->SetIsSpatiallyLoaded(bBuildingsSpatiallyLoaded);
 #endif
-		return Building->GenerateBuilding_Internal(SpawnedActorsPathOverride);
-	});
+
+	return Building;
 }
 
 #if WITH_EDITOR
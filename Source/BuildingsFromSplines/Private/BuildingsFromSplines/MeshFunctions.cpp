@@ -0,0 +1,208 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#include "BuildingsFromSplines/MeshFunctions.h"
+
+#include "DynamicMesh/DynamicMeshAttributeSet.h"
+#include "DynamicMesh/MeshNormals.h"
+#include "DynamicMeshEditor.h"
+#include "Generators/SweepGenerator.h"
+#include "Parameterization/DynamicMeshUVEditor.h"
+#include "ParameterizationOps/ParameterizeMeshOp.h"
+#include "Polygon2.h"
+
+FDynamicMeshMaterialAttribute* MeshFunctions::GetOrEnableMaterialIDs(FDynamicMesh3 &Mesh)
+{
+	if (!Mesh.HasAttributes()) Mesh.EnableAttributes();
+	if (!Mesh.Attributes()->HasMaterialID()) Mesh.Attributes()->EnableMaterialID();
+	return Mesh.Attributes()->GetMaterialID();
+}
+
+void MeshFunctions::AppendSimpleExtrudePolygon(FDynamicMesh3 &TargetMesh, const FTransform &Transform, const TArray<FVector2D> &Polygon, double Height)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MeshFunctions::AppendSimpleExtrudePolygon");
+
+	if (Polygon.Num() < 3) return;
+
+	FGeneralizedCylinderGenerator Generator;
+	Generator.CrossSection = FPolygon2d(Polygon);
+	Generator.Path = { FVector3d(0, 0, 0), FVector3d(0, 0, Height) };
+	Generator.InitialFrame = FFrame3d();
+	Generator.bCapped = true;
+	Generator.Generate();
+
+	FDynamicMesh3 Mesh(&Generator);
+	GetOrEnableMaterialIDs(Mesh);
+	AppendMesh(TargetMesh, Mesh, Transform);
+}
+
+void MeshFunctions::AppendSweepPolyline(
+	FDynamicMesh3 &TargetMesh, const TArray<FVector2D> &Polyline, const TArray<FTransform> &SweepPath,
+	bool bLoop, bool bFlipOrientation
+)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MeshFunctions::AppendSweepPolyline");
+
+	const int NumProfile = Polyline.Num();
+	const int NumPath = SweepPath.Num();
+	if (NumProfile < 2 || NumPath < 2) return;
+
+	FDynamicMesh3 Mesh;
+	Mesh.EnableTriangleGroups();
+	Mesh.EnableAttributes();
+	GetOrEnableMaterialIDs(Mesh);
+	FDynamicMeshUVOverlay *UVOverlay = Mesh.Attributes()->PrimaryUV();
+
+	for (int i = 0; i < NumPath; i++)
+	{
+		for (int j = 0; j < NumProfile; j++)
+		{
+			Mesh.AppendVertex(SweepPath[i].TransformPosition(FVector(0, Polyline[j].X, Polyline[j].Y)));
+		}
+	}
+
+	// closed sweeps get an extra column of UVs, so that there is no seam in the UVs
+	const int NumColumns = bLoop ? NumPath + 1 : NumPath;
+	for (int i = 0; i < NumColumns; i++)
+	{
+		for (int j = 0; j < NumProfile; j++)
+		{
+			UVOverlay->AppendElement(FVector2f(i / float(NumColumns - 1), j / float(NumProfile - 1)));
+		}
+	}
+
+	const int GroupID = Mesh.AllocateTriangleGroup();
+	const int NumQuads = bLoop ? NumPath : NumPath - 1;
+	for (int i = 0; i < NumQuads; i++)
+	{
+		for (int j = 0; j < NumProfile - 1; j++)
+		{
+			const int NextI = (i + 1) % NumPath;
+			const FIndex4i Quad(i * NumProfile + j, NextI * NumProfile + j, NextI * NumProfile + j + 1, i * NumProfile + j + 1);
+			const FIndex4i QuadUVs(i * NumProfile + j, (i + 1) * NumProfile + j, (i + 1) * NumProfile + j + 1, i * NumProfile + j + 1);
+
+			FIndex3i Triangles[2] = { FIndex3i(0, 3, 1), FIndex3i(1, 3, 2) };
+			if (bFlipOrientation)
+			{
+				Triangles[0] = FIndex3i(0, 1, 3);
+				Triangles[1] = FIndex3i(1, 2, 3);
+			}
+
+			for (const FIndex3i &Triangle : Triangles)
+			{
+				const int TriangleID = Mesh.AppendTriangle(Quad[Triangle.A], Quad[Triangle.B], Quad[Triangle.C], GroupID);
+				if (TriangleID < 0) continue; // degenerate or non-manifold triangle
+				UVOverlay->SetTriangle(TriangleID, FIndex3i(QuadUVs[Triangle.A], QuadUVs[Triangle.B], QuadUVs[Triangle.C]));
+			}
+		}
+	}
+
+	AppendMesh(TargetMesh, Mesh, FTransform());
+}
+
+void MeshFunctions::AppendMesh(FDynamicMesh3 &TargetMesh, const FDynamicMesh3 &Mesh, const FTransform &Transform)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MeshFunctions::AppendMesh");
+
+	if (Mesh.HasTriangleGroups() && !TargetMesh.HasTriangleGroups()) TargetMesh.EnableTriangleGroups();
+	if (Mesh.HasAttributes())
+	{
+		if (!TargetMesh.HasAttributes()) TargetMesh.EnableAttributes();
+		TargetMesh.Attributes()->EnableMatchingAttributes(*Mesh.Attributes(), false);
+	}
+
+	const FTransformSRT3d XForm(Transform);
+	FMeshIndexMappings Mappings;
+	FDynamicMeshEditor Editor(&TargetMesh);
+	Editor.AppendMesh(
+		&Mesh, Mappings,
+		[&XForm](int, const FVector3d &Position) { return XForm.TransformPosition(Position); },
+		[&XForm](int, const FVector3d &Normal) { return XForm.TransformNormal(Normal); }
+	);
+}
+
+TArray<int> MeshFunctions::GetPolygroupIDs(const FDynamicMesh3 &Mesh)
+{
+	TArray<int> PolygroupIDs;
+	if (!Mesh.HasTriangleGroups()) return PolygroupIDs;
+
+	TSet<int> Seen;
+	for (int TriangleID : Mesh.TriangleIndicesItr())
+	{
+		const int PolygroupID = Mesh.GetTriangleGroup(TriangleID);
+		bool bAlreadySeen = false;
+		Seen.Add(PolygroupID, &bAlreadySeen);
+		if (!bAlreadySeen) PolygroupIDs.Add(PolygroupID);
+	}
+	return PolygroupIDs;
+}
+
+void MeshFunctions::SetPolygroupMaterialID(FDynamicMesh3 &Mesh, int PolygroupID, int MaterialID)
+{
+	if (!Mesh.HasTriangleGroups()) return;
+
+	FDynamicMeshMaterialAttribute *MaterialIDs = GetOrEnableMaterialIDs(Mesh);
+	for (int TriangleID : Mesh.TriangleIndicesItr())
+	{
+		if (Mesh.GetTriangleGroup(TriangleID) == PolygroupID) MaterialIDs->SetValue(TriangleID, MaterialID);
+	}
+}
+
+void MeshFunctions::RemapMaterialIDs(FDynamicMesh3 &Mesh, int FromMaterialID, int ToMaterialID)
+{
+	FDynamicMeshMaterialAttribute *MaterialIDs = GetOrEnableMaterialIDs(Mesh);
+	for (int TriangleID : Mesh.TriangleIndicesItr())
+	{
+		if (MaterialIDs->GetValue(TriangleID) == FromMaterialID) MaterialIDs->SetValue(TriangleID, ToMaterialID);
+	}
+}
+
+void MeshFunctions::SetUVsFromBoxProjection(FDynamicMesh3 &Mesh, const FTransform &BoxTransform)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MeshFunctions::SetUVsFromBoxProjection");
+
+	TArray<int32> Triangles;
+	Triangles.Reserve(Mesh.TriangleCount());
+	for (int TriangleID : Mesh.TriangleIndicesItr()) Triangles.Add(TriangleID);
+
+	const FTransformSRT3d XForm(BoxTransform);
+	const FFrame3d BoxFrame(XForm.GetTranslation(), XForm.GetRotation());
+
+	FDynamicMeshUVEditor UVEditor(&Mesh, 0, true);
+	UVEditor.SetTriangleUVsFromBoxProjection(Triangles, [](const FVector3d &Position) { return Position; }, BoxFrame, XForm.GetScale(), 2);
+}
+
+void MeshFunctions::ScaleUVs(FDynamicMesh3 &Mesh, const FVector2D &Scale)
+{
+	if (!Mesh.HasAttributes()) return;
+
+	FDynamicMeshUVOverlay *UVOverlay = Mesh.Attributes()->PrimaryUV();
+	const FVector2f Scale2f(Scale);
+	for (int ElementID : UVOverlay->ElementIndicesItr())
+	{
+		UVOverlay->SetElement(ElementID, UVOverlay->GetElement(ElementID) * Scale2f);
+	}
+}
+
+void MeshFunctions::AutoGenerateXAtlasUVs(FDynamicMesh3 &Mesh)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MeshFunctions::AutoGenerateXAtlasUVs");
+
+	FParameterizeMeshOp ParameterizeMeshOp;
+	ParameterizeMeshOp.InputMesh = MakeShared<FDynamicMesh3, ESPMode::ThreadSafe>(Mesh);
+	ParameterizeMeshOp.Method = EParamOpBackend::XAtlas;
+	ParameterizeMeshOp.UVLayer = 0;
+	ParameterizeMeshOp.XAtlasMaxIterations = 1;
+	ParameterizeMeshOp.CalculateResult(nullptr);
+
+	TUniquePtr<FDynamicMesh3> Result = ParameterizeMeshOp.ExtractResult();
+	if (Result.IsValid()) Mesh = MoveTemp(*Result);
+}
+
+void MeshFunctions::ComputeSplitNormals(FDynamicMesh3 &Mesh)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("MeshFunctions::ComputeSplitNormals");
+
+	if (!Mesh.HasAttributes()) Mesh.EnableAttributes();
+	FMeshNormals::InitializeOverlayTopologyFromOpeningAngle(&Mesh, Mesh.Attributes()->PrimaryNormals(), 15);
+	FMeshNormals::QuickRecomputeOverlayNormals(Mesh);
+}
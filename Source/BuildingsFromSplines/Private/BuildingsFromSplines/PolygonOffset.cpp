@@ -0,0 +1,222 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#include "BuildingsFromSplines/PolygonOffset.h"
+
+#include "SegmentTypes.h"
+
+using namespace UE::Geometry;
+
+#define MILLIMETER 0.1
+
+namespace
+{
+	/* Uniform grid containing the edges of a closed polygon, each edge being added to all the cells that it crosses */
+	class FEdgeGrid
+	{
+	public:
+		FEdgeGrid(const TArray<FVector2D> &Polygon0, double CellSize0) :
+			Polygon(Polygon0), CellSize(CellSize0)
+		{
+			const int NumVertices = Polygon.Num();
+			for (int j = 0; j < NumVertices; j++)
+			{
+				AddEdge(j, Polygon[j], Polygon[(j + 1) % NumVertices]);
+			}
+		}
+
+		/* Returns true if an edge of the polygon is at distance less than Radius from Point */
+		bool IsTooClose(const FVector2D &Point, double Radius, double Tolerance) const
+		{
+			const int NumVertices = Polygon.Num();
+			const int MinX = GetCell(Point.X - Radius);
+			const int MaxX = GetCell(Point.X + Radius);
+			const int MinY = GetCell(Point.Y - Radius);
+			const int MaxY = GetCell(Point.Y + Radius);
+
+			for (int X = MinX; X <= MaxX; X++)
+			{
+				for (int Y = MinY; Y <= MaxY; Y++)
+				{
+					const TArray<int> *Edges = Cells.Find(FIntPoint(X, Y));
+					if (!Edges) continue;
+
+					for (int j : *Edges)
+					{
+						double Distance = TSegment2<double>::FastDistanceSquared(Polygon[j], Polygon[(j + 1) % NumVertices], Point);
+						if (Distance < Radius * Radius - Tolerance) return true;
+					}
+				}
+			}
+
+			return false;
+		}
+
+	private:
+		const TArray<FVector2D> &Polygon;
+		double CellSize;
+		TMap<FIntPoint, TArray<int>> Cells;
+
+		int GetCell(double Coordinate) const
+		{
+			return FMath::FloorToInt(Coordinate / CellSize);
+		}
+
+		void AddEdge(int EdgeIndex, FVector2D A, FVector2D B)
+		{
+			if (A.X > B.X) Swap(A, B);
+
+			// walk through the columns crossed by the edge, and add the cells covered by the part of the edge in each column
+			const int MinX = GetCell(A.X);
+			const int MaxX = GetCell(B.X);
+			for (int X = MinX; X <= MaxX; X++)
+			{
+				double Y1 = A.Y;
+				double Y2 = B.Y;
+				if (B.X > A.X)
+				{
+					const double Slope = (B.Y - A.Y) / (B.X - A.X);
+					Y1 = A.Y + (FMath::Max(A.X, X * CellSize) - A.X) * Slope;
+					Y2 = A.Y + (FMath::Min(B.X, (X + 1) * CellSize) - A.X) * Slope;
+				}
+
+				const int MinY = GetCell(FMath::Min(Y1, Y2));
+				const int MaxY = GetCell(FMath::Max(Y1, Y2));
+				for (int Y = MinY; Y <= MaxY; Y++)
+				{
+					Cells.FindOrAdd(FIntPoint(X, Y)).Add(EdgeIndex);
+				}
+			}
+		}
+	};
+}
+
+FVector2D PolygonOffset::GetShiftedPoint(const TArray<FVector2D> &Polygon, int Index, double Offset, bool bIsLoop)
+{
+	int NumVertices = Polygon.Num();
+	check(0 <= Index);
+	check(Index < NumVertices);
+
+	int PrevIndex = (Index + NumVertices - 1) % NumVertices;
+	int NextIndex = (Index + 1) % NumVertices;
+	const FVector2D &PrevPoint = Polygon[PrevIndex];
+	const FVector2D &Point = Polygon[Index];
+	const FVector2D &NextPoint = Polygon[NextIndex];
+
+	if (NumVertices == 1)
+	{
+		return Point;
+	}
+
+	if (Offset == 0)
+	{
+		return Point;
+	}
+
+	FVector2D WallDirection2 = (NextPoint - Point).GetSafeNormal();
+	FVector2D InsideDirection2 = WallDirection2.GetRotated(90);
+	FVector2D WallDirection1 = (Point - PrevPoint).GetSafeNormal();
+	FVector2D InsideDirection1 = WallDirection1.GetRotated(90);
+
+	FVector2D PointShift1 = Point + Offset * InsideDirection1;
+	FVector2D PointShift2 = Point + Offset * InsideDirection2;
+
+	if (Index == 0 && !bIsLoop)
+	{
+		return PointShift2;
+	}
+
+	if (Index == NumVertices - 1 && !bIsLoop)
+	{
+		return PointShift1;
+	}
+
+	return GetIntersection(PointShift1, WallDirection1, PointShift2, WallDirection2);
+}
+
+void PolygonOffset::Shift(const TArray<FVector2D> &Polygon, double Offset, TArray<FVector2D> &OutOffsetPolygon)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("PolygonOffset::Shift");
+
+	const int NumVertices = Polygon.Num();
+	OutOffsetPolygon.Empty(NumVertices);
+	for (int i = 0; i < NumVertices; i++)
+	{
+		OutOffsetPolygon.Add(GetShiftedPoint(Polygon, i, Offset, true));
+	}
+}
+
+void PolygonOffset::Deflate(
+	const TArray<FVector2D> &Polygon, const TArray<FVector2D> &Boundary, double Offset,
+	TArray<FVector2D> &OutOffsetPolygon, TArray<int> &OutIndexToOffsetIndex
+)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("PolygonOffset::Deflate");
+
+	const int NumVertices = Polygon.Num();
+	const int NumBoundaryVertices = Boundary.Num();
+
+	OutOffsetPolygon.Empty(NumVertices);
+	OutIndexToOffsetIndex.Empty();
+	OutIndexToOffsetIndex.SetNum(NumVertices);
+
+	// cells are at least as large as the offset, so that only the 3x3 cells around a point need to be checked,
+	// and about as large as the edges, so that each cell only contains a few edges
+	TUniquePtr<FEdgeGrid> Grid;
+	if (Offset > 0 && NumBoundaryVertices > 0)
+	{
+		double Perimeter = 0;
+		for (int j = 0; j < NumBoundaryVertices; j++)
+		{
+			Perimeter += FVector2D::Distance(Boundary[j], Boundary[(j + 1) % NumBoundaryVertices]);
+		}
+		Grid = MakeUnique<FEdgeGrid>(Boundary, FMath::Max(Offset, Perimeter / NumBoundaryVertices));
+	}
+
+	for (int i = 0; i < NumVertices; i++)
+	{
+		FVector2D Point = GetShiftedPoint(Polygon, i, Offset, true);
+
+		// when deflating a polygon, some points might be too close to an edge, we don't add those
+		// TODO: Remove expensive check and implement a proper polygon deflate algorithm
+		// TPolygon2::PolyOffset doesn't help as it has the same artefacts
+		if (!Grid || !Grid->IsTooClose(Point, Offset, MILLIMETER))
+		{
+			OutOffsetPolygon.Add(Point);
+		}
+
+		if (OutOffsetPolygon.IsEmpty())
+		{
+			OutIndexToOffsetIndex[i] = 0;
+		}
+		else
+		{
+			OutIndexToOffsetIndex[i] = OutOffsetPolygon.Num() - 1;
+		}
+	}
+}
+
+FVector2D PolygonOffset::GetIntersection(FVector2D Point1, FVector2D Direction1, FVector2D Point2, FVector2D Direction2)
+{
+	// Point1.X + t * Direction1.X = Point2.X + t' * Direction2.X
+	// Point1.Y + t * Direction1.Y = Point2.Y + t' * Direction2.Y
+
+	// t * Direction1.X - t' * Direction2.X = Point2.X - Point1.X
+	// t * Direction1.Y - t' * Direction2.Y = Point2.Y - Point1.Y
+
+	double Det = -Direction1.X * Direction2.Y + Direction1.Y * Direction2.X;
+
+	FVector2D Intersection;
+
+	if (FMath::IsNearlyEqual(Det, 0, MILLIMETER))
+	{
+		Intersection = Point2;
+	}
+	else
+	{
+		double Num = -(Point2.X - Point1.X) * Direction2.Y + (Point2.Y - Point1.Y) * Direction2.X;
+		double t = Num / Det;
+		Intersection = Point1 + t * Direction1;
+	}
+
+	return Intersection;
+}
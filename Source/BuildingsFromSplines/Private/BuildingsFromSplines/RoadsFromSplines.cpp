@@ -6,9 +6,11 @@
 #include "OSMUserData/OSMUserData.h"
 #include "LCCommon/LCBlueprintLibrary.h"
 #include "LandscapeUtils/LandscapeUtils.h"
+#include "LandscapeUtils/HeightSampler.h"
 #include "ConcurrencyHelpers/Concurrency.h"
 #include "ConcurrencyHelpers/LCReporter.h"
 
+#include "Async/ParallelFor.h"
 #include "Components/SplineMeshComponent.h"
 #include "Logging/StructuredLog.h"
 #include "Kismet/GameplayStatics.h"
@@ -21,6 +23,18 @@
 
 #define LOCTEXT_NAMESPACE "FBuildingsFromSplinesModule"
 
+namespace
+{
+	struct FRoadSegment
+	{
+		USplineComponent* SplineComponent = nullptr;
+		FVector StartLocal, StartTangentLocal, EndLocal, EndTangentLocal;
+		FVector StartTangentWorld, EndTangentWorld;
+		float StartRoll = 0;
+		float EndRoll = 0;
+	};
+}
+
 ARoadsFromSplines::ARoadsFromSplines()
 {
 	PrimaryActorTick.bCanEverTick = false;
@@ -88,81 +102,118 @@ bool ARoadsFromSplines::GenerateRoads(bool bIsUserInitiated)
 		}
 	}
 
-	for (TObjectPtr<USplineComponent> SplineComponent: SplineComponents)
+	// when the roads are placed on a single landscape, normals are computed from its heightmap instead of using line traces
+	HeightSampler Sampler(World, CollisionQueryParams);
+	if (bAdaptSplineMeshRollToLandscape)
 	{
-		if (!IsValid(SplineComponent)) continue;
-	
-		AlreadyHandledSplines.Add(SplineComponent);
+		Concurrency::RunOnGameThreadAndWait([&]() {
+			return Sampler.UseLandscapeHeightmap(Cast<ALandscape>(LandscapeSelection.GetActor(World)));
+		});
+	}
 
-		const int32 NumPoints = SplineComponent->GetNumberOfSplinePoints();
+	/* Read the spline points on the game thread, in a single pass */
 
-		TArray<FVector> LandscapeNormals;
-		if (bAdaptSplineMeshRollToLandscape)
+	TArray<FRoadSegment> Segments;
+	TArray<FVector2D> PointLocations;
+	TArray<int32> SegmentPoints; // index in PointLocations of the start point of each segment
+
+	Concurrency::RunOnGameThreadAndWait([&]() {
+		TRACE_CPUPROFILER_EVENT_SCOPE_STR("ARoadsFromSplines::ReadSplines");
+
+		const FTransform &ParentTransform = GetActorTransform();
+		for (TObjectPtr<USplineComponent> SplineComponent: SplineComponents)
 		{
-			LandscapeNormals.SetNum(NumPoints);
+			if (!IsValid(SplineComponent)) continue;
+
+			AlreadyHandledSplines.Add(SplineComponent);
+
+			const int32 NumPoints = SplineComponent->GetNumberOfSplinePoints();
+			const int32 FirstPoint = PointLocations.Num();
 			for (int32 i = 0; i < NumPoints; i++)
 			{
-				FVector PointLocationWorld = SplineComponent->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World);
-				FVector StartLocation = FVector(PointLocationWorld.X, PointLocationWorld.Y, HALF_WORLD_MAX);
-				FVector EndLocation = FVector(PointLocationWorld.X, PointLocationWorld.Y, -HALF_WORLD_MAX);
-
-				FHitResult HitResult;
-				bool bLineTrace = World->LineTraceSingleByChannel(
-					OUT HitResult,
-					StartLocation,
-					EndLocation,
-					ECollisionChannel::ECC_Visibility,
-					CollisionQueryParams
-				);
-
-				if (bLineTrace) LandscapeNormals[i] = HitResult.Normal;
+				PointLocations.Add(FVector2D(SplineComponent->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World)));
+			}
+
+			for (int32 i = 0; i < NumPoints - 1; i++)
+			{
+				FRoadSegment &Segment = Segments.AddDefaulted_GetRef();
+				Segment.SplineComponent = SplineComponent;
+				Segment.StartTangentWorld = SplineComponent->GetTangentAtSplinePoint(i, ESplineCoordinateSpace::World);
+				Segment.EndTangentWorld = SplineComponent->GetTangentAtSplinePoint(i + 1, ESplineCoordinateSpace::World);
+				Segment.StartLocal = ParentTransform.InverseTransformPosition(SplineComponent->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World));
+				Segment.EndLocal = ParentTransform.InverseTransformPosition(SplineComponent->GetLocationAtSplinePoint(i + 1, ESplineCoordinateSpace::World));
+				Segment.StartTangentLocal = ParentTransform.InverseTransformVector(Segment.StartTangentWorld);
+				Segment.EndTangentLocal = ParentTransform.InverseTransformVector(Segment.EndTangentWorld);
+				Segment.StartLocal.Z += ZOffset;
+				Segment.EndLocal.Z += ZOffset;
+				SegmentPoints.Add(FirstPoint + i);
 			}
 		}
+		return true;
+	});
 
-		for (int32 i = 0; i < NumPoints-1; i++)
+	UE_LOG(LogBuildingsFromSplines, Log, TEXT("Generating %d road segments"), Segments.Num());
+
+	/* Compute the roll of the segments off the game thread */
+
+	if (bAdaptSplineMeshRollToLandscape)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE_STR("ARoadsFromSplines::ComputeRolls");
+
+		TArray<FVector> LandscapeNormals;
+		TArray<bool> Hits;
+		Sampler.GetNormals(PointLocations, LandscapeNormals, Hits);
+
+		ParallelFor(Segments.Num(), [&](int32 i)
 		{
-			FVector StartWorld = SplineComponent->GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World);
-			FVector StartTangentWorld = SplineComponent->GetTangentAtSplinePoint(i, ESplineCoordinateSpace::World);
-			FVector EndWorld = SplineComponent->GetLocationAtSplinePoint(i + 1, ESplineCoordinateSpace::World);
-			FVector EndTangentWorld = SplineComponent->GetTangentAtSplinePoint(i + 1, ESplineCoordinateSpace::World);
-
-			const FTransform& ParentTransform = GetActorTransform();
-			FVector StartLocal = ParentTransform.InverseTransformPosition(StartWorld);
-			FVector StartTangentLocal = ParentTransform.InverseTransformVector(StartTangentWorld);
-			FVector EndLocal = ParentTransform.InverseTransformPosition(EndWorld);
-			FVector EndTangentLocal = ParentTransform.InverseTransformVector(EndTangentWorld);
-			StartLocal.Z += ZOffset;
-			EndLocal.Z += ZOffset;
-
-			if (!Concurrency::RunOnGameThreadAndWait([&]() {
-				if (!IsValid(GetWorld()) || !IsValid(RootComponent)) return false;
+			FRoadSegment &Segment = Segments[i];
+			const int32 StartPoint = SegmentPoints[i];
+			const int32 EndPoint = StartPoint + 1;
+
+			if (Hits[StartPoint] && !LandscapeNormals[StartPoint].IsZero())
+			{
+				float MaxRoll = FMath::Acos(LandscapeNormals[StartPoint].Z);
+				FVector TiltAxis = FVector::CrossProduct(LandscapeNormals[StartPoint], FVector::UpVector).GetSafeNormal();
+				float Factor = FVector::DotProduct(Segment.StartTangentWorld.GetSafeNormal(), TiltAxis);
+				Segment.StartRoll = MaxRoll * Factor;
+			}
+
+			if (Hits[EndPoint] && !LandscapeNormals[EndPoint].IsZero())
+			{
+				float MaxRoll = FMath::Acos(LandscapeNormals[EndPoint].Z);
+				FVector TiltAxis = FVector::CrossProduct(LandscapeNormals[EndPoint], FVector::UpVector).GetSafeNormal();
+				float Factor = FVector::DotProduct(Segment.EndTangentWorld.GetSafeNormal(), TiltAxis);
+				Segment.EndRoll = MaxRoll * Factor;
+			}
+		});
+	}
+
+	/* Create the spline mesh components on the game thread, in batches */
+
+	const int32 BatchSize = 1024;
+	for (int32 BatchStart = 0; BatchStart < Segments.Num(); BatchStart += BatchSize)
+	{
+		const int32 BatchEnd = FMath::Min(BatchStart + BatchSize, Segments.Num());
+
+		if (!Concurrency::RunOnGameThreadAndWait([&]() {
+			TRACE_CPUPROFILER_EVENT_SCOPE_STR("ARoadsFromSplines::CommitSegments");
+
+			if (!IsValid(GetWorld()) || !IsValid(RootComponent)) return false;
+
+			for (int32 i = BatchStart; i < BatchEnd; i++)
+			{
+				const FRoadSegment &Segment = Segments[i];
+
 				USplineMeshComponent* SplineMeshComponent = NewObject<USplineMeshComponent>(RootComponent);
 				if (!IsValid(SplineMeshComponent)) return false;
 				SplineMeshComponent->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
 				SplineMeshComponent->SetStaticMesh(RoadMesh);
 				SplineMeshComponent->SetForwardAxis(RoadMeshAxis, false);
-				SplineMeshComponent->SetStartAndEnd(StartLocal, StartTangentLocal, EndLocal, EndTangentLocal, false);
+				SplineMeshComponent->SetStartAndEnd(Segment.StartLocal, Segment.StartTangentLocal, Segment.EndLocal, Segment.EndTangentLocal, false);
 				SplineMeshComponent->SetStartScale(FVector2D(WidthScale, HeightScale), false);
 				SplineMeshComponent->SetEndScale(FVector2D(WidthScale, HeightScale), false);
-
-				if (bAdaptSplineMeshRollToLandscape)
-				{
-					if (!LandscapeNormals[i].IsZero())
-					{
-						float MaxRoll = FMath::Acos(LandscapeNormals[i].Z);
-						FVector TiltAxis = FVector::CrossProduct(LandscapeNormals[i], FVector::UpVector).GetSafeNormal();
-						float Factor = FVector::DotProduct(StartTangentWorld.GetSafeNormal(), TiltAxis);
-						SplineMeshComponent->SetStartRoll(MaxRoll * Factor, false);
-					}
-
-					if (!LandscapeNormals[i+1].IsZero())
-					{
-						float MaxRoll = FMath::Acos(LandscapeNormals[i+1].Z);
-						FVector TiltAxis = FVector::CrossProduct(LandscapeNormals[i+1], FVector::UpVector).GetSafeNormal();
-						float Factor = FVector::DotProduct(EndTangentWorld.GetSafeNormal(), TiltAxis);
-						SplineMeshComponent->SetEndRoll(MaxRoll * Factor, false);
-					}
-				}
+				SplineMeshComponent->SetStartRoll(Segment.StartRoll, false);
+				SplineMeshComponent->SetEndRoll(Segment.EndRoll, false);
 
 				SplineMeshComponent->SetCollisionProfileName("BlockAll");
 				SplineMeshComponent->MarkRenderStateDirty();
@@ -171,19 +222,18 @@ bool ARoadsFromSplines::GenerateRoads(bool bIsUserInitiated)
 				AddInstanceComponent(SplineMeshComponent);
 				SplineMeshComponents.Add(SplineMeshComponent);
 				
-				OnSplineMeshCreated(SplineComponent, SplineMeshComponent);
-				return true;
-			}))
-			{
-				return false;
+				OnSplineMeshCreated(Segment.SplineComponent, SplineMeshComponent);
 			}
+			return true;
+		}))
+		{
+			return false;
 		}
 	}
 
 	return true;
 }
 
-
 #if WITH_EDITOR
 
 AActor *ARoadsFromSplines::Duplicate(FName FromName, FName ToName)
@@ -4,12 +4,14 @@
 
 #include "BuildingsFromSplines/BuildingConfiguration.h"
 #include "LCCommon/LCGenerator.h"
+#include "LCCommon/CollisionResolver.h"
 #include "ConcurrencyHelpers/LCReporter.h"
 
 #include "Components/SplineComponent.h"
 #include "Components/SplineMeshComponent.h"
 #include "Components/DynamicMeshComponent.h"
 #include "Components/InstancedStaticMeshComponent.h"
+#include "DynamicMesh/DynamicMesh3.h"
 #include "SegmentTypes.h"
 #include "GameFramework/Volume.h"
 
@@ -77,6 +79,19 @@ public:
 
 	bool GenerateBuilding_Internal(FName SpawnedActorsPathOverride);
 
+	/* The generation of a building is split in three phases, so that the geometry of many buildings can be computed in parallel:
+	 * PrepareGeneration and CommitGeneration must be called on the game thread, while GenerateGeometry can be called from any thread.
+	 * PrepareGeneration copies everything that GenerateGeometry needs from the components, and GenerateGeometry only builds
+	 * a FDynamicMesh3, without creating objects or touching components.
+	 * CommitGeneration moves the generated mesh to the DynamicMeshComponent, and adds the materials, attachments and collisions.
+	 * Pushing the building out of collision is left to the caller, so that the buildings of a batch are resolved together. */
+	bool PrepareGeneration();
+	bool GenerateGeometry();
+	bool CommitGeneration(FName SpawnedActorsPathOverride);
+
+	/* Outer footprint of the building in world space, used to push it out of collision */
+	FCollisionFootprint GetCollisionFootprint();
+
 	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Building",
 		meta = (DisplayPriority = "100")
 	)
@@ -98,6 +113,7 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Building")
 	bool AppendBuilding(UDynamicMesh* TargetMesh, FName SpawnedActorsPathOverride);
 
+	/* Must be called on the game thread, as it reads the spline component */
 	void ComputeMinMaxHeight();
 
 	UFUNCTION()
@@ -105,11 +121,19 @@ public:
 
 protected:
 	double LastFloorExternalWallThickness = 0;
+	double ExtraWallBottom = 0;
 	double LevelsHeightsSum = 0;
 	UDataTable *LevelsTable;
 	UDataTable *WallSegmentsTable;
 	TArray<FString> ExpandedLevelDescriptionsKeys;
 
+	// the configuration can be shared by several buildings generated in parallel,
+	// so the values drawn for this building are kept here instead of in the configuration
+	int BuildingNumFloors = 0;
+	TArray<FString> MaterialNamesArray;
+	TArray<TObjectPtr<UMaterialInterface>> MaterialsArray;
+	int ResolveMaterial(const FString &ExprStr) const;
+
 	TArray<TArray<TArray<UWallSegment*>>> WallSegmentsAtFloorAndSplinePoint;
 	TArray<TArray<double>> FillersSizeAtFloorAndSplinePoint;
 	bool InitializeWallSegments();
@@ -120,6 +144,9 @@ protected:
 	
 	UPROPERTY()
 	bool bIsGenerating = false;
+
+	/* Mesh filled by GenerateGeometry, and moved to the DynamicMeshComponent by CommitGeneration */
+	FDynamicMesh3 GeneratedMesh;
 	
 	/* Holds a pointer to the volume generated by this actor. We destroy the volume when generating a new one. */
 	UPROPERTY(
@@ -147,40 +174,57 @@ protected:
 	// and there are subdivisions (depending on the WallSubdivions property of the BuildingConfiguration)
 	// and the points are clockwise (when seen from above in Unreal, which isn't the same as clockwise in TPolygon2
 	// because of inverted Y-axis)
+	// it is only filled by CommitGeneration, for the attachments, while the geometry uses BaseVertices2D
 	UPROPERTY(VisibleAnywhere, Category = "Building")
 	TObjectPtr<USplineComponent> BaseClockwiseSplineComponent;
-	TArray<FTransform> BaseClockwiseFrames;
-	TArray<double> BaseClockwiseFramesTimes;
+	void UpdateBaseClockwiseSplineComponent();
+
+	// points of BaseClockwiseSplineComponent, from which the wall, floor and roof polygons are offset
 	TArray<FVector2D> BaseVertices2D;
 
+	// distance along the base polygon at each of its vertices, with an extra entry for the length of the polygon
+	TArray<double> BaseClockwiseDistances;
+	double GetBaseLength() const;
+	FVector2D GetBaseLocationAtDistance(double Distance) const;
+
+	// copied from SplineComponent by ComputeBaseVertices
+	int SplineNumPoints = 0;
+	bool bSplineIsClosedLoop = true;
+
 	// these three maps contain the shifted polygons, one entry per thickness given in the user's BuildingConfiguration
 	TMap<double, TArray<FVector2D>> InternalWallPolygons;
 	TMap<double, TArray<FVector2D>> ExternalWallPolygons;
 	TMap<double, TArray<int>> IndexToInternalIndex;
+	/* Must be called on the game thread, as it reads the spline component */
 	void ComputeBaseVertices();
 	void AddInternalThickness(double Thickness);
 	void AddExternalThickness(double Thickness);
 
 	TMap<UStaticMesh*, UInstancedStaticMeshComponent*> MeshToISM;
-	FVector2D GetIntersection(FVector2D Point1, FVector2D Direction1, FVector2D Point2, FVector2D Direction2);
-	void DeflateFrames(TArray<FTransform> Frames, TArray<FVector2D>& OutOffsetPolygon, TArray<int>& OutIndexToOffsetIndex, double Offset);
 
 	TArray<int> SplineIndexToBaseSplineIndex;
 	void ComputeOffsetPolygons();
 	TArray<FVector2D> MakePolygon(bool bInternalWall, double BeginDistance, double Length, double Thickness);
-	FVector2D GetShiftedPoint(TArray<FTransform> Frames, int Index, double Shift, bool bIsLoop);
 
-	bool AppendWallsWithHoles(UDynamicMesh* TargetMesh, bool bInternalWall, double ZOffset, int FloorIndex, ULevelDescription* LevelDescription);
-	bool AppendWallsWithHoles(UDynamicMesh* TargetMesh);
+	bool AppendWallsWithHoles(FDynamicMesh3 &TargetMesh, bool bInternalWall, double ZOffset, int FloorIndex, ULevelDescription* LevelDescription);
+	bool AppendWallsWithHoles(FDynamicMesh3 &TargetMesh);
 	void AddSplineMesh(UStaticMesh* StaticMesh, double BeginDistance, double Length, double Thickness, double Height, FVector Offset, ESplineMeshAxis::Type SplineMeshAxis);
-	void AppendAlongSpline(UDynamicMesh* TargetMesh, bool bInternalWall, double BeginDistance, double Length, double Height, double ZOffset, double Thickness, int MaterialID);
-	void AppendRoof(UDynamicMesh* TargetMesh);
-	bool AppendFloors(UDynamicMesh *TargetMesh);
-	void AppendBuildingStructure(UDynamicMesh* TargetMesh);
-	bool AppendBuildingWithoutInside(UDynamicMesh *TargetMesh);
+	void AppendAlongSpline(FDynamicMesh3 &TargetMesh, bool bInternalWall, double BeginDistance, double Length, double Height, double ZOffset, double Thickness, int MaterialID);
+	void AppendRoof(FDynamicMesh3 &TargetMesh);
+	bool AppendFloors(FDynamicMesh3 &TargetMesh);
+	void AppendBuildingStructure(FDynamicMesh3 &TargetMesh);
+	bool AppendBuildingGeometry(FDynamicMesh3 &TargetMesh);
+	bool AddBuildingComponents(FName SpawnedActorsPathOverride);
+	bool AppendBuildingWithoutInside(FDynamicMesh3 &TargetMesh);
 	
+	/* Attachments are drawn from a random stream seeded from the building spline, so that regenerating
+	 * a building gives the same attachments. Instanced meshes are collected per mesh and added in bulk. */
 	bool AddAttachments();
-	bool AddAttachments(int FloorIndex, ULevelDescription* LevelDescription, double ZOffset);
+	bool AddAttachments(
+		int FloorIndex, ULevelDescription* LevelDescription, double ZOffset,
+		const FRandomStream &RandomStream, TMap<UStaticMesh*, TArray<FTransform>> &OutInstances
+	);
+	int32 GetAttachmentsSeed() const;
 
 };
 
@@ -61,6 +61,13 @@ struct FWeightedObject
 		if (0 <= Index && Index < Objects.Num()) return Objects[Index].Object;
 		else return nullptr;
 	}
+
+	static TObjectPtr<UObject> GetRandomObject(const TArray<FWeightedObject>& Objects, const FRandomStream &RandomStream)
+	{
+		int Index = ULCBlueprintLibrary::GetRandomIndex<FWeightedObject>(Objects, RandomStream);
+		if (0 <= Index && Index < Objects.Num()) return Objects[Index].Object;
+		else return nullptr;
+	}
 };
 
 
@@ -473,10 +480,8 @@ public:
 	)
 	TMap<FString, TObjectPtr<UMaterialInterface>> Materials;
 
-	TArray<FString> MaterialNamesArray;
-	TArray<TObjectPtr<UMaterialInterface>> MaterialsArray;
-
-	int ResolveMaterial(FString ExprStr);
+	/* Index in MaterialNames of the material chosen by the expression, or 0 */
+	int ResolveMaterial(FString ExprStr, const TArray<FString> &MaterialNames) const;
 
 	UPROPERTY(
 		EditAnywhere, BlueprintReadWrite, Category = "Building|Materials",
@@ -626,23 +631,34 @@ public:
 	)
 	bool bEnableNanite = true;
 
-	/* Whether the generated building can receive decals. */
+	/* Identical buildings (for instance rows of terraced houses) share the same static mesh asset, which is named after
+	 * the hash of their footprint and of this configuration. Footprints are compared whatever their rotation and their
+	 * start point (when all levels reset their wall segments on corners), but mirrored footprints get different assets.
+	 * This avoids building and saving one asset per building. */
 	UPROPERTY(
 		EditAnywhere, BlueprintReadWrite, Category = "Building|Conversions",
 		meta = (EditCondition = "bConvertToStaticMesh", EditConditionHides, DisplayPriority = "2")
 	)
+	bool bShareIdenticalStaticMeshes = true;
+
+	/* Whether the generated building can receive decals. */
+	UPROPERTY(
+		EditAnywhere, BlueprintReadWrite, Category = "Building|Conversions",
+		meta = (EditCondition = "bConvertToStaticMesh", EditConditionHides, DisplayPriority = "3")
+	)
 	bool bBuildingReceiveDecals = false;
 
 	/* Convert to volume after the building is generated. */
 	UPROPERTY(
 		EditAnywhere, BlueprintReadWrite, Category = "Building|Conversions",
-		meta = (DisplayPriority = "3")
+		meta = (DisplayPriority = "4")
 	)
 	bool bConvertToVolume = false;
 
 
+	/* Number of floors from the OSM fields of the building, without modifying the configuration which can be shared */
 	UFUNCTION()
-	bool AutoComputeNumFloors(UOSMUserData *BuildingOSMUserData);
+	bool AutoComputeNumFloors(UOSMUserData *BuildingOSMUserData, int &OutNumFloors) const;
 
 };
 
@@ -134,7 +134,8 @@ public:
 
 protected:
 
-	bool GenerateBuilding(USplineComponent* SplineComponent, FName SpawnedActorsPathOverride, bool bIsUserInitiated);
+	/* Spawns a building for the given spline component, without generating it. Must be called on the game thread. */
+	ABuilding* SpawnBuilding(USplineComponent* SplineComponent, FName SpawnedActorsPathOverride);
 	TSet<USplineComponent*> ProcessedSplines;
 };
 
@@ -0,0 +1,41 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DynamicMesh/DynamicMesh3.h"
+
+using namespace UE::Geometry;
+
+/* Geometry functions used to build buildings, working on FDynamicMesh3 instead of UDynamicMesh so that they
+ * can be called from any thread. They behave like their Geometry Script counterparts with default options. */
+class BUILDINGSFROMSPLINES_API MeshFunctions
+{
+public:
+	/* Extrudes the polygon along Z, with one polygroup per face, and caps */
+	static void AppendSimpleExtrudePolygon(FDynamicMesh3 &TargetMesh, const FTransform &Transform, const TArray<FVector2D> &Polygon, double Height);
+
+	/* Sweeps the polyline along the path, the polyline coordinates being the Y and Z coordinates in the frames of the path */
+	static void AppendSweepPolyline(
+		FDynamicMesh3 &TargetMesh, const TArray<FVector2D> &Polyline, const TArray<FTransform> &SweepPath,
+		bool bLoop, bool bFlipOrientation
+	);
+
+	static void AppendMesh(FDynamicMesh3 &TargetMesh, const FDynamicMesh3 &Mesh, const FTransform &Transform);
+
+	/* Polygroup IDs in the order in which they first appear in the triangles */
+	static TArray<int> GetPolygroupIDs(const FDynamicMesh3 &Mesh);
+
+	static void SetPolygroupMaterialID(FDynamicMesh3 &Mesh, int PolygroupID, int MaterialID);
+	static void RemapMaterialIDs(FDynamicMesh3 &Mesh, int FromMaterialID, int ToMaterialID);
+
+	static void SetUVsFromBoxProjection(FDynamicMesh3 &Mesh, const FTransform &BoxTransform);
+	static void ScaleUVs(FDynamicMesh3 &Mesh, const FVector2D &Scale);
+	static void AutoGenerateXAtlasUVs(FDynamicMesh3 &Mesh);
+
+	/* Normals split at edges with an opening angle larger than 15 degrees */
+	static void ComputeSplitNormals(FDynamicMesh3 &Mesh);
+
+private:
+	static FDynamicMeshMaterialAttribute* GetOrEnableMaterialIDs(FDynamicMesh3 &Mesh);
+};
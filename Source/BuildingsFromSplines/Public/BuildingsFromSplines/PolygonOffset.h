@@ -0,0 +1,29 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/* Offsets the clockwise polygons of buildings (walls, floors and roofs), positive offsets moving the vertices inside.
+ * Each vertex is moved to the intersection of its two shifted edges, so that the offset polygon keeps the vertices
+ * in the same order as the original polygon, and indices can be mapped from one polygon to the other. */
+class BUILDINGSFROMSPLINES_API PolygonOffset
+{
+public:
+	static FVector2D GetShiftedPoint(const TArray<FVector2D> &Polygon, int Index, double Offset, bool bIsLoop);
+
+	/* Shifts all the vertices of Polygon, in O(n) */
+	static void Shift(const TArray<FVector2D> &Polygon, double Offset, TArray<FVector2D> &OutOffsetPolygon);
+
+	/* Shifts all the vertices of Polygon, and drops the vertices that end up closer than Offset to an edge of Boundary,
+	 * which happens where the polygon is thinner than twice the offset and the offset polygon folds onto itself.
+	 * OutIndexToOffsetIndex[i] is the index in OutOffsetPolygon of the last vertex that was kept up to vertex i (or 0).
+	 * The edges of Boundary are bucketed in a uniform grid, so that each vertex is only checked against the edges
+	 * of the cells around it instead of all the edges of Boundary. */
+	static void Deflate(
+		const TArray<FVector2D> &Polygon, const TArray<FVector2D> &Boundary, double Offset,
+		TArray<FVector2D> &OutOffsetPolygon, TArray<int> &OutIndexToOffsetIndex
+	);
+
+	static FVector2D GetIntersection(FVector2D Point1, FVector2D Direction1, FVector2D Point2, FVector2D Direction2);
+};
@@ -16,7 +16,10 @@ void Concurrency::RunAsync(TFunction<void()> Action)
 	return;
 }
 
-void Concurrency::RunMany(int n, TFunction<void( int i, TFunction<void(bool)> )> Action, TFunction<void(bool)> OnComplete)
+void Concurrency::RunMany(
+	int n, TFunction<void( int i, TFunction<void(bool)> )> Action, TFunction<void(bool)> OnComplete,
+	EConcurrencyResource Resource, TSharedPtr<LCCancellationToken> Cancellation
+)
 {
 	TArray<int> Elements;
 	Elements.Reserve(n);
@@ -24,10 +27,13 @@ void Concurrency::RunMany(int n, TFunction<void( int i, TFunction<void(bool)> )>
 	{
 		Elements.Add(i);
 	}
-	RunMany(Elements, Action, OnComplete);
+	RunMany(Elements, Action, OnComplete, Resource, Cancellation);
 }
 
-bool Concurrency::RunManyAndWait(bool bEnableParallelDownload, int n, TFunction<bool( int i )> Action)
+bool Concurrency::RunManyAndWait(
+	bool bEnableParallelDownload, int n, TFunction<bool( int i )> Action,
+	EConcurrencyResource Resource, LCCancellationToken *Cancellation
+)
 {
 	if (bEnableParallelDownload)
 	{
@@ -37,12 +43,13 @@ bool Concurrency::RunManyAndWait(bool bEnableParallelDownload, int n, TFunction<
 		{
 			Elements.Add(i);
 		}
-		return RunManyAndWait(Elements, Action);
+		return RunManyAndWait(Elements, Action, Resource, Cancellation);
 	}
 	else
 	{
 		for (int i = 0; i < n; i++)
 		{
+			if (Cancellation && Cancellation->IsCancelled()) return false;
 			if (!Action(i)) return false;
 		}
 		return true;
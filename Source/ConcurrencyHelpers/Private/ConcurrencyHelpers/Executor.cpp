@@ -0,0 +1,289 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#include "ConcurrencyHelpers/Executor.h"
+#include "ConcurrencyHelpers/LogConcurrencyHelpers.h"
+
+#include "Containers/Deque.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
+
+#include <condition_variable>
+#include <mutex>
+
+namespace
+{
+	class FExecutorPool;
+
+	thread_local FExecutorPool* CurrentPool = nullptr;
+	thread_local int32 CurrentWorkerIndex = INDEX_NONE;
+
+	const TCHAR* ResourceName(EConcurrencyResource Resource)
+	{
+		switch (Resource)
+		{
+			case EConcurrencyResource::Network: return TEXT("Network");
+			case EConcurrencyResource::DiskIO: return TEXT("DiskIO");
+			case EConcurrencyResource::CPU: return TEXT("CPU");
+			default: return TEXT("Unknown");
+		}
+	}
+
+	/* Counts the tasks submitted to a pool, workers sleep on it when there is nothing to do */
+	class FTaskSemaphore
+	{
+	public:
+		void Release()
+		{
+			{
+				std::lock_guard<std::mutex> Lock(Mutex);
+				Count++;
+			}
+			Condition.notify_one();
+		}
+
+		void ReleaseAll(int32 N)
+		{
+			{
+				std::lock_guard<std::mutex> Lock(Mutex);
+				Count += N;
+			}
+			Condition.notify_all();
+		}
+
+		void Acquire()
+		{
+			std::unique_lock<std::mutex> Lock(Mutex);
+			Condition.wait(Lock, [this]() { return Count > 0; });
+			Count--;
+		}
+
+	private:
+		std::mutex Mutex;
+		std::condition_variable Condition;
+		int64 Count = 0;
+	};
+
+	struct FWorkerQueue
+	{
+		FCriticalSection Lock;
+
+		// the owner of the queue pushes and pops at the end, thieves take the oldest tasks at the beginning
+		TDeque<TFunction<void()>> Tasks;
+	};
+
+	class FExecutorWorker : public FRunnable
+	{
+	public:
+		FExecutorWorker(FExecutorPool* Pool0, int32 Index0) :
+			Pool(Pool0), Index(Index0) {};
+
+		uint32 Run() override;
+
+	private:
+		FExecutorPool* Pool;
+		int32 Index;
+	};
+
+	class FExecutorPool
+	{
+	public:
+		FExecutorPool(EConcurrencyResource Resource, int32 NumWorkers)
+		{
+			UE_LOG(LogConcurrencyHelpers, Log, TEXT("Starting %d workers for %s tasks"), NumWorkers, ResourceName(Resource));
+
+			for (int32 i = 0; i < NumWorkers; i++)
+			{
+				Queues.Add(MakeUnique<FWorkerQueue>());
+			}
+
+			for (int32 i = 0; i < NumWorkers; i++)
+			{
+				Workers.Add(MakeUnique<FExecutorWorker>(this, i));
+				Threads.Add(FRunnableThread::Create(Workers[i].Get(), *FString::Printf(TEXT("LCExecutor_%s_%d"), ResourceName(Resource), i)));
+			}
+		}
+
+		~FExecutorPool()
+		{
+			bStopping = true;
+			Semaphore.ReleaseAll(Threads.Num());
+
+			for (FRunnableThread* Thread : Threads)
+			{
+				if (Thread)
+				{
+					Thread->WaitForCompletion();
+					delete Thread;
+				}
+			}
+		}
+
+		int32 NumWorkers() const
+		{
+			return Queues.Num();
+		}
+
+		void Submit(TFunction<void()> Task)
+		{
+			// tasks submitted by a worker go to its own queue, where they are likely to be run by the same worker
+			const int32 QueueIndex = CurrentPool == this ? CurrentWorkerIndex : (NextQueue++ % Queues.Num());
+
+			{
+				FScopeLock Lock(&Queues[QueueIndex]->Lock);
+				Queues[QueueIndex]->Tasks.PushLast(MoveTemp(Task));
+			}
+
+			Semaphore.Release();
+		}
+
+		bool TryRunOne(int32 WorkerIndex)
+		{
+			TFunction<void()> Task;
+
+			{
+				FWorkerQueue &OwnQueue = *Queues[WorkerIndex];
+				FScopeLock Lock(&OwnQueue.Lock);
+				if (!OwnQueue.Tasks.IsEmpty())
+				{
+					Task = MoveTemp(OwnQueue.Tasks.Last());
+					OwnQueue.Tasks.PopLast();
+				}
+			}
+
+			for (int32 Offset = 1; !Task && Offset < Queues.Num(); Offset++)
+			{
+				FWorkerQueue &Victim = *Queues[(WorkerIndex + Offset) % Queues.Num()];
+				FScopeLock Lock(&Victim.Lock);
+				if (!Victim.Tasks.IsEmpty())
+				{
+					Task = MoveTemp(Victim.Tasks.First());
+					Victim.Tasks.PopFirst();
+				}
+			}
+
+			if (!Task) return false;
+
+			Task();
+			return true;
+		}
+
+		void WorkerLoop(int32 WorkerIndex)
+		{
+			CurrentPool = this;
+			CurrentWorkerIndex = WorkerIndex;
+
+			while (true)
+			{
+				Semaphore.Acquire();
+
+				if (bStopping)
+				{
+					while (TryRunOne(WorkerIndex)) {}
+					break;
+				}
+
+				TryRunOne(WorkerIndex);
+			}
+
+			CurrentPool = nullptr;
+			CurrentWorkerIndex = INDEX_NONE;
+		}
+
+	private:
+		TArray<TUniquePtr<FWorkerQueue>> Queues;
+		TArray<TUniquePtr<FExecutorWorker>> Workers;
+		TArray<FRunnableThread*> Threads;
+		FTaskSemaphore Semaphore;
+		std::atomic<uint32> NextQueue = 0;
+		std::atomic<bool> bStopping = false;
+	};
+
+	uint32 FExecutorWorker::Run()
+	{
+		Pool->WorkerLoop(Index);
+		return 0;
+	}
+
+	FCriticalSection PoolsLock;
+	TUniquePtr<FExecutorPool> Pools[(int32) EConcurrencyResource::Num];
+	int32 MaxConcurrencies[(int32) EConcurrencyResource::Num] = { 0 };
+
+	FExecutorPool& GetPool(EConcurrencyResource Resource)
+	{
+		FScopeLock Lock(&PoolsLock);
+
+		TUniquePtr<FExecutorPool> &Pool = Pools[(int32) Resource];
+		if (!Pool)
+		{
+			Pool = MakeUnique<FExecutorPool>(Resource, Executor::GetMaxConcurrency(Resource));
+		}
+		return *Pool;
+	}
+}
+
+void Executor::Submit(EConcurrencyResource Resource, TFunction<void()> Task)
+{
+	GetPool(Resource).Submit(MoveTemp(Task));
+}
+
+bool Executor::TryRunPendingTask()
+{
+	if (!CurrentPool) return false;
+	return CurrentPool->TryRunOne(CurrentWorkerIndex);
+}
+
+bool Executor::IsWorkerThread()
+{
+	return CurrentPool != nullptr;
+}
+
+void Executor::SetMaxConcurrency(EConcurrencyResource Resource, int32 MaxConcurrency)
+{
+	FScopeLock Lock(&PoolsLock);
+	MaxConcurrencies[(int32) Resource] = MaxConcurrency;
+
+	TUniquePtr<FExecutorPool> &Pool = Pools[(int32) Resource];
+	if (Pool && Pool->NumWorkers() != GetMaxConcurrency(Resource))
+	{
+		UE_LOG(LogConcurrencyHelpers, Log, TEXT("The concurrency of %s tasks will change the next time its workers are started"), ResourceName(Resource));
+	}
+}
+
+int32 Executor::GetMaxConcurrency(EConcurrencyResource Resource)
+{
+	FScopeLock Lock(&PoolsLock);
+	const int32 MaxConcurrency = MaxConcurrencies[(int32) Resource];
+	return MaxConcurrency > 0 ? MaxConcurrency : DefaultMaxConcurrency(Resource);
+}
+
+int32 Executor::DefaultMaxConcurrency(EConcurrencyResource Resource)
+{
+	switch (Resource)
+	{
+		case EConcurrencyResource::Network: return 16;
+		case EConcurrencyResource::DiskIO: return 4;
+		default: return FMath::Max(1, FPlatformMisc::NumberOfCoresIncludingHyperthreads() - 1);
+	}
+}
+
+void Executor::Shutdown()
+{
+	TUniquePtr<FExecutorPool> PoolsToStop[(int32) EConcurrencyResource::Num];
+
+	{
+		FScopeLock Lock(&PoolsLock);
+		for (int32 i = 0; i < (int32) EConcurrencyResource::Num; i++)
+		{
+			PoolsToStop[i] = MoveTemp(Pools[i]);
+		}
+	}
+
+	// the pools are destroyed outside of the lock, as their remaining tasks might still query the executor
+	for (int32 i = 0; i < (int32) EConcurrencyResource::Num; i++)
+	{
+		PoolsToStop[i].Reset();
+	}
+}
@@ -1,5 +1,11 @@
 // Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
 
 #include "ConcurrencyHelpersModule.h"
+#include "ConcurrencyHelpers/Executor.h"
 	
 IMPLEMENT_MODULE(FConcurrencyHelpersModule, ConcurrencyHelpers)
+
+void FConcurrencyHelpersModule::ShutdownModule()
+{
+	Executor::Shutdown();
+}
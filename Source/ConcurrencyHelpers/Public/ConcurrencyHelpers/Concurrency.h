@@ -3,6 +3,7 @@
 #pragma once
 
 #include "LCReporter.h"
+#include "Executor.h"
 #include "Templates/Function.h"
 #include "Async/Async.h"
 
@@ -13,16 +14,25 @@ class CONCURRENCYHELPERS_API Concurrency
 public:
 
 	template<typename T>
-	static void RunMany(TArray<T> Elements, TFunction<void( T Element, TFunction<void(bool)> )> Action, TFunction<void(bool)> OnComplete)
+	static void RunMany(
+		TArray<T> Elements, TFunction<void( T Element, TFunction<void(bool)> )> Action, TFunction<void(bool)> OnComplete,
+		EConcurrencyResource Resource = EConcurrencyResource::CPU, TSharedPtr<LCCancellationToken> Cancellation = nullptr
+	)
 	{
 		int32 NumberOfTasks = Elements.Num();
+		if (NumberOfTasks == 0)
+		{
+			if (OnComplete) OnComplete(true);
+			return;
+		}
+
 		std::atomic<int32> *SuccessfulTasks = new std::atomic<int>(0);
 		std::atomic<int32> *FinishedTasks = new std::atomic<int>(0);
 		UE_LOG(LogTemp, Log, TEXT("Starting %d tasks asynchronously"), NumberOfTasks);
 
 		TFunction<void(bool)> OnCompleteAction = [FinishedTasks, SuccessfulTasks, NumberOfTasks, OnComplete](bool bWasSuccessful) {
-			int FinishedTasksLocal = ++(*FinishedTasks);
 			if (bWasSuccessful) (*SuccessfulTasks)++;
+			int FinishedTasksLocal = ++(*FinishedTasks);
 
 			if (FinishedTasksLocal == NumberOfTasks)
 			{
@@ -35,9 +45,10 @@ public:
 
 		for (const T& Element : Elements)
 		{
-			Async(EAsyncExecution::Thread,
-				[Element, Action, OnCompleteAction]() {
-					Action(Element, OnCompleteAction);
+			Executor::Submit(Resource,
+				[Element, Action, OnCompleteAction, Cancellation]() {
+					if (Cancellation.IsValid() && Cancellation->IsCancelled()) OnCompleteAction(false);
+					else Action(Element, OnCompleteAction);
 				}
 			);
 		}
@@ -46,16 +57,24 @@ public:
 	}
 
 	template<typename T>
-	static bool RunManyAndWait(TArray<T> Elements, TFunction<bool( T Element )> Action)
+	static bool RunManyAndWait(
+		TArray<T> Elements, TFunction<bool( T Element )> Action,
+		EConcurrencyResource Resource = EConcurrencyResource::CPU, LCCancellationToken *Cancellation = nullptr
+	)
 	{
 		TArray<int> UnusedResults;
 		return RunArrayAndWait<T, int>(Elements, UnusedResults, [Action](T Element, int &UnusedResult) {
 			return Action(Element);
-		});
+		}, Resource, Cancellation);
 	}
 
+	/* Runs Function on all elements using the executor, and waits for all of them to finish.
+	 * Tasks that have not started when Cancellation is cancelled are skipped and count as failures. */
 	template<typename A, typename B>
-	static bool RunArrayAndWait(TArray<A> Elements, TArray<B> &OutResults, TFunction<bool( A Element, B &OutResult )> Function)
+	static bool RunArrayAndWait(
+		TArray<A> Elements, TArray<B> &OutResults, TFunction<bool( A Element, B &OutResult )> Function,
+		EConcurrencyResource Resource = EConcurrencyResource::CPU, LCCancellationToken *Cancellation = nullptr
+	)
 	{
 		if (IsInGameThread())
 		{
@@ -66,33 +85,49 @@ public:
 		}
 
 		int32 NumberOfTasks = Elements.Num();
-		std::atomic<int32> *SuccessfulTasks = new std::atomic<int>(0);
-		std::atomic<int32> *FinishedTasks = new std::atomic<int>(0);
-		UE_LOG(LogTemp, Log, TEXT("Starting %d tasks in parallel"), NumberOfTasks);
-
 		OutResults.Empty(NumberOfTasks);
 		OutResults.SetNum(NumberOfTasks);
+		if (NumberOfTasks == 0) return true;
 
-		for (int i = 0; i < NumberOfTasks; i++)
+		FEvent* AllFinished = FPlatformProcess::GetSynchEventFromPool(true);
+		if (!AllFinished)
 		{
-			Async(EAsyncExecution::Thread,
-				[&Function, FinishedTasks, SuccessfulTasks, NumberOfTasks, &Elements, &OutResults, i]() {
+			LCReporter::ShowError(
+				LOCTEXT("Concurrency::RunArrayAndWaitEvent", "Failed to create sync event for Concurrency::RunArrayAndWait.")
+			);
+			return false;
+		}
 
-					if (Function(Elements[i], OutResults[i])) (*SuccessfulTasks)++;
-					(*FinishedTasks)++;
+		std::atomic<int32> SuccessfulTasks = 0;
+		std::atomic<int32> FinishedTasks = 0;
+		UE_LOG(LogTemp, Log, TEXT("Starting %d tasks in parallel"), NumberOfTasks);
+
+		for (int i = 0; i < NumberOfTasks; i++)
+		{
+			Executor::Submit(Resource,
+				[&Function, &FinishedTasks, &SuccessfulTasks, NumberOfTasks, &Elements, &OutResults, Cancellation, AllFinished, i]() {
+					const bool bCancelled = Cancellation && Cancellation->IsCancelled();
+					if (!bCancelled && Function(Elements[i], OutResults[i])) SuccessfulTasks++;
+					if (++FinishedTasks == NumberOfTasks) AllFinished->Trigger();
 				}
 			);
 		}
 
-		UE_LOG(LogTemp, Log, TEXT("Actively waiting for all %d tasks to complete"), NumberOfTasks);
-		while (*FinishedTasks < NumberOfTasks) FPlatformProcess::Sleep(0.05);
-		UE_LOG(LogTemp, Log, TEXT("Finished waiting"));
+		UE_LOG(LogTemp, Log, TEXT("Waiting for all %d tasks to complete"), NumberOfTasks);
 
-		bool bSuccess = *SuccessfulTasks == *FinishedTasks;
-		delete SuccessfulTasks;
-		delete FinishedTasks;
+		// a worker waiting for other tasks runs pending tasks itself, so that nested calls cannot exhaust the pool
+		if (Executor::IsWorkerThread())
+		{
+			while (FinishedTasks < NumberOfTasks)
+			{
+				if (!Executor::TryRunPendingTask()) AllFinished->Wait(10);
+			}
+		}
+		AllFinished->Wait();
+		FPlatformProcess::ReturnSynchEventToPool(AllFinished);
+		UE_LOG(LogTemp, Log, TEXT("Finished waiting"));
 
-		return bSuccess;
+		return SuccessfulTasks == NumberOfTasks;
 	}
 
 	
@@ -124,8 +159,14 @@ public:
 	}
 
 	static void RunAsync(TFunction<void()> Action);
-	static void RunMany(int n, TFunction<void( int i, TFunction<void(bool)> )> Action, TFunction<void(bool)> OnComplete);
-	static bool RunManyAndWait(bool bEnableParallelDownload, int n, TFunction<bool( int i )> Action);
+	static void RunMany(
+		int n, TFunction<void( int i, TFunction<void(bool)> )> Action, TFunction<void(bool)> OnComplete,
+		EConcurrencyResource Resource = EConcurrencyResource::CPU, TSharedPtr<LCCancellationToken> Cancellation = nullptr
+	);
+	static bool RunManyAndWait(
+		bool bEnableParallelDownload, int n, TFunction<bool( int i )> Action,
+		EConcurrencyResource Resource = EConcurrencyResource::Network, LCCancellationToken *Cancellation = nullptr
+	);
 	static void RunOnGameThread(TFunction<void()> Action);
 
 	static bool RunOnThreadAndWait(bool bRunOnGameThread, TFunction<bool()> Action);
@@ -0,0 +1,50 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+
+#include <atomic>
+
+/* Kind of resource mostly used by a task, each kind has its own pool of worker threads */
+enum class EConcurrencyResource : uint8
+{
+	Network,
+	DiskIO,
+	CPU,
+	Num
+};
+
+/* Shared flag used to cancel the tasks of a batch which have not started yet */
+class CONCURRENCYHELPERS_API LCCancellationToken
+{
+public:
+	void Cancel() { bCancelled = true; }
+	bool IsCancelled() const { return bCancelled; }
+
+private:
+	std::atomic<bool> bCancelled = false;
+};
+
+/* Bounded pools of worker threads shared by the whole plugin.
+ * Each worker has its own queue of tasks, and idle workers steal tasks from the other workers of their pool.
+ * Workers are started lazily, on the first task submitted to their pool. */
+class CONCURRENCYHELPERS_API Executor
+{
+public:
+	static void Submit(EConcurrencyResource Resource, TFunction<void()> Task);
+
+	/* Runs one pending task of the pool of the current thread, if the current thread is a worker.
+	 * This is used by workers that wait for other tasks, to avoid exhausting the pool. */
+	static bool TryRunPendingTask();
+	static bool IsWorkerThread();
+
+	/* Workers cannot be stopped while tasks are running, so reducing the concurrency of a started pool
+	 * only takes effect after the pool has been shut down */
+	static void SetMaxConcurrency(EConcurrencyResource Resource, int32 MaxConcurrency);
+	static int32 GetMaxConcurrency(EConcurrencyResource Resource);
+	static int32 DefaultMaxConcurrency(EConcurrencyResource Resource);
+
+	static void Shutdown();
+};
@@ -16,7 +16,7 @@ void UGlobalCoordinates::GetUnrealCoordinatesFromCRS(double Longitude, double La
 
 OGRCoordinateTransformation* UGlobalCoordinates::GetCRSTransformer(FString FromCRS)
 {
-	return GDALInterface::MakeTransform(FromCRS, CRS);
+	return GDALInterface::GetCachedTransform(FromCRS, CRS);
 }
 
 bool UGlobalCoordinates::GetUnrealCoordinatesFromCRS(double Longitude, double Latitude, FString FromCRS, FVector2D &XY)
@@ -35,6 +35,20 @@ bool UGlobalCoordinates::GetUnrealCoordinatesFromCRS(double Longitude, double La
 	return true;
 }
 
+bool UGlobalCoordinates::GetUnrealCoordinatesFromCRS(const TArray<FVector2D> &Coordinates, FString FromCRS, TArray<FVector2D> &OutXY)
+{
+	OutXY = Coordinates;
+	if (!GDALInterface::ConvertPoints(OutXY, FromCRS, CRS)) return false;
+
+	for (FVector2D &XY : OutXY)
+	{
+		XY[0] = (XY[0] - WorldOriginLong) * CmPerLongUnit;
+		XY[1] = (XY[1] - WorldOriginLat) * CmPerLatUnit;
+	}
+
+	return true;
+}
+
 bool UGlobalCoordinates::GetUnrealCoordinatesFromCRS(double Longitude, double Latitude, OGRCoordinateTransformation *CoordinateTransformation, FVector2D &XY)
 {
 	double ConvertedLongitude = Longitude;
@@ -79,6 +93,25 @@ bool UGlobalCoordinates::GetCRSCoordinatesFromUnrealLocation(FVector2D Location,
 	return GDALInterface::Transform(CoordinateTransformation, &OutCoordinates[0], &OutCoordinates[1]);
 }
 
+bool UGlobalCoordinates::GetCRSCoordinatesFromUnrealLocations(const TArray<FVector2D> &Locations, FString ToCRS, TArray<FVector2D> &OutCoordinates)
+{
+	return GetCRSCoordinatesFromUnrealLocations(Locations, GDALInterface::GetCachedTransform(CRS, ToCRS), OutCoordinates);
+}
+
+bool UGlobalCoordinates::GetCRSCoordinatesFromUnrealLocations(const TArray<FVector2D> &Locations, OGRCoordinateTransformation *CoordinateTransformation, TArray<FVector2D> &OutCoordinates)
+{
+	// in Global CRS
+	OutCoordinates.SetNumUninitialized(Locations.Num());
+	for (int32 i = 0; i < Locations.Num(); i++)
+	{
+		OutCoordinates[i][0] = Locations[i].X / CmPerLongUnit + WorldOriginLong;
+		OutCoordinates[i][1] = Locations[i].Y / CmPerLatUnit + WorldOriginLat;
+	}
+
+	// convert to ToCRS
+	return GDALInterface::TransformPoints(CoordinateTransformation, OutCoordinates);
+}
+
 void UGlobalCoordinates::GetCRSCoordinatesFromUnrealLocations(FVector4d Locations, FVector4d& OutCoordinates)
 {
 	// in Global CRS
@@ -50,16 +50,20 @@ public:
 	)
 	double WorldOriginLat = 0;
 	
-	/* This function is slow. If you need to call it many times, make a single OGRCoordinateTransformation
-	 * with `GetCRSTransformer`and use this instead. */
+	/* The functions taking a CRS as a string use the transformations cached by `GDALInterface::GetCachedTransform`.
+	 * If you need to convert many points, use the functions taking arrays, which transform all points in a single call. */
 	bool GetUnrealCoordinatesFromCRS(double Longitude, double Latitude, FString FromCRS, FVector2D &XY);
+	bool GetUnrealCoordinatesFromCRS(const TArray<FVector2D> &Coordinates, FString FromCRS, TArray<FVector2D> &OutXY);
 	
+	/* Cached transformation, which must only be used on the calling thread, and must not be deleted */
 	OGRCoordinateTransformation *GetCRSTransformer(FString FromCRS);
 	void GetCRSCoordinatesFromUnrealLocation(FVector2D Location, FVector2D& OutCoordinates);
 	void GetUnrealCoordinatesFromCRS(double Longitude, double Latitude, FVector2D &XY);
 	bool GetUnrealCoordinatesFromCRS(double Longitude, double Latitude, OGRCoordinateTransformation *CoordinateTransformation, FVector2D &XY);
 	bool GetCRSCoordinatesFromUnrealLocation(FVector2D Location, FString ToCRS, FVector2D& OutCoordinates);
 	bool GetCRSCoordinatesFromUnrealLocation(FVector2D Location, OGRCoordinateTransformation *CoordinateTransformation, FVector2D& OutCoordinates);
+	bool GetCRSCoordinatesFromUnrealLocations(const TArray<FVector2D> &Locations, FString ToCRS, TArray<FVector2D> &OutCoordinates);
+	bool GetCRSCoordinatesFromUnrealLocations(const TArray<FVector2D> &Locations, OGRCoordinateTransformation *CoordinateTransformation, TArray<FVector2D> &OutCoordinates);
 	void GetCRSCoordinatesFromUnrealLocations(FVector4d Locations, FVector4d& OutCoordinates);
 	bool GetCRSCoordinatesFromUnrealLocations(FVector4d Locations, FString ToCRS, FVector4d& OutCoordinates);
 	bool GetCRSCoordinatesFromFBox(FBox Box, FString ToCRS, FVector4d& OutCoordinates);
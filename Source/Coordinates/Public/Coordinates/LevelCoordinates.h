@@ -23,6 +23,7 @@ public:
 
 	static TObjectPtr<UGlobalCoordinates> GetGlobalCoordinates(TWeakObjectPtr<UWorld> World, bool bShowDialog = true);
 	
+	/* Cached transformation, which must only be used on the calling thread, and must not be deleted */
 	static OGRCoordinateTransformation *GetCRSTransformer(UWorld *World, FString CRS);
 	static bool GetUnrealCoordinatesFromCRS(UWorld *World, double Longitude, double Latitude, FString CRS, FVector2D &OutXY);
 	static bool GetCRSCoordinatesFromUnrealLocation(UWorld* World, FVector2D Location, FVector2D& OutCoordinates);
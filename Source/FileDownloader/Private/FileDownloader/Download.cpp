@@ -267,7 +267,8 @@ void Download::DownloadMany(TArray<FString> URLs, TArray<FString> Files, TFuncti
 			{
 				if (OnComplete) OnComplete(TArray<FString>());
 			}
-		}
+		},
+		EConcurrencyResource::Network
 	);
 }
 
@@ -308,7 +309,8 @@ TArray<FString> Download::DownloadManyAndWait(TArray<FString> URLs, TArray<FStri
 		[URLs, Files, bProgress](int i)
 		{
 			return Download::SynchronousFromURL(URLs[i], Files[i], bProgress);
-		}
+		},
+		EConcurrencyResource::Network
 	))
 	{
 		return Files;
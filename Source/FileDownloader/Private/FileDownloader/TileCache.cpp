@@ -0,0 +1,372 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#include "FileDownloader/TileCache.h"
+#include "FileDownloader/Download.h"
+#include "FileDownloader/LogFileDownloader.h"
+
+#include "ConcurrencyHelpers/LCReporter.h"
+
+#include "Http.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/SecureHash.h"
+
+#define LOCTEXT_NAMESPACE "FLandscapeCombinatorModule"
+
+namespace
+{
+	const int32 ManifestVersion = 1;
+
+	FCriticalSection CacheLock;
+	FString CacheDirectory;
+	int64 MaxSize = 0;
+	FTimespan RevalidationDelay = FTimespan::Zero();
+
+	TMap<FString, FTileCacheEntry> Manifest; // keys are the MD5 hashes of the URLs
+	int64 TotalSize = 0;
+	bool bManifestDirty = false;
+
+	enum class ETileRequestResult : uint8
+	{
+		Downloaded,
+		NotModified,
+		Failed
+	};
+
+	ETileRequestResult RequestTile(const FString &URL, const FTileCacheEntry *Entry, TArray<uint8> &OutContent, FString &OutETag, FString &OutLastModified)
+	{
+		TSharedRef<IHttpRequest> Request = FHttpModule::Get().CreateRequest();
+		Request->SetURL(URL);
+		Request->SetVerb("GET");
+		Request->SetHeader("User-Agent", "X-UnrealEngine-Agent");
+		Request->SetTimeout(100);
+
+		if (Entry)
+		{
+			if (!Entry->ETag.IsEmpty()) Request->SetHeader("If-None-Match", Entry->ETag);
+			if (!Entry->LastModified.IsEmpty()) Request->SetHeader("If-Modified-Since", Entry->LastModified);
+		}
+
+		FEvent* SyncEvent = FPlatformProcess::GetSynchEventFromPool(false);
+		if (!SyncEvent)
+		{
+			LCReporter::ShowError(
+				LOCTEXT("TileCache::RequestTile", "Failed to create sync event for synchronous download.")
+			);
+			return ETileRequestResult::Failed;
+		}
+
+		ETileRequestResult Result = ETileRequestResult::Failed;
+		bool bTriggered = false;
+
+		Request->OnProcessRequestComplete().BindLambda([&](FHttpRequestPtr, FHttpResponsePtr Response, bool bWasSuccessful)
+		{
+			if (bTriggered) return;
+			bTriggered = true;
+
+			if (bWasSuccessful && Response.IsValid())
+			{
+				const int32 Code = Response->GetResponseCode();
+				if (Code == EHttpResponseCodes::NotModified)
+				{
+					Result = ETileRequestResult::NotModified;
+				}
+				else if (EHttpResponseCodes::IsOk(Code))
+				{
+					OutContent = Response->GetContent();
+					OutETag = Response->GetHeader("ETag");
+					OutLastModified = Response->GetHeader("Last-Modified");
+					Result = ETileRequestResult::Downloaded;
+				}
+				else
+				{
+					UE_LOG(LogFileDownloader, Error, TEXT("Request for '%s' was not successful. Error %d."), *URL, Code);
+				}
+			}
+			else
+			{
+				UE_LOG(LogFileDownloader, Error, TEXT("Error while downloading '%s'"), *URL);
+			}
+
+			SyncEvent->Trigger();
+		});
+
+		Request->ProcessRequest();
+		SyncEvent->Wait();
+		Request->OnProcessRequestComplete().Unbind();
+		Request->CancelRequest();
+		FPlatformProcess::ReturnSynchEventToPool(SyncEvent);
+
+		return Result;
+	}
+}
+
+void TileCache::Configure(FString CacheDir, int64 MaxSizeBytes, FTimespan RevalidateAfter)
+{
+	FScopeLock Lock(&CacheLock);
+
+	MaxSize = MaxSizeBytes;
+	RevalidationDelay = RevalidateAfter;
+
+	if (CacheDir == CacheDirectory) return;
+
+	if (!CacheDirectory.IsEmpty() && bManifestDirty)
+	{
+		SaveManifest();
+	}
+
+	if (!IPlatformFile::GetPlatformPhysical().CreateDirectoryTree(*CacheDir))
+	{
+		UE_LOG(LogFileDownloader, Error, TEXT("Could not create tile cache directory '%s', tile cache is disabled"), *CacheDir);
+		CacheDirectory = "";
+		Manifest.Empty();
+		TotalSize = 0;
+		return;
+	}
+
+	CacheDirectory = CacheDir;
+	LoadManifest();
+}
+
+bool TileCache::IsConfigured()
+{
+	FScopeLock Lock(&CacheLock);
+	return !CacheDirectory.IsEmpty();
+}
+
+FString TileCache::ManifestFile()
+{
+	return FPaths::Combine(CacheDirectory, "Manifest");
+}
+
+FString TileCache::CachedFile(const FString &Key)
+{
+	return FPaths::Combine(CacheDirectory, Key.Left(2), Key);
+}
+
+void TileCache::LoadManifest()
+{
+	FScopeLock Lock(&CacheLock);
+
+	Manifest.Empty();
+	TotalSize = 0;
+	bManifestDirty = false;
+
+	TUniquePtr<FArchive> FileReader(IFileManager::Get().CreateFileReader(*ManifestFile()));
+	if (FileReader)
+	{
+		int32 Version = 0;
+		*FileReader << Version;
+		if (Version == ManifestVersion) *FileReader << Manifest;
+		FileReader->Close();
+	}
+
+	// drop the entries whose file was removed or altered outside of the cache
+	IPlatformFile &PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	for (auto It = Manifest.CreateIterator(); It; ++It)
+	{
+		if (PlatformFile.FileSize(*CachedFile(It.Key())) != It.Value().Size)
+		{
+			It.RemoveCurrent();
+			bManifestDirty = true;
+		}
+		else
+		{
+			TotalSize += It.Value().Size;
+		}
+	}
+
+	UE_LOG(LogFileDownloader, Log, TEXT("Loaded tile cache manifest from '%s' with %d tiles (%lld bytes)"), *CacheDirectory, Manifest.Num(), TotalSize);
+}
+
+void TileCache::SaveManifest()
+{
+	FScopeLock Lock(&CacheLock);
+
+	if (CacheDirectory.IsEmpty() || !bManifestDirty) return;
+
+	// write to a temporary file first so that an interrupted save does not lose the whole manifest
+	const FString TempFile = ManifestFile() + ".tmp";
+	TUniquePtr<FArchive> FileWriter(IFileManager::Get().CreateFileWriter(*TempFile));
+	if (FileWriter)
+	{
+		int32 Version = ManifestVersion;
+		*FileWriter << Version;
+		*FileWriter << Manifest;
+		if (FileWriter->Close())
+		{
+			FileWriter.Reset();
+			if (IFileManager::Get().Move(*ManifestFile(), *TempFile, true, true))
+			{
+				bManifestDirty = false;
+				return;
+			}
+		}
+	}
+
+	UE_LOG(LogFileDownloader, Error, TEXT("Failed to save tile cache manifest to '%s'"), *ManifestFile());
+}
+
+void TileCache::Clear()
+{
+	FScopeLock Lock(&CacheLock);
+
+	if (CacheDirectory.IsEmpty()) return;
+
+	IPlatformFile &PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	for (auto &Pair : Manifest)
+	{
+		PlatformFile.DeleteFile(*CachedFile(Pair.Key));
+	}
+	Manifest.Empty();
+	TotalSize = 0;
+	bManifestDirty = true;
+	SaveManifest();
+}
+
+void TileCache::EvictIfNeeded()
+{
+	FScopeLock Lock(&CacheLock);
+
+	if (MaxSize <= 0 || TotalSize <= MaxSize) return;
+
+	TArray<FString> Keys;
+	Manifest.GetKeys(Keys);
+	Keys.Sort([](const FString &A, const FString &B) {
+		return Manifest[A].LastAccess < Manifest[B].LastAccess;
+	});
+
+	IPlatformFile &PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	int NumEvicted = 0;
+	for (const FString &Key : Keys)
+	{
+		if (TotalSize <= MaxSize) break;
+
+		PlatformFile.DeleteFile(*CachedFile(Key));
+		TotalSize -= Manifest[Key].Size;
+		Manifest.Remove(Key);
+		NumEvicted++;
+	}
+
+	bManifestDirty = true;
+	UE_LOG(LogFileDownloader, Log, TEXT("Evicted %d tiles from the tile cache, which now uses %lld bytes"), NumEvicted, TotalSize);
+}
+
+bool TileCache::Store(const FString &Key, const FString &URL, const TArray<uint8> &Content, const FString &ETag, const FString &LastModified)
+{
+	const FString File = CachedFile(Key);
+	const FString TempFile = File + FString::Printf(TEXT(".%u.tmp"), FPlatformTLS::GetCurrentThreadId());
+
+	if (!FFileHelper::SaveArrayToFile(Content, *TempFile) || !IFileManager::Get().Move(*File, *TempFile, true, true))
+	{
+		UE_LOG(LogFileDownloader, Error, TEXT("Error while saving '%s' to the tile cache"), *URL);
+		return false;
+	}
+
+	{
+		FScopeLock Lock(&CacheLock);
+
+		if (FTileCacheEntry *OldEntry = Manifest.Find(Key)) TotalSize -= OldEntry->Size;
+
+		FTileCacheEntry &Entry = Manifest.FindOrAdd(Key);
+		Entry.URL = URL;
+		Entry.Size = Content.Num();
+		Entry.ETag = ETag;
+		Entry.LastModified = LastModified;
+		Entry.LastAccess = FDateTime::UtcNow();
+		Entry.LastValidated = Entry.LastAccess;
+		TotalSize += Entry.Size;
+		bManifestDirty = true;
+	}
+
+	EvictIfNeeded();
+	return true;
+}
+
+bool TileCache::EnsureCached(const FString &URL, const FString &Key)
+{
+	bool bIsCached = false;
+	bool bNeedsRevalidation = false;
+	FTileCacheEntry CachedEntry;
+	{
+		FScopeLock Lock(&CacheLock);
+		if (FTileCacheEntry *Entry = Manifest.Find(Key))
+		{
+			bIsCached = true;
+			bNeedsRevalidation = RevalidationDelay > FTimespan::Zero() && FDateTime::UtcNow() - Entry->LastValidated > RevalidationDelay;
+			Entry->LastAccess = FDateTime::UtcNow();
+			CachedEntry = *Entry;
+			bManifestDirty = true;
+		}
+	}
+
+	if (bIsCached && !bNeedsRevalidation)
+	{
+		UE_LOG(LogFileDownloader, Log, TEXT("Using cached tile for '%s'"), *URL);
+		return true;
+	}
+
+	UE_LOG(LogFileDownloader, Log, TEXT("Downloading '%s' to the tile cache"), *URL);
+
+	TArray<uint8> Content;
+	FString ETag, LastModified;
+	ETileRequestResult Result = RequestTile(URL, bIsCached ? &CachedEntry : nullptr, Content, ETag, LastModified);
+
+	if (Result == ETileRequestResult::Downloaded)
+	{
+		return Store(Key, URL, Content, ETag, LastModified);
+	}
+	else if (Result == ETileRequestResult::NotModified)
+	{
+		UE_LOG(LogFileDownloader, Log, TEXT("Cached tile for '%s' is still valid"), *URL);
+		FScopeLock Lock(&CacheLock);
+		if (FTileCacheEntry *Entry = Manifest.Find(Key)) Entry->LastValidated = FDateTime::UtcNow();
+		return true;
+	}
+	else if (bIsCached)
+	{
+		UE_LOG(LogFileDownloader, Warning, TEXT("Could not revalidate '%s', using the cached tile"), *URL);
+		return true;
+	}
+	else
+	{
+		return false;
+	}
+}
+
+bool TileCache::SynchronousFromURL(FString URL, FString File, bool bProgress)
+{
+	if (!IsConfigured()) return Download::SynchronousFromURL(URL, File, bProgress);
+
+	if (IsInGameThread())
+	{
+		LCReporter::ShowError(
+			LOCTEXT("TileCache::SynchronousFromURL", "Synchronous download must be run on a background thread.")
+		);
+		return false;
+	}
+
+	const FString Key = FMD5::HashAnsiString(*URL);
+	if (!EnsureCached(URL, Key)) return false;
+
+	if (IFileManager::Get().Copy(*File, *CachedFile(Key)) != COPY_OK)
+	{
+		// the tile might have been evicted in the meantime by another download
+		UE_LOG(LogFileDownloader, Warning, TEXT("Could not copy cached tile '%s' to '%s', downloading it directly"), *CachedFile(Key), *File);
+		return Download::SynchronousFromURL(URL, File, bProgress);
+	}
+
+	return true;
+}
+
+bool TileCache::Prefetch(FString URL)
+{
+	if (!IsConfigured() || IsInGameThread()) return false;
+	return EnsureCached(URL, FMD5::HashAnsiString(*URL));
+}
+
+#undef LOCTEXT_NAMESPACE
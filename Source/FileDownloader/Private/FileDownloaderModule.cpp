@@ -2,6 +2,7 @@
 
 #include "FileDownloaderModule.h"
 #include "FileDownloader/Download.h"
+#include "FileDownloader/TileCache.h"
 
 #define LOCTEXT_NAMESPACE "FFileDownloaderModule"
 
@@ -12,4 +13,9 @@ void FFileDownloaderModule::StartupModule()
 	Download::LoadExpectedSizeCache();
 }
 
+void FFileDownloaderModule::ShutdownModule()
+{
+	TileCache::SaveManifest();
+}
+
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,51 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FTileCacheEntry
+{
+	FString URL;
+	int64 Size = 0;
+	FString ETag;
+	FString LastModified;
+	FDateTime LastAccess;
+	FDateTime LastValidated;
+
+	friend FArchive& operator<<(FArchive& Ar, FTileCacheEntry& Entry)
+	{
+		Ar << Entry.URL << Entry.Size << Entry.ETag << Entry.LastModified << Entry.LastAccess << Entry.LastValidated;
+		return Ar;
+	}
+};
+
+/* Persistent cache for downloaded tiles, keyed by the hash of the request URL.
+ * Cached tiles are served without any network access, unless they are older than the revalidation delay,
+ * in which case a conditional request is made using the ETag and Last-Modified headers recorded in the manifest.
+ * When the cache exceeds its maximum size, the least recently used tiles are evicted. */
+class FILEDOWNLOADER_API TileCache {
+public:
+	/* Must be called before using the cache. RevalidateAfter set to zero means that cached tiles are never revalidated. */
+	static void Configure(FString CacheDir, int64 MaxSizeBytes, FTimespan RevalidateAfter);
+	static bool IsConfigured();
+
+	/* Writes the content of URL to File, from the cache when possible, and adds it to the cache otherwise.
+	 * Falls back to Download::SynchronousFromURL when the cache is not configured. */
+	static bool SynchronousFromURL(FString URL, FString File, bool bProgress);
+
+	/* Adds the content of URL to the cache without writing it anywhere else, so that a later download is served from the cache.
+	 * Returns false when the cache is not configured, when called from the game thread, or when the download fails. */
+	static bool Prefetch(FString URL);
+
+	static void SaveManifest();
+	static void Clear();
+
+private:
+	static FString ManifestFile();
+	static FString CachedFile(const FString &Key);
+	static void LoadManifest();
+	static void EvictIfNeeded();
+	static bool EnsureCached(const FString &URL, const FString &Key);
+	static bool Store(const FString &Key, const FString &URL, const TArray<uint8> &Content, const FString &ETag, const FString &LastModified);
+};
@@ -8,4 +8,5 @@
 class FFileDownloaderModule : public IModuleInterface
 {
 	void StartupModule() override;
+	void ShutdownModule() override;
 };
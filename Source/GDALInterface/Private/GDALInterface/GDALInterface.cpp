@@ -2,12 +2,14 @@
 
 #include "GDALInterface/GDALInterface.h"
 #include "GDALInterface/LogGDALInterface.h"
+#include "GDALInterface/RasterStatistics.h"
 
 #include "FileDownloader/Download.h"
 #include "ConcurrencyHelpers/Concurrency.h"
 #include "ConcurrencyHelpers/LCReporter.h"
 
 #include "Async/Async.h"
+#include "Async/ParallelFor.h"
 #include "Async/TaskGraphInterfaces.h"
 #include "Internationalization/Regex.h"
 #include "Internationalization/TextLocalizationResource.h" 
@@ -15,10 +17,43 @@
 #include "Misc/Paths.h"
 #include "Misc/MessageDialog.h"
 
+#include "HAL/CriticalSection.h"
 #include "HAL/FileManager.h"
+#include "Misc/ScopeLock.h"
 
 #define LOCTEXT_NAMESPACE "FGDALInterfaceModule"
 
+namespace
+{
+	struct FCTDeleter
+	{
+		void operator()(OGRCoordinateTransformation* CoordinateTransformation) const
+		{
+			OGRCoordinateTransformation::DestroyCT(CoordinateTransformation);
+		}
+	};
+
+	using FCTPtr = TUniquePtr<OGRCoordinateTransformation, FCTDeleter>;
+	using FCRSPair = TPair<FString, FString>;
+
+	FCriticalSection TransformCacheLock;
+
+	// one transformation per CRS pair, which is only cloned and never used to transform coordinates
+	TMap<FCRSPair, FCTPtr> PrototypeTransforms;
+
+	// incremented when the cache is cleared, so that each thread drops its transformations on its next lookup
+	std::atomic<uint32> TransformCacheEpoch = 0;
+
+	// the transformations of the current thread, so that they are never used by two threads at the same time,
+	// and that they are freed when the thread exits
+	struct FThreadTransforms
+	{
+		uint32 Epoch = 0;
+		TMap<FCRSPair, FCTPtr> Transforms;
+	};
+	thread_local FThreadTransforms ThreadTransforms;
+}
+
 bool GDALInterface::SetWellKnownGeogCRS(OGRSpatialReference& InRs, FString CRS)
 {
 	OGRErr Err = InRs.SetWellKnownGeogCS(TCHAR_TO_ANSI(*CRS));
@@ -301,6 +336,57 @@ OGRCoordinateTransformation *GDALInterface::MakeTransform(FString InCRS, FString
 	return CoordinateTransformation;
 }
 
+OGRCoordinateTransformation *GDALInterface::GetCachedTransform(FString InCRS, FString OutCRS)
+{
+	const FCRSPair Key(InCRS, OutCRS);
+
+	const uint32 Epoch = TransformCacheEpoch.load();
+	if (ThreadTransforms.Epoch != Epoch)
+	{
+		ThreadTransforms.Transforms.Empty();
+		ThreadTransforms.Epoch = Epoch;
+	}
+
+	// the thread's own transformations are looked up without any lock
+	if (FCTPtr *CachedTransform = ThreadTransforms.Transforms.Find(Key)) return CachedTransform->Get();
+
+	{
+		FScopeLock Lock(&TransformCacheLock);
+
+		// cloning is much cheaper than parsing the CRS strings and looking up the PROJ database again
+		if (FCTPtr *Prototype = PrototypeTransforms.Find(Key))
+		{
+			return ThreadTransforms.Transforms.Add(Key, FCTPtr((*Prototype)->Clone())).Get();
+		}
+	}
+
+	// the prototype is created outside of the lock, as it can be slow; if two threads race here,
+	// the second prototype is simply used as the transformation of its thread
+	OGRCoordinateTransformation *NewTransform = MakeTransform(InCRS, OutCRS);
+	if (!NewTransform) return nullptr;
+
+	{
+		FScopeLock Lock(&TransformCacheLock);
+
+		if (!PrototypeTransforms.Contains(Key))
+		{
+			PrototypeTransforms.Add(Key, FCTPtr(NewTransform->Clone()));
+		}
+	}
+
+	return ThreadTransforms.Transforms.Add(Key, FCTPtr(NewTransform)).Get();
+}
+
+void GDALInterface::ClearTransformCache()
+{
+	// the transformations of the other threads are dropped on their next lookup, or when they exit
+	TransformCacheEpoch++;
+	ThreadTransforms.Transforms.Empty();
+
+	FScopeLock Lock(&TransformCacheLock);
+	PrototypeTransforms.Empty();
+}
+
 bool GDALInterface::Transform(OGRCoordinateTransformation* CoordinateTransformation, double *Longitude, double *Latitude)
 {
 	if (!CoordinateTransformation)
@@ -339,22 +425,65 @@ bool GDALInterface::Transform2(OGRCoordinateTransformation* CoordinateTransforma
 	return true;
 }
 
+bool GDALInterface::TransformPoints(OGRCoordinateTransformation* CoordinateTransformation, int64 NumPoints, double *xs, double *ys)
+{
+	if (NumPoints == 0) return true;
+
+	if (!CoordinateTransformation || !CoordinateTransformation->Transform(NumPoints, xs, ys))
+	{
+		LCReporter::ShowError(
+			FText::Format(
+				LOCTEXT("GDALInterface::TransformPoints", "Internal error while transforming {0} points.\n{1}"),
+				FText::AsNumber(NumPoints),
+				FText::FromString(FString(CPLGetLastErrorMsg()))
+			)
+		);
+		return false;
+	}
+	return true;
+}
+
+bool GDALInterface::TransformPoints(OGRCoordinateTransformation* CoordinateTransformation, TArray<FVector2D> &Points)
+{
+	const int64 NumPoints = Points.Num();
+	TArray<double> xs, ys;
+	xs.SetNumUninitialized(NumPoints);
+	ys.SetNumUninitialized(NumPoints);
+
+	for (int64 i = 0; i < NumPoints; i++)
+	{
+		xs[i] = Points[i].X;
+		ys[i] = Points[i].Y;
+	}
+
+	if (!TransformPoints(CoordinateTransformation, NumPoints, xs.GetData(), ys.GetData())) return false;
+
+	for (int64 i = 0; i < NumPoints; i++)
+	{
+		Points[i].X = xs[i];
+		Points[i].Y = ys[i];
+	}
+	return true;
+}
+
 bool GDALInterface::ConvertCoordinates(double *Longitude, double *Latitude, FString InCRS, FString OutCRS)
 {
-	return Transform(MakeTransform(InCRS, OutCRS), Longitude, Latitude);
+	return Transform(GetCachedTransform(InCRS, OutCRS), Longitude, Latitude);
 }
 
 bool GDALInterface::ConvertCoordinates2(double *xs, double *ys, FString InCRS, FString OutCRS)
 {
-	return Transform2(MakeTransform(InCRS, OutCRS), xs, ys);
+	return Transform2(GetCachedTransform(InCRS, OutCRS), xs, ys);
 }
 
-bool GDALInterface::ConvertCoordinates(FVector4d& OriginalCoordinates, bool bCrop, FVector4d& NewCoordinates, FString InCRS, FString OutCRS)
+bool GDALInterface::ConvertPoints(TArray<FVector2D> &Points, FString InCRS, FString OutCRS)
 {
-	OGRSpatialReference InRs, OutRs;
-	if (!SetCRSFromUserInput(InRs, InCRS) || !SetCRSFromUserInput(OutRs, OutCRS)) return false;
+	return TransformPoints(GetCachedTransform(InCRS, OutCRS), Points);
+}
 
-	return ConvertCoordinates(OriginalCoordinates, bCrop, NewCoordinates, InRs, OutRs);
+bool GDALInterface::ConvertCoordinates(FVector4d& OriginalCoordinates, bool bCrop, FVector4d& NewCoordinates, FString InCRS, FString OutCRS)
+{
+	return ConvertBounds(GetCachedTransform(InCRS, OutCRS), OriginalCoordinates, bCrop, NewCoordinates);
 }
 
 bool GDALInterface::ConvertCoordinates(FVector4d& OriginalCoordinates, FVector4d& Coordinates, FString InCRS, FString OutCRS)
@@ -366,8 +495,8 @@ bool GDALInterface::ConvertCoordinates(FVector4d& OriginalCoordinates, FVector4d
 	double xs[2] = { MinCoordWidth,  MaxCoordWidth  };
 	double ys[2] = { MaxCoordHeight, MinCoordHeight };
 
-	OGRSpatialReference InRs, OutRs;
-	if (!SetCRSFromUserInput(InRs, InCRS) || !SetCRSFromUserInput(OutRs, OutCRS) || !OGRCreateCoordinateTransformation(&InRs, &OutRs)->Transform(2, xs, ys)) {
+	OGRCoordinateTransformation *CoordinateTransformation = GetCachedTransform(InCRS, OutCRS);
+	if (!CoordinateTransformation || !CoordinateTransformation->Transform(2, xs, ys)) {
 		LCReporter::ShowError(
 			LOCTEXT("GDALInterface::ConvertCoordinates", "Internal error while transforming coordinates.")
 		);
@@ -382,6 +511,12 @@ bool GDALInterface::ConvertCoordinates(FVector4d& OriginalCoordinates, FVector4d
 }
 
 bool GDALInterface::ConvertCoordinates(FVector4d& OriginalCoordinates, bool bCrop, FVector4d& NewCoordinates, OGRSpatialReference InRs, OGRSpatialReference OutRs)
+{
+	FCTPtr CoordinateTransformation(OGRCreateCoordinateTransformation(&InRs, &OutRs));
+	return ConvertBounds(CoordinateTransformation.Get(), OriginalCoordinates, bCrop, NewCoordinates);
+}
+
+bool GDALInterface::ConvertBounds(OGRCoordinateTransformation* CoordinateTransformation, FVector4d& OriginalCoordinates, bool bCrop, FVector4d& NewCoordinates)
 {
 	double MinCoordWidth = OriginalCoordinates[0];
 	double MaxCoordWidth = OriginalCoordinates[1];
@@ -391,7 +526,7 @@ bool GDALInterface::ConvertCoordinates(FVector4d& OriginalCoordinates, bool bCro
 	double xs[4] = { MinCoordWidth,  MinCoordWidth,  MaxCoordWidth,  MaxCoordWidth };
 	double ys[4] = { MinCoordHeight, MaxCoordHeight, MaxCoordHeight, MinCoordHeight };
 
-	if (!OGRCreateCoordinateTransformation(&InRs, &OutRs)->Transform(4, xs, ys))
+	if (!CoordinateTransformation || !CoordinateTransformation->Transform(4, xs, ys))
 	{
 		LCReporter::ShowError(LOCTEXT("GDALInterface::ConvertCoordinates", "Internal error while transforming coordinates."));
 		return false;
@@ -437,44 +572,7 @@ bool GDALInterface::GetPixels(FIntPoint& Pixels, FString File)
 
 bool GDALInterface::GetMinMax(FVector2D &MinMax, TArray<FString> Files)
 {
-	MinMax[0] = DBL_MAX;
-	MinMax[1] = -DBL_MAX;
-
-	for (auto& File : Files) {
-
-		GDALDataset *Dataset = (GDALDataset *)GDALOpen(TCHAR_TO_UTF8(*File), GA_ReadOnly);
-
-		if (!Dataset)
-		{
-			LCReporter::ShowError(
-				FText::Format(LOCTEXT("GetMinMaxError", "Could not open heightmap file '{0}' to compute min/max altitudes.\n{1}"),
-					FText::FromString(File),
-					FText::FromString(FString(CPLGetLastErrorMsg()))
-				)
-			);
-			return false;
-		}
-		
-		double AdfMinMax[2];
-
-		if (GDALComputeRasterMinMax(Dataset->GetRasterBand(1), false, AdfMinMax) != CE_None)
-		{
-			LCReporter::ShowError(
-				FText::Format(LOCTEXT("GetMinMaxError2", "Could not compute min/max altitudes of file '{0}'.\n{1}"),
-					FText::FromString(File),
-					FText::FromString(FString(CPLGetLastErrorMsg()))
-				)
-			);
-			GDALClose(Dataset);
-			return false;
-		}
-		GDALClose(Dataset);
-
-		MinMax[0] = FMath::Min(MinMax[0], AdfMinMax[0]);
-		MinMax[1] = FMath::Max(MinMax[1], AdfMinMax[1]);
-	}
-
-	return true;
+	return RasterStatistics::GetMinMax(Files, MinMax);
 }
 
 FString GDALInterface::GetColorInterpretation(const FString &File)
@@ -727,6 +825,34 @@ bool GDALInterface::ReadHeightmapFromFile(FString File, int& OutWidth, int& OutH
 	return true;
 }
 
+bool GDALInterface::ReadHeightmapFromFile(FString File, double MinAltitude, double MaxAltitude, int& OutWidth, int& OutHeight, TArray<uint16>& OutHeightmap)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("GDALInterface::ReadHeightmapFromFile");
+
+	if (MaxAltitude <= MinAltitude)
+	{
+		UE_LOG(LogGDALInterface, Error, TEXT("Could not read heightmap %s, invalid altitude range [%f, %f]."), *File, MinAltitude, MaxAltitude);
+		return false;
+	}
+
+	TArray<float> Heightmap;
+	if (!ReadHeightmapFromFile(File, OutWidth, OutHeight, Heightmap)) return false;
+
+	const double Scale = 65535 / (MaxAltitude - MinAltitude);
+	OutHeightmap.SetNumUninitialized(Heightmap.Num());
+
+	ParallelFor(OutHeight, [&](int32 j)
+	{
+		for (int i = 0; i < OutWidth; i++)
+		{
+			const int k = i + j * OutWidth;
+			OutHeightmap[k] = (uint16) FMath::Clamp(FMath::RoundToInt((Heightmap[k] - MinAltitude) * Scale), 0, 65535);
+		}
+	});
+
+	return true;
+}
+
 bool GDALInterface::ReadColorsFromFile(FString File, int &OutWidth, int &OutHeight, TArray<FColor> &OutColors)
 {
 	GDALDataset *Dataset = (GDALDataset *)GDALOpen(TCHAR_TO_UTF8(*File), GA_ReadOnly);
@@ -1132,7 +1258,219 @@ GDALDataset* GDALInterface::LoadGDALVectorDatasetFromQuery(FString Query, bool b
 	return LoadGDALVectorDatasetFromFile(XmlFilePath);
 }
 
+namespace
+{
+	/* Buffers small writes, and writes them to the archive in large chunks */
+	class FChunkedWriter
+	{
+	public:
+		FChunkedWriter(FArchive &Archive0) : Archive(Archive0)
+		{
+			Buffer.Reserve(ChunkSize);
+		}
+
+		~FChunkedWriter() { Flush(); }
+
+		template<typename T>
+		void Write(const T &Value)
+		{
+			WriteBytes(&Value, sizeof(T));
+		}
+
+		void WriteBytes(const void *Data, int64 Size)
+		{
+			if (Buffer.Num() + Size > ChunkSize) Flush();
+			if (Size > ChunkSize)
+			{
+				Archive.Serialize(const_cast<void*>(Data), Size);
+				return;
+			}
+			Buffer.Append((const uint8*) Data, Size);
+		}
+
+		void WriteString(const FString &String)
+		{
+			FTCHARToUTF8 UTF8String(*String);
+			WriteBytes(UTF8String.Get(), UTF8String.Length());
+		}
+
+		void Flush()
+		{
+			if (Buffer.IsEmpty()) return;
+			Archive.Serialize(Buffer.GetData(), Buffer.Num());
+			Buffer.Reset();
+		}
+
+	private:
+		static constexpr int64 ChunkSize = 4 * 1024 * 1024;
+		FArchive &Archive;
+		TArray<uint8> Buffer;
+	};
+
+	/* Vertices of the mesh, with indices that are compact even when the mesh has gaps in its vertex IDs */
+	void CompactVertices(const FDynamicMesh3 &Mesh, TArray<FVector3f> &OutVertices, TArray<int32> &OutVertexIDToIndex)
+	{
+		OutVertices.Reset(Mesh.VertexCount());
+		OutVertexIDToIndex.Init(INDEX_NONE, Mesh.MaxVertexID());
+		for (int32 VertexID : Mesh.VertexIndicesItr())
+		{
+			OutVertexIDToIndex[VertexID] = OutVertices.Num();
+			OutVertices.Add(FVector3f(Mesh.GetVertex(VertexID)));
+		}
+	}
+
+	TUniquePtr<FArchive> CreateExportFile(const FString &File)
+	{
+		TUniquePtr<FArchive> FileWriter(IFileManager::Get().CreateFileWriter(*File));
+		if (!FileWriter)
+		{
+			UE_LOG(LogGDALInterface, Error, TEXT("Failed to create file: %s"), *File);
+		}
+		return FileWriter;
+	}
+
+	bool CloseExportFile(TUniquePtr<FArchive> &FileWriter, const FString &File)
+	{
+		if (FileWriter->IsError() || !FileWriter->Close())
+		{
+			UE_LOG(LogGDALInterface, Error, TEXT("Failed to write file: %s"), *File);
+			return false;
+		}
+		return true;
+	}
+}
+
 bool GDALInterface::ExportMesh(const FDynamicMesh3 &Mesh, const FString &File)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("GDALInterface::ExportMesh");
+
+	const FString Extension = FPaths::GetExtension(File).ToLower();
+	if (Extension == "ply") return ExportMeshToPLY(Mesh, File);
+	if (Extension == "glb") return ExportMeshToGLB(Mesh, File);
+	return ExportMeshToDXF(Mesh, File);
+}
+
+bool GDALInterface::ExportMeshToPLY(const FDynamicMesh3 &Mesh, const FString &File)
+{
+	TArray<FVector3f> Vertices;
+	TArray<int32> VertexIDToIndex;
+	CompactVertices(Mesh, Vertices, VertexIDToIndex);
+
+	TUniquePtr<FArchive> FileWriter = CreateExportFile(File);
+	if (!FileWriter) return false;
+
+	{
+		FChunkedWriter Writer(*FileWriter);
+		Writer.WriteString(FString::Printf(
+			TEXT("ply\nformat binary_little_endian 1.0\nelement vertex %d\nproperty float x\nproperty float y\nproperty float z\n")
+			TEXT("element face %d\nproperty list uchar int vertex_indices\nend_header\n"),
+			Vertices.Num(), Mesh.TriangleCount()
+		));
+
+		Writer.WriteBytes(Vertices.GetData(), Vertices.Num() * sizeof(FVector3f));
+
+		for (int32 TriangleID : Mesh.TriangleIndicesItr())
+		{
+			const FIndex3i Triangle = Mesh.GetTriangle(TriangleID);
+			Writer.Write<uint8>(3);
+			Writer.Write<int32>(VertexIDToIndex[Triangle.A]);
+			Writer.Write<int32>(VertexIDToIndex[Triangle.B]);
+			Writer.Write<int32>(VertexIDToIndex[Triangle.C]);
+		}
+	}
+
+	UE_LOG(LogGDALInterface, Log, TEXT("Exported mesh with %d vertices and %d triangles to %s"), Vertices.Num(), Mesh.TriangleCount(), *File);
+	return CloseExportFile(FileWriter, File);
+}
+
+bool GDALInterface::ExportMeshToGLB(const FDynamicMesh3 &Mesh, const FString &File)
+{
+	TArray<FVector3f> Vertices;
+	TArray<int32> VertexIDToIndex;
+	CompactVertices(Mesh, Vertices, VertexIDToIndex);
+
+	if (Vertices.IsEmpty())
+	{
+		UE_LOG(LogGDALInterface, Error, TEXT("Cannot export an empty mesh to %s"), *File);
+		return false;
+	}
+
+	// glTF uses meters and Y up, while Unreal uses centimeters and Z up
+	FBox3f Bounds(ForceInit);
+	for (FVector3f &Vertex : Vertices)
+	{
+		Vertex = FVector3f(Vertex.X, Vertex.Z, Vertex.Y) / 100;
+		Bounds += Vertex;
+	}
+
+	const int64 NumIndices = 3 * (int64) Mesh.TriangleCount();
+	const int64 VerticesLength = Vertices.Num() * sizeof(FVector3f);
+	const int64 IndicesLength = NumIndices * sizeof(uint32);
+	const int64 BinaryLength = VerticesLength + IndicesLength; // both are multiples of 4
+
+	FString JSON = FString::Printf(
+		TEXT("{\"asset\":{\"version\":\"2.0\",\"generator\":\"LandscapeCombinator\"},\"scene\":0,\"scenes\":[{\"nodes\":[0]}],\"nodes\":[{\"mesh\":0}],")
+		TEXT("\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0},\"indices\":1}]}],")
+		TEXT("\"accessors\":[")
+		TEXT("{\"bufferView\":0,\"componentType\":5126,\"count\":%d,\"type\":\"VEC3\",\"min\":[%s,%s,%s],\"max\":[%s,%s,%s]},")
+		TEXT("{\"bufferView\":1,\"componentType\":5125,\"count\":%lld,\"type\":\"SCALAR\"}],")
+		TEXT("\"bufferViews\":[")
+		TEXT("{\"buffer\":0,\"byteOffset\":0,\"byteLength\":%lld,\"target\":34962},")
+		TEXT("{\"buffer\":0,\"byteOffset\":%lld,\"byteLength\":%lld,\"target\":34963}],")
+		TEXT("\"buffers\":[{\"byteLength\":%lld}]}"),
+		Vertices.Num(),
+		*FString::SanitizeFloat(Bounds.Min.X), *FString::SanitizeFloat(Bounds.Min.Y), *FString::SanitizeFloat(Bounds.Min.Z),
+		*FString::SanitizeFloat(Bounds.Max.X), *FString::SanitizeFloat(Bounds.Max.Y), *FString::SanitizeFloat(Bounds.Max.Z),
+		NumIndices,
+		VerticesLength,
+		VerticesLength, IndicesLength,
+		BinaryLength
+	);
+
+	// the JSON chunk is padded with spaces to a multiple of 4 bytes
+	FTCHARToUTF8 UTF8JSON(*JSON);
+	const int64 JSONLength = Align(UTF8JSON.Length(), 4);
+	const int64 TotalLength = 12 + 8 + JSONLength + 8 + BinaryLength;
+
+	if (TotalLength > MAX_uint32)
+	{
+		UE_LOG(LogGDALInterface, Error, TEXT("Mesh is too large to be exported to %s"), *File);
+		return false;
+	}
+
+	TUniquePtr<FArchive> FileWriter = CreateExportFile(File);
+	if (!FileWriter) return false;
+
+	{
+		FChunkedWriter Writer(*FileWriter);
+
+		Writer.Write<uint32>(0x46546C67); // "glTF"
+		Writer.Write<uint32>(2);
+		Writer.Write<uint32>((uint32) TotalLength);
+
+		Writer.Write<uint32>((uint32) JSONLength);
+		Writer.Write<uint32>(0x4E4F534A); // "JSON"
+		Writer.WriteBytes(UTF8JSON.Get(), UTF8JSON.Length());
+		for (int64 i = UTF8JSON.Length(); i < JSONLength; i++) Writer.Write<uint8>(' ');
+
+		Writer.Write<uint32>((uint32) BinaryLength);
+		Writer.Write<uint32>(0x004E4942); // "BIN"
+		Writer.WriteBytes(Vertices.GetData(), VerticesLength);
+
+		for (int32 TriangleID : Mesh.TriangleIndicesItr())
+		{
+			const FIndex3i Triangle = Mesh.GetTriangle(TriangleID);
+			Writer.Write<uint32>(VertexIDToIndex[Triangle.A]);
+			Writer.Write<uint32>(VertexIDToIndex[Triangle.B]);
+			Writer.Write<uint32>(VertexIDToIndex[Triangle.C]);
+		}
+	}
+
+	UE_LOG(LogGDALInterface, Log, TEXT("Exported mesh with %d vertices and %d triangles to %s"), Vertices.Num(), Mesh.TriangleCount(), *File);
+	return CloseExportFile(FileWriter, File);
+}
+
+bool GDALInterface::ExportMeshToDXF(const FDynamicMesh3 &Mesh, const FString &File)
 {
 	CPLSetConfigOption("DXF_WRITE_HATCH", "NO");
 	GDALDriver *DXFDriver = GetGDALDriverManager()->GetDriverByName("DXF");
@@ -1202,6 +1540,54 @@ bool GDALInterface::ExportMesh(const FDynamicMesh3 &Mesh, const FString &File)
 }
 
 bool GDALInterface::ExportPolygons(const TArray<TArray<FVector>> &PointLists, const FString &File)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("GDALInterface::ExportPolygons");
+
+	if (FPaths::GetExtension(File).ToLower() == "ply") return ExportPolygonsToPLY(PointLists, File);
+	return ExportPolygonsToDXF(PointLists, File);
+}
+
+bool GDALInterface::ExportPolygonsToPLY(const TArray<TArray<FVector>> &PointLists, const FString &File)
+{
+	int64 NumVertices = 0;
+	for (const TArray<FVector> &Points : PointLists) NumVertices += Points.Num();
+
+	if (NumVertices > MAX_int32)
+	{
+		UE_LOG(LogGDALInterface, Error, TEXT("Too many points to be exported to %s"), *File);
+		return false;
+	}
+
+	TUniquePtr<FArchive> FileWriter = CreateExportFile(File);
+	if (!FileWriter) return false;
+
+	{
+		FChunkedWriter Writer(*FileWriter);
+		Writer.WriteString(FString::Printf(
+			TEXT("ply\nformat binary_little_endian 1.0\nelement vertex %lld\nproperty float x\nproperty float y\nproperty float z\n")
+			TEXT("element face %d\nproperty list int int vertex_indices\nend_header\n"),
+			NumVertices, PointLists.Num()
+		));
+
+		for (const TArray<FVector> &Points : PointLists)
+		{
+			for (const FVector &Point : Points) Writer.Write<FVector3f>(FVector3f(Point));
+		}
+
+		int32 FirstIndex = 0;
+		for (const TArray<FVector> &Points : PointLists)
+		{
+			Writer.Write<int32>(Points.Num());
+			for (int32 i = 0; i < Points.Num(); i++) Writer.Write<int32>(FirstIndex + i);
+			FirstIndex += Points.Num();
+		}
+	}
+
+	UE_LOG(LogGDALInterface, Log, TEXT("Exported %d polygons to %s"), PointLists.Num(), *File);
+	return CloseExportFile(FileWriter, File);
+}
+
+bool GDALInterface::ExportPolygonsToDXF(const TArray<TArray<FVector>> &PointLists, const FString &File)
 {
 	CPLSetConfigOption("DXF_WRITE_HATCH", "NO");
 	GDALDriver *DXFDriver = GetGDALDriverManager()->GetDriverByName("DXF");
@@ -0,0 +1,321 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#include "GDALInterface/RasterStatistics.h"
+#include "GDALInterface/GDALInterface.h"
+#include "GDALInterface/LogGDALInterface.h"
+
+#include "ConcurrencyHelpers/LCReporter.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/CriticalSection.h"
+#include "HAL/FileManager.h"
+#include "Misc/ScopeLock.h"
+
+#define LOCTEXT_NAMESPACE "FGDALInterfaceModule"
+
+namespace
+{
+	const int32 SidecarVersion = 1;
+
+	// beyond this number of buckets, the values are too spread for the histogram to be useful, and it is dropped
+	const int64 MaxHistogramBuckets = 1 << 16;
+
+	FCriticalSection StatisticsLock;
+
+	// keys are the paths of the rasters, values are the keys of the rasters when their statistics were computed
+	TMap<FString, TPair<FString, FRasterStatistics>> StatisticsCache;
+
+	bool IsVirtual(const FString &File)
+	{
+		return File.StartsWith("/vsi");
+	}
+
+	/* Only files on disk have a key, as files in GDAL's virtual file systems are transient and are never cached.
+	 * The modification time is used with the precision of the platform (sub-second on Windows), but as some platforms
+	 * only have seconds, fetchers also drop the statistics of the directories they rewrite (see InvalidateDirectory). */
+	bool GetKey(const FString &File, FString &OutKey)
+	{
+		if (IsVirtual(File)) return false;
+
+		const FFileStatData StatData = IFileManager::Get().GetStatData(*File);
+		if (!StatData.bIsValid || StatData.bIsDirectory) return false;
+
+		OutKey = FString::Printf(TEXT("%s|%lld|%lld"), *File, StatData.ModificationTime.GetTicks(), StatData.FileSize);
+		return true;
+	}
+
+	/* Grows the histogram so that it covers the buckets from FirstBucket to LastBucket, returns false if it gets too large */
+	bool GrowHistogram(FRasterStatistics &Statistics, int64 &HistogramStart, int64 FirstBucket, int64 LastBucket)
+	{
+		if (Statistics.Histogram.IsEmpty())
+		{
+			if (LastBucket - FirstBucket + 1 > MaxHistogramBuckets) return false;
+			HistogramStart = FirstBucket;
+			Statistics.Histogram.SetNumZeroed(LastBucket - FirstBucket + 1);
+			return true;
+		}
+
+		const int64 NewStart = FMath::Min(HistogramStart, FirstBucket);
+		const int64 NewEnd = FMath::Max(HistogramStart + Statistics.Histogram.Num() - 1, LastBucket);
+		if (NewEnd - NewStart + 1 > MaxHistogramBuckets) return false;
+
+		if (NewStart < HistogramStart)
+		{
+			Statistics.Histogram.InsertZeroed(0, HistogramStart - NewStart);
+			HistogramStart = NewStart;
+		}
+		Statistics.Histogram.SetNumZeroed(NewEnd - NewStart + 1);
+		return true;
+	}
+}
+
+bool RasterStatistics::Compute(const FString &File, FRasterStatistics &OutStatistics, FString &OutError)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("RasterStatistics::Compute");
+
+	GDALDataset *Dataset = (GDALDataset *) GDALOpen(TCHAR_TO_UTF8(*File), GA_ReadOnly);
+	if (!Dataset)
+	{
+		OutError = FString(CPLGetLastErrorMsg());
+		return false;
+	}
+
+	if (Dataset->GetRasterCount() < 1)
+	{
+		OutError = "No raster band";
+		GDALClose(Dataset);
+		return false;
+	}
+
+	GDALRasterBand *Band = Dataset->GetRasterBand(1);
+	int bHasNoData = 0;
+	const double NoData = Band->GetNoDataValue(&bHasNoData);
+
+	const int Width = Band->GetXSize();
+	const int Height = Band->GetYSize();
+	int BlockWidth = 0, BlockHeight = 0;
+	Band->GetBlockSize(&BlockWidth, &BlockHeight);
+
+	// the raster is read by strips of one row of blocks, so that each block is decoded only once,
+	// and that only one strip is in memory at a time
+	const int StripHeight = FMath::Clamp(BlockHeight, 1, Height);
+	TArray<double> Strip;
+	Strip.SetNumUninitialized((int64) Width * StripHeight);
+
+	OutStatistics = FRasterStatistics();
+	OutStatistics.NumPixels = (int64) Width * Height;
+	int64 HistogramStart = 0;
+	bool bKeepHistogram = true;
+
+	for (int Y0 = 0; Y0 < Height; Y0 += StripHeight)
+	{
+		const int Rows = FMath::Min(StripHeight, Height - Y0);
+		const int64 NumValues = (int64) Width * Rows;
+
+		if (Band->RasterIO(GF_Read, 0, Y0, Width, Rows, Strip.GetData(), Width, Rows, GDT_Float64, 0, 0) != CE_None)
+		{
+			OutError = FString(CPLGetLastErrorMsg());
+			GDALClose(Dataset);
+			return false;
+		}
+
+		double StripMin = DBL_MAX;
+		double StripMax = -DBL_MAX;
+		for (int64 k = 0; k < NumValues; k++)
+		{
+			const double Value = Strip[k];
+			if (FMath::IsNaN(Value) || (bHasNoData && Value == NoData))
+			{
+				OutStatistics.NumNoDataPixels++;
+				continue;
+			}
+			StripMin = FMath::Min(StripMin, Value);
+			StripMax = FMath::Max(StripMax, Value);
+		}
+
+		if (StripMin > StripMax) continue;
+
+		OutStatistics.Min = FMath::Min(OutStatistics.Min, StripMin);
+		OutStatistics.Max = FMath::Max(OutStatistics.Max, StripMax);
+
+		if (!bKeepHistogram) continue;
+
+		if (!GrowHistogram(OutStatistics, HistogramStart, FMath::FloorToInt64(StripMin / BucketSize), FMath::FloorToInt64(StripMax / BucketSize)))
+		{
+			UE_LOG(LogGDALInterface, Log, TEXT("Values of %s are too spread to compute a histogram"), *File);
+			OutStatistics.Histogram.Empty();
+			bKeepHistogram = false;
+			continue;
+		}
+
+		for (int64 k = 0; k < NumValues; k++)
+		{
+			const double Value = Strip[k];
+			if (FMath::IsNaN(Value) || (bHasNoData && Value == NoData)) continue;
+			OutStatistics.Histogram[FMath::FloorToInt64(Value / BucketSize) - HistogramStart]++;
+		}
+	}
+
+	OutStatistics.HistogramMin = HistogramStart * BucketSize;
+
+	GDALClose(Dataset);
+	return true;
+}
+
+bool RasterStatistics::LoadSidecar(const FString &File, const FString &Key, FRasterStatistics &OutStatistics)
+{
+	TUniquePtr<FArchive> FileReader(IFileManager::Get().CreateFileReader(*(File + SidecarExtension()), FILEREAD_Silent));
+	if (!FileReader) return false;
+
+	int32 Version = 0;
+	FString SidecarKey;
+	*FileReader << Version;
+	if (Version != SidecarVersion) return false;
+
+	*FileReader << SidecarKey;
+	if (SidecarKey != Key) return false;
+
+	*FileReader << OutStatistics;
+	return FileReader->Close() && !FileReader->IsError();
+}
+
+void RasterStatistics::SaveSidecar(const FString &File, const FString &Key, FRasterStatistics &Statistics)
+{
+	TUniquePtr<FArchive> FileWriter(IFileManager::Get().CreateFileWriter(*(File + SidecarExtension()), FILEWRITE_Silent));
+	if (FileWriter)
+	{
+		int32 Version = SidecarVersion;
+		FString SidecarKey = Key;
+		*FileWriter << Version;
+		*FileWriter << SidecarKey;
+		*FileWriter << Statistics;
+		if (FileWriter->Close()) return;
+	}
+
+	// the folder of the raster might be read-only, in which case the statistics are only cached in memory
+	UE_LOG(LogGDALInterface, Log, TEXT("Could not save the statistics of %s next to it"), *File);
+}
+
+bool RasterStatistics::Get(const FString &File, FRasterStatistics &OutStatistics)
+{
+	TArray<FRasterStatistics> Statistics;
+	if (!Get({ File }, Statistics)) return false;
+	OutStatistics = Statistics[0];
+	return true;
+}
+
+bool RasterStatistics::Get(const TArray<FString> &Files, TArray<FRasterStatistics> &OutStatistics)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("RasterStatistics::Get");
+
+	const int32 NumFiles = Files.Num();
+	OutStatistics.SetNum(NumFiles);
+
+	TArray<FString> Errors;
+	Errors.SetNum(NumFiles);
+
+	std::atomic<int32> NumComputed = 0;
+
+	ParallelFor(NumFiles, [&](int32 i)
+	{
+		const FString &File = Files[i];
+
+		if (IsVirtual(File))
+		{
+			if (Compute(File, OutStatistics[i], Errors[i])) NumComputed++;
+			return;
+		}
+
+		FString Key;
+		if (!GetKey(File, Key))
+		{
+			Errors[i] = "File not found";
+			return;
+		}
+
+		{
+			FScopeLock Lock(&StatisticsLock);
+			if (TPair<FString, FRasterStatistics> *Cached = StatisticsCache.Find(File))
+			{
+				if (Cached->Key == Key)
+				{
+					OutStatistics[i] = Cached->Value;
+					return;
+				}
+			}
+		}
+
+		if (!LoadSidecar(File, Key, OutStatistics[i]))
+		{
+			if (!Compute(File, OutStatistics[i], Errors[i])) return;
+			SaveSidecar(File, Key, OutStatistics[i]);
+			NumComputed++;
+		}
+
+		FScopeLock Lock(&StatisticsLock);
+		StatisticsCache.Add(File, TPair<FString, FRasterStatistics>(Key, OutStatistics[i]));
+	});
+
+	for (int32 i = 0; i < NumFiles; i++)
+	{
+		if (!Errors[i].IsEmpty())
+		{
+			LCReporter::ShowError(
+				FText::Format(LOCTEXT("RasterStatistics::Get", "Could not compute the statistics of file '{0}'.\n{1}"),
+					FText::FromString(Files[i]),
+					FText::FromString(Errors[i])
+				)
+			);
+			return false;
+		}
+	}
+
+	UE_LOG(LogGDALInterface, Log, TEXT("Got the statistics of %d files, %d of which were not cached"), NumFiles, NumComputed.load());
+	return true;
+}
+
+bool RasterStatistics::GetMinMax(const TArray<FString> &Files, FVector2D &OutMinMax)
+{
+	OutMinMax[0] = DBL_MAX;
+	OutMinMax[1] = -DBL_MAX;
+
+	TArray<FRasterStatistics> Statistics;
+	if (!Get(Files, Statistics)) return false;
+
+	for (const FRasterStatistics &FileStatistics : Statistics)
+	{
+		if (!FileStatistics.HasValidPixels()) continue;
+		OutMinMax[0] = FMath::Min(OutMinMax[0], FileStatistics.Min);
+		OutMinMax[1] = FMath::Max(OutMinMax[1], FileStatistics.Max);
+	}
+
+	if (OutMinMax[0] > OutMinMax[1])
+	{
+		LCReporter::ShowError(
+			LOCTEXT("RasterStatistics::GetMinMax", "Could not compute the min and max values of the rasters, as all their pixels are no-data.")
+		);
+		return false;
+	}
+
+	return true;
+}
+
+void RasterStatistics::InvalidateDirectory(const FString &Dir)
+{
+	FString Prefix = Dir;
+	if (!Prefix.EndsWith("/")) Prefix += "/";
+
+	FScopeLock Lock(&StatisticsLock);
+	for (auto It = StatisticsCache.CreateIterator(); It; ++It)
+	{
+		if (It.Key().StartsWith(Prefix)) It.RemoveCurrent();
+	}
+}
+
+void RasterStatistics::ClearCache()
+{
+	FScopeLock Lock(&StatisticsLock);
+	StatisticsCache.Empty();
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -1,6 +1,7 @@
 // Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
 
 #include "GDALInterfaceModule.h"
+#include "GDALInterface/GDALInterface.h"
 #include "GDALInterface/LogGDALInterface.h"
 #include "Interfaces/IPluginManager.h"
 #include "Misc/Paths.h"
@@ -107,6 +108,11 @@ void FGDALInterfaceModule::StartupModule()
 	SetGDALPaths();
 }
 
+void FGDALInterfaceModule::ShutdownModule()
+{
+	GDALInterface::ClearTransformCache();
+}
+
 #undef LOCTEXT_NAMESPACE
 	
 IMPLEMENT_MODULE(FGDALInterfaceModule, GDALInterface)
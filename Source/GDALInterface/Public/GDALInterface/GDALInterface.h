@@ -36,14 +36,28 @@ public:
 	static bool GetCoordinates(FVector4d& Coordinates, FString File);
 	static bool GetCoordinates(FVector4d& Coordinates, TArray<FString> Files);
 	static OGRCoordinateTransformation *MakeTransform(FString InCRS, FString OutCRS);
+
+	/* Returns a transformation from a cache keyed by the pair of CRS, instead of creating a new one.
+	 * Each thread gets its own copy of the transformation (and thus uses its own PROJ context), kept in thread-local
+	 * storage and freed when the thread exits, so the result must only be used on the calling thread, and must not be deleted. */
+	static OGRCoordinateTransformation *GetCachedTransform(FString InCRS, FString OutCRS);
+	static void ClearTransformCache();
+
 	static bool Transform(OGRCoordinateTransformation* CoordinateTransformation, double *Longitude, double *Latitude);
 	static bool Transform2(OGRCoordinateTransformation* CoordinateTransformation, double *xs, double *ys);
+
+	/* Transforms all the points in a single call to the transformation */
+	static bool TransformPoints(OGRCoordinateTransformation* CoordinateTransformation, int64 NumPoints, double *xs, double *ys);
+	static bool TransformPoints(OGRCoordinateTransformation* CoordinateTransformation, TArray<FVector2D> &Points);
+
 	static bool ConvertCoordinates(double *Longitude, double *Latitude, FString InCRS, FString OutCRS);
 	static bool ConvertCoordinates2(double *xs, double *ys, FString InCRS, FString OutCRS);
+	static bool ConvertPoints(TArray<FVector2D> &Points, FString InCRS, FString OutCRS);
 	static bool ConvertCoordinates(FVector4d& OriginalCoordinates, FVector4d& NewCoordinates, FString InCRS, FString OutCRS);
 	static bool ConvertCoordinates(FVector4d& OriginalCoordinates, bool bCrop, FVector4d& NewCoordinates, FString InCRS, FString OutCRS);
 	static bool ConvertCoordinates(FVector4d& OriginalCoordinates, bool bCrop, FVector4d& NewCoordinates, OGRSpatialReference InRs, OGRSpatialReference OutRs);
 	static bool GetPixels(FIntPoint &Pixels, FString File);
+	/* Uses the statistics cached by RasterStatistics, which are computed for all files in parallel if needed */
 	static bool GetMinMax(FVector2D &MinMax, TArray<FString> Files);
 	static bool ConvertToPNG(FString SourceFile, FString TargetFile, int MinAltitude, int MaxAltitude, int PrecisionPercent = 100);
 	static bool ConvertToPNG(FString SourceFile, FString TargetFile);
@@ -59,6 +73,10 @@ public:
 	static bool ReadColorsFromFile(FString File, int &OutWidth, int &OutHeight, TArray<FColor> &OutColors);
 	static bool ReadHeightmapFromFile(FString File, int& OutWidth, int& OutHeight, TArray<float>& OutHeightmap);
 
+	/* Reads the heightmap and maps the altitudes from [MinAltitude, MaxAltitude] to [0, 65535], like ConvertToPNG does,
+	 * but without writing and decoding an intermediate PNG file */
+	static bool ReadHeightmapFromFile(FString File, double MinAltitude, double MaxAltitude, int& OutWidth, int& OutHeight, TArray<uint16>& OutHeightmap);
+
 	static TMap<FString, FString> FieldsFromFeature(OGRFeature* Feature);
 	static TArray<FPointList> GetPointLists(GDALDataset *Dataset, TSet<FString> &AlreadyHandledFeatures);
 	static void AddPointList(OGRLineString* LineString, TArray<FPointList> &PointLists, TMap<FString, FString> &Fields);
@@ -72,12 +90,24 @@ public:
 	static GDALDataset* LoadGDALVectorDatasetFromFile(const FString &File);
 	static GDALDataset* LoadGDALVectorDatasetFromQuery(FString Query, bool bIsUserInitiated);
 
+	/* The format is chosen from the extension of the file: binary PLY (.ply), glTF binary (.glb), or DXF otherwise.
+	 * PLY and GLB files are written directly in large chunks, without going through GDAL. */
 	static bool ExportMesh(const FDynamicMesh3 &Mesh, const FString &File);
+	static bool ExportMeshToPLY(const FDynamicMesh3 &Mesh, const FString &File);
+	static bool ExportMeshToGLB(const FDynamicMesh3 &Mesh, const FString &File);
+	static bool ExportMeshToDXF(const FDynamicMesh3 &Mesh, const FString &File);
+
+	/* Binary PLY (.ply) or DXF otherwise */
 	static bool ExportPolygons(const TArray<TArray<FVector>> &PointLists, const FString &File);
+	static bool ExportPolygonsToPLY(const TArray<TArray<FVector>> &PointLists, const FString &File);
+	static bool ExportPolygonsToDXF(const TArray<TArray<FVector>> &PointLists, const FString &File);
 	static bool WriteHeightmapDataToTIF(const FString& File, int32 SizeX, int32 SizeY, uint16* HeightmapData);
 
 	// returns false if feature was already there, and true otherwise
 	static bool AddFeature(TSet<FString> &AlreadyHandledFeatures, OGRFeature *Feature);
+
+private:
+	static bool ConvertBounds(OGRCoordinateTransformation* CoordinateTransformation, FVector4d& OriginalCoordinates, bool bCrop, FVector4d& NewCoordinates);
 };
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
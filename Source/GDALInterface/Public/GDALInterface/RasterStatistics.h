@@ -0,0 +1,56 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/* Statistics of the first band of a raster file. No-data pixels are not taken into account for the min, max and histogram. */
+struct FRasterStatistics
+{
+	double Min = DBL_MAX;
+	double Max = -DBL_MAX;
+	int64 NumPixels = 0;
+	int64 NumNoDataPixels = 0;
+
+	// Histogram[i] is the number of pixels with a value in [HistogramMin + i * BucketSize, HistogramMin + (i + 1) * BucketSize)
+	double HistogramMin = 0;
+	TArray<int64> Histogram;
+
+	bool HasValidPixels() const { return NumPixels > NumNoDataPixels; }
+
+	friend FArchive& operator<<(FArchive& Ar, FRasterStatistics& Statistics)
+	{
+		Ar << Statistics.Min << Statistics.Max << Statistics.NumPixels << Statistics.NumNoDataPixels;
+		Ar << Statistics.HistogramMin << Statistics.Histogram;
+		return Ar;
+	}
+};
+
+/* Computes the statistics of raster files in a single streaming pass over their blocks, and caches them
+ * in memory and in a file next to the raster, keyed by the path, modification time and size of the raster.
+ * Later stages and later runs reuse the cached statistics instead of reading the rasters again.
+ * Files in GDAL's virtual file systems (/vsimem/...) are transient, and their statistics are never cached. */
+class GDALINTERFACE_API RasterStatistics
+{
+public:
+	static constexpr double BucketSize = 1;
+	static const TCHAR* SidecarExtension() { return TEXT(".lcstats"); }
+
+	static bool Get(const FString &File, FRasterStatistics &OutStatistics);
+
+	/* Files are processed in parallel */
+	static bool Get(const TArray<FString> &Files, TArray<FRasterStatistics> &OutStatistics);
+
+	/* Min and max values over all files, fails when all pixels are no-data */
+	static bool GetMinMax(const TArray<FString> &Files, FVector2D &OutMinMax);
+
+	/* Drops the statistics cached in memory for the files of the directory, which is about to be rewritten */
+	static void InvalidateDirectory(const FString &Dir);
+
+	static void ClearCache();
+
+private:
+	static bool Compute(const FString &File, FRasterStatistics &OutStatistics, FString &OutError);
+	static bool LoadSidecar(const FString &File, const FString &Key, FRasterStatistics &OutStatistics);
+	static void SaveSidecar(const FString &File, const FString &Key, FRasterStatistics &Statistics);
+};
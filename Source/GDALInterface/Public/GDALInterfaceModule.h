@@ -12,6 +12,7 @@ class GDALINTERFACE_API FGDALInterfaceModule : public IModuleInterface
 public:
 	static void SetGDALPaths();
 	virtual void StartupModule() override;
+	virtual void ShutdownModule() override;
 
 	static inline FString PluginDir = "";
 };
@@ -12,6 +12,7 @@
 #include "LandscapeDataAccess.h"
 #include "Curves/RichCurve.h"
 #include "Misc/MessageDialog.h"
+#include "Async/ParallelFor.h"
 
 #if WITH_EDITOR
 #include "ScopedTransaction.h"
@@ -32,6 +33,31 @@ UBlendLandscape::UBlendLandscape()
 
 #if WITH_EDITOR
 
+namespace
+{
+	/* Samples the curve once for every possible (integer) distance from the border, so that it is not evaluated for each pixel */
+	TArray<double> SampleDistanceCurve(const UCurveFloat *Curve, double MaxDistance)
+	{
+		TArray<double> Alphas;
+		Alphas.SetNumUninitialized(FMath::CeilToInt32(MaxDistance) + 1);
+		for (int32 Distance = 0; Distance < Alphas.Num(); Distance++)
+		{
+			Alphas[Distance] = Curve->GetFloatValue(Distance / MaxDistance);
+		}
+		return Alphas;
+	}
+
+	struct FHeightmapRect
+	{
+		int32 X1, Y1, X2, Y2;
+
+		int32 SizeX() const { return X2 - X1 + 1; }
+		int32 SizeY() const { return Y2 - Y1 + 1; }
+		bool IsEmpty() const { return X2 < X1 || Y2 < Y1; }
+		bool Contains(int32 X, int32 Y) const { return X1 <= X && X <= X2 && Y1 <= Y && Y <= Y2; }
+	};
+}
+
 bool UBlendLandscape::BlendWithLandscape(bool bIsUserInitiated)
 {
 	ALandscape *Landscape = Cast<ALandscape>(GetOwner());
@@ -90,11 +116,17 @@ bool UBlendLandscape::BlendWithLandscape(bool bIsUserInitiated)
 		MinMaxY[0] <= OtherMinMaxY[1] && OtherMinMaxY[0] <= MinMaxY[1]
 	)
 	{
+		if (!IsValid(DegradeThisData) || !IsValid(DegradeOtherData))
+		{
+			LCReporter::ShowError(
+				LOCTEXT("UBlendLandscape::BlendWithLandscape::Curves", "Please set the DegradeThisData and DegradeOtherData curves of the blend landscape option")
+			);
+			return false;
+		}
+
 		int32 SizeX = Landscape->ComputeComponentCounts().X * Landscape->ComponentSizeQuads + 1;
 		int32 SizeY = Landscape->ComputeComponentCounts().Y * Landscape->ComponentSizeQuads + 1;
-		uint16* OldHeightmapData = (uint16*) malloc(SizeX * SizeY * (sizeof (uint16)));
 		FHeightmapAccessor<false> HeightmapAccessor(Landscape->GetLandscapeInfo());
-		HeightmapAccessor.GetDataFast(0, 0, SizeX - 1, SizeY - 1, OldHeightmapData);
 
 		FTransform OtherToGlobal = OtherLandscape->GetTransform();
 		FTransform GlobalToOther = OtherToGlobal.Inverse();
@@ -128,41 +160,81 @@ bool UBlendLandscape::BlendWithLandscape(bool bIsUserInitiated)
 			*OtherLandscape->GetActorNameOrLabel(), OtherX1, OtherX2, OtherY1, OtherY2
 		);
 
-		uint16* OtherOldHeightmapData = (uint16*) malloc(OtherSizeX * OtherSizeY * (sizeof (uint16)));
-		OtherHeightmapAccessor.GetDataFast(OtherX1, OtherY1, OtherX2, OtherY2, OtherOldHeightmapData);
+		/* The mapping from the other landscape to this one is affine, so positions are obtained by adding steps to an origin */
+
+		const FMatrix OtherToThis = OtherToGlobal.ToMatrixWithScale() * ThisToGlobal.ToMatrixWithScale().Inverse();
+		const FVector OtherOriginInThis = OtherToThis.TransformPosition(FVector(OtherX1, OtherY1, 0));
+		const FVector OtherStepXInThis = OtherToThis.TransformVector(FVector(1, 0, 0));
+		const FVector OtherStepYInThis = OtherToThis.TransformVector(FVector(0, 1, 0));
+
+		auto OtherPositionInThis = [&](int X, int Y) -> FVector
+		{
+			return OtherOriginInThis + X * OtherStepXInThis + Y * OtherStepYInThis;
+		};
+
+		// only the data of this landscape in the overlap with the other landscape rectangle is needed
+		FHeightmapRect Overlap = { SizeX, SizeY, -1, -1 };
+		{
+			FBox2D OverlapBounds(ForceInit);
+			for (const FVector &Corner : {
+				OtherPositionInThis(0, 0), OtherPositionInThis(OtherSizeX - 1, 0),
+				OtherPositionInThis(0, OtherSizeY - 1), OtherPositionInThis(OtherSizeX - 1, OtherSizeY - 1)
+			})
+			{
+				OverlapBounds += FVector2D(Corner.X, Corner.Y);
+			}
+
+			// positions are truncated as integers, with a margin for rounding errors
+			Overlap.X1 = FMath::Max(0, (int) OverlapBounds.Min.X - 1);
+			Overlap.Y1 = FMath::Max(0, (int) OverlapBounds.Min.Y - 1);
+			Overlap.X2 = FMath::Min(SizeX - 1, (int) OverlapBounds.Max.X + 1);
+			Overlap.Y2 = FMath::Min(SizeY - 1, (int) OverlapBounds.Max.Y + 1);
+		}
+
+		TArray<uint16> OverlapHeightmapData;
+		if (!Overlap.IsEmpty())
+		{
+			OverlapHeightmapData.SetNumUninitialized(Overlap.SizeX() * Overlap.SizeY());
+			HeightmapAccessor.GetDataFast(Overlap.X1, Overlap.Y1, Overlap.X2, Overlap.Y2, OverlapHeightmapData.GetData());
+		}
+
+		TArray<uint16> OtherOldHeightmapData;
+		OtherOldHeightmapData.SetNumUninitialized(OtherSizeX * OtherSizeY);
+		OtherHeightmapAccessor.GetDataFast(OtherX1, OtherY1, OtherX2, OtherY2, OtherOldHeightmapData.GetData());
 
 
 		/* Modify the data of the other landscape */
 		
 		double MaxDistance = ((double) FMath::Min(OtherSizeX, OtherSizeY)) / 2;
-		uint16* OtherNewHeightmapData = (uint16*) malloc(OtherSizeX * OtherSizeY * (sizeof (uint16)));
-		for (int X = 0; X < OtherSizeX; X++)
+		const TArray<double> OtherAlphas = SampleDistanceCurve(DegradeOtherData, MaxDistance);
+		TArray<uint16> OtherNewHeightmapData;
+		OtherNewHeightmapData.SetNumUninitialized(OtherSizeX * OtherSizeY);
+
+		ParallelFor(OtherSizeY, [&](int32 Y)
 		{
-			for (int Y = 0; Y < OtherSizeY; Y++)
+			for (int X = 0; X < OtherSizeX; X++)
 			{
-				FVector OtherPosition = FVector(OtherX1 + X, OtherY1 + Y, 0);
-				FVector GlobalPosition = OtherToGlobal.TransformPosition(OtherPosition);
-				FVector ThisPosition = GlobalToThis.TransformPosition(GlobalPosition);
-
-				int ThisX = ThisPosition.X;
-				int ThisY = ThisPosition.Y;
+				const FVector ThisPosition = OtherPositionInThis(X, Y);
+				const int ThisX = ThisPosition.X;
+				const int ThisY = ThisPosition.Y;
+				const int32 Index = X + Y * OtherSizeX;
 
 				// if this landscape has data at this position
-				if (ThisX >= 0 && ThisY >= 0 && ThisX < SizeX && ThisY < SizeY && OldHeightmapData[ThisX + ThisY * SizeX] != 0)
+				if (Overlap.Contains(ThisX, ThisY) && OverlapHeightmapData[(ThisX - Overlap.X1) + (ThisY - Overlap.Y1) * Overlap.SizeX()] != 0)
 				{
 					// we transform the data according to the curve
-					double DistanceFromBorder = FMath::Min(X, FMath::Min(Y, FMath::Min(OtherSizeX - X - 1, OtherSizeY - Y - 1)));
-					double DistanceRatio = DistanceFromBorder / MaxDistance;
-					double Alpha = DegradeOtherData->GetFloatValue(DistanceRatio);
-					OtherNewHeightmapData[X + Y * OtherSizeX] = Alpha * OtherOldHeightmapData[X + Y * OtherSizeX];
+					const int DistanceFromBorder = FMath::Min(X, FMath::Min(Y, FMath::Min(OtherSizeX - X - 1, OtherSizeY - Y - 1)));
+					OtherNewHeightmapData[Index] = OtherAlphas[DistanceFromBorder] * OtherOldHeightmapData[Index];
 				}
 				else
 				{					
 					// otherwise, we keep the old data
-					OtherNewHeightmapData[X + Y * OtherSizeX] = OtherOldHeightmapData[X + Y * OtherSizeX];
+					OtherNewHeightmapData[Index] = OtherOldHeightmapData[Index];
 				}
 			}
-		}
+		});
+
+		OverlapHeightmapData.Empty();
 
 #if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 3)
 		
@@ -174,7 +246,7 @@ bool UBlendLandscape::BlendWithLandscape(bool bIsUserInitiated)
 		{
 			/* Make the new data to be a difference, so that it can be used on a different edit layer (>= 5.3 only) */
 	
-			LandscapeUtils::MakeDataRelativeTo(OtherSizeX, OtherSizeY, OtherNewHeightmapData, OtherOldHeightmapData);
+			LandscapeUtils::MakeDataRelativeTo(OtherSizeX, OtherSizeY, OtherNewHeightmapData.GetData(), OtherOldHeightmapData.GetData());
 
 			/* Write difference data to a new edit layer (>= 5.3 only) */
 
@@ -185,9 +257,6 @@ bool UBlendLandscape::BlendWithLandscape(bool bIsUserInitiated)
 					LOCTEXT("UHeightmapModifier::ModifyHeightmap::10", "Could not create landscape layer. Make sure that edit layers are enabled on Landscape {0}."),
 					FText::FromString(OtherLandscape->GetActorNameOrLabel())
 				));
-				free(OldHeightmapData);
-				free(OtherOldHeightmapData);
-				free(OtherNewHeightmapData);
 				return false;
 			}
 
@@ -203,39 +272,67 @@ bool UBlendLandscape::BlendWithLandscape(bool bIsUserInitiated)
 #endif
 
 
-		OtherHeightmapAccessor.SetData(OtherX1, OtherY1, OtherX2, OtherY2, OtherNewHeightmapData);
-		free(OtherNewHeightmapData);
-
-		double ThisLandscapeZ = Landscape->GetActorLocation().Z;
-		double OtherLandscapeZ = OtherLandscape->GetActorLocation().Z;
-
-		double ThisLandscapeZScale = Landscape->GetActorScale3D().Z;
-		double OtherLandscapeZScale = OtherLandscape->GetActorScale3D().Z;
+		OtherHeightmapAccessor.SetData(OtherX1, OtherY1, OtherX2, OtherY2, OtherNewHeightmapData.GetData());
+		OtherOldHeightmapData.Empty();
+		OtherNewHeightmapData.Empty();
 		
 		/* Modify the data of this landscape */
+
+		// the data is unchanged where the curve is 1, so only the band along the border where it differs from 1 is modified
 		
 		double MaxDistance2 = ((double) FMath::Min(SizeX, SizeY)) / 2;
-		uint16* NewHeightmapData = (uint16*) malloc(SizeX * SizeY * (sizeof (uint16)));
-		for (int X = 0; X < SizeX; X++)
+		const TArray<double> ThisAlphas = SampleDistanceCurve(DegradeThisData, MaxDistance2);
+
+		int32 BandWidth = 0;
+		for (int32 Distance = 0; Distance < ThisAlphas.Num(); Distance++)
+		{
+			if (ThisAlphas[Distance] != 1) BandWidth = Distance + 1;
+		}
+
+		TArray<FHeightmapRect> BandRects;
+		if (2 * BandWidth >= FMath::Min(SizeX, SizeY))
+		{
+			BandRects.Add({ 0, 0, SizeX - 1, SizeY - 1 });
+		}
+		else if (BandWidth > 0)
+		{
+			BandRects.Add({ 0, 0, SizeX - 1, BandWidth - 1 });
+			BandRects.Add({ 0, SizeY - BandWidth, SizeX - 1, SizeY - 1 });
+			BandRects.Add({ 0, BandWidth, BandWidth - 1, SizeY - BandWidth - 1 });
+			BandRects.Add({ SizeX - BandWidth, BandWidth, SizeX - 1, SizeY - BandWidth - 1 });
+		}
+
+		UE_LOG(LogHeightmapModifier, Log, TEXT("Degrading a band of width %d along the border of Landscape %s"), BandWidth, *Landscape->GetActorNameOrLabel());
+
+		// all the old data is read before an edit layer is set on the accessor
+		TArray<TArray<uint16>> OldBandsData;
+		TArray<TArray<uint16>> NewBandsData;
+		for (const FHeightmapRect &Rect : BandRects)
+		{
+			TArray<uint16> &OldData = OldBandsData.AddDefaulted_GetRef();
+			OldData.SetNumUninitialized(Rect.SizeX() * Rect.SizeY());
+			HeightmapAccessor.GetDataFast(Rect.X1, Rect.Y1, Rect.X2, Rect.Y2, OldData.GetData());
+		}
+
+		for (int32 r = 0; r < BandRects.Num(); r++)
 		{
-			for (int Y = 0; Y < SizeY; Y++)
+			const FHeightmapRect &Rect = BandRects[r];
+			const TArray<uint16> &OldData = OldBandsData[r];
+			TArray<uint16> &NewData = NewBandsData.AddDefaulted_GetRef();
+			NewData.SetNumUninitialized(Rect.SizeX() * Rect.SizeY());
+
+			ParallelFor(Rect.SizeY(), [&](int32 j)
 			{
-				FVector ThisPosition = FVector(X, Y, 0);
-				FVector GlobalPosition = ThisToGlobal.TransformPosition(ThisPosition);
-				FVector OtherPosition = GlobalToOther.TransformPosition(GlobalPosition);
-
-				int OtherX = OtherPosition.X;
-				int OtherY = OtherPosition.Y;
-
-				int OtherXOffset = FMath::Max(FMath::Min(OtherX2, OtherX - OtherX1), 0);
-				int OtherYOffset = FMath::Max(FMath::Min(OtherY2, OtherY - OtherY1), 0);
-				
-				// we transform the data according to the curve
-				double DistanceFromBorder = FMath::Min(X, FMath::Min(Y, FMath::Min(SizeX - X - 1, SizeY - Y - 1)));
-				double DistanceRatio = DistanceFromBorder / MaxDistance2;
-				double Alpha = DegradeThisData->GetFloatValue(DistanceRatio);
-				NewHeightmapData[X + Y * SizeX] = Alpha * OldHeightmapData[X + Y * SizeX];
-			}
+				const int Y = Rect.Y1 + j;
+				for (int i = 0; i < Rect.SizeX(); i++)
+				{
+					const int X = Rect.X1 + i;
+
+					// we transform the data according to the curve
+					const int DistanceFromBorder = FMath::Min(X, FMath::Min(Y, FMath::Min(SizeX - X - 1, SizeY - Y - 1)));
+					NewData[i + j * Rect.SizeX()] = ThisAlphas[DistanceFromBorder] * OldData[i + j * Rect.SizeX()];
+				}
+			});
 		}
 
 
@@ -250,7 +347,10 @@ bool UBlendLandscape::BlendWithLandscape(bool bIsUserInitiated)
 		if (true)
 #endif
 		{
-			LandscapeUtils::MakeDataRelativeTo(SizeX, SizeY, NewHeightmapData, OldHeightmapData);
+			for (int32 r = 0; r < BandRects.Num(); r++)
+			{
+				LandscapeUtils::MakeDataRelativeTo(BandRects[r].SizeX(), BandRects[r].SizeY(), NewBandsData[r].GetData(), OldBandsData[r].GetData());
+			}
 	
 			int LayerIndex = Landscape->CreateLayer();
 			if (LayerIndex == INDEX_NONE)
@@ -259,9 +359,6 @@ bool UBlendLandscape::BlendWithLandscape(bool bIsUserInitiated)
 					LOCTEXT("UHeightmapModifier::ModifyHeightmap::10", "Could not create landscape layer. Make sure that edit layers are enabled on Landscape {0}."),
 					FText::FromString(Landscape->GetActorNameOrLabel())
 				));
-				free(OldHeightmapData);
-				free(NewHeightmapData);
-				free(OtherOldHeightmapData);
 				return false;
 			}
 
@@ -276,12 +373,11 @@ bool UBlendLandscape::BlendWithLandscape(bool bIsUserInitiated)
 	}
 #endif
 
-		free(OldHeightmapData);
-		free(OtherOldHeightmapData);
-
-		HeightmapAccessor.SetData(0, 0, SizeX - 1, SizeY - 1, NewHeightmapData);
-
-		free(NewHeightmapData);
+		// on a new edit layer, the data outside of the band is already neutral
+		for (int32 r = 0; r < BandRects.Num(); r++)
+		{
+			HeightmapAccessor.SetData(BandRects[r].X1, BandRects[r].Y1, BandRects[r].X2, BandRects[r].Y2, NewBandsData[r].GetData());
+		}
 
 		UE_LOG(LogHeightmapModifier, Log, TEXT("Finished blending with Landscape %s (MinX: %d, MaxX: %d, MinY: %d, MaxY: %d)"),
 			*OtherLandscape->GetActorNameOrLabel(), OtherX1, OtherX2, OtherY1, OtherY2
@@ -304,7 +400,7 @@ bool UBlendLandscape::BlendWithLandscape(bool bIsUserInitiated)
 				FAppStyle::GetBrush("Icons.InfoWithColor.Large")
 			);
 		}
-		return false;
+		return true;
 	}
 	else
 	{
@@ -4,6 +4,9 @@
 #include "ImageDownloader/LogImageDownloader.h"
 #include "LCCommon/LCSettings.h"
 #include "ConcurrencyHelpers/LCReporter.h"
+#include "GDALInterface/GDALInterface.h"
+#include "GDALInterface/RasterStatistics.h"
+#include "FileDownloader/TileCache.h"
 
 #include "HAL/PlatformFile.h"
 #include "Misc/MessageDialog.h"
@@ -22,6 +25,14 @@ void Directories::CouldNotInitializeDirectory(FString Dir)
 	);
 }
 
+bool Directories::ClearDirectory(const FString &Dir)
+{
+	RasterStatistics::InvalidateDirectory(Dir);
+	return
+		IPlatformFile::GetPlatformPhysical().DeleteDirectoryRecursively(*Dir) &&
+		IPlatformFile::GetPlatformPhysical().CreateDirectory(*Dir);
+}
+
 FString Directories::ImageDownloaderDir()
 {
 	FString Base = GetDefault<ULCSettings>()->TemporaryFolder;
@@ -65,4 +76,137 @@ FString Directories::DownloadDir()
 	}
 }
 
+FString Directories::TileCacheDir()
+{
+	FString ImageDownloaderDir = Directories::ImageDownloaderDir();
+	if (ImageDownloaderDir.IsEmpty()) return "";
+	return FPaths::Combine(ImageDownloaderDir, "TileCache");
+}
+
+bool Directories::ConfigureTileCache()
+{
+	const ULCSettings *Settings = GetDefault<ULCSettings>();
+	if (!Settings->bEnableTileCache) return false;
+
+	FString TileCacheDir = Directories::TileCacheDir();
+	if (TileCacheDir.IsEmpty()) return false;
+
+	TileCache::Configure(
+		TileCacheDir,
+		(int64) Settings->TileCacheMaxSizeMB * 1024 * 1024,
+		FTimespan::FromDays(Settings->TileCacheRevalidateAfterDays)
+	);
+	return TileCache::IsConfigured();
+}
+
+FString Directories::InMemoryDir()
+{
+	return "/vsimem/LandscapeCombinator/ImageDownloader";
+}
+
+bool Directories::IsInMemory(const FString &Path)
+{
+	return Path.StartsWith("/vsimem/");
+}
+
+FString Directories::ToInMemoryPath(const FString &DiskPath)
+{
+	FString Base = ImageDownloaderDir();
+	if (!Base.IsEmpty() && DiskPath.StartsWith(Base))
+	{
+		return InMemoryDir() + DiskPath.RightChop(Base.Len());
+	}
+	else
+	{
+		return FPaths::Combine(InMemoryDir(), FPaths::GetCleanFilename(DiskPath));
+	}
+}
+
+FString Directories::ToDiskPath(const FString &InMemoryPath)
+{
+	if (!InMemoryPath.StartsWith(InMemoryDir())) return "";
+
+	FString Base = ImageDownloaderDir();
+	if (Base.IsEmpty()) return "";
+
+	return Base + InMemoryPath.RightChop(InMemoryDir().Len());
+}
+
+bool Directories::ClearInMemoryDirectory(const FString &Dir)
+{
+	VSIRmdirRecursive(TCHAR_TO_UTF8(*Dir));
+	if (VSIMkdirRecursive(TCHAR_TO_UTF8(*Dir), 0755) != 0)
+	{
+		CouldNotInitializeDirectory(Dir);
+		return false;
+	}
+	return true;
+}
+
+void Directories::DeleteInMemoryDirectory(const FString &Dir)
+{
+	if (IsInMemory(Dir))
+	{
+		UE_LOG(LogImageDownloader, Log, TEXT("Releasing in-memory directory: %s"), *Dir);
+		VSIRmdirRecursive(TCHAR_TO_UTF8(*Dir));
+	}
+}
+
+bool Directories::WriteInMemoryFilesToDisk(TArray<FString> &Files)
+{
+	TSet<FString> ClearedDirs;
+	IPlatformFile &PlatformFile = IPlatformFile::GetPlatformPhysical();
+
+	for (FString &File : Files)
+	{
+		if (!IsInMemory(File)) continue;
+
+		FString DiskFile = ToDiskPath(File);
+		if (DiskFile.IsEmpty())
+		{
+			CouldNotInitializeDirectory(FPaths::GetPath(File));
+			return false;
+		}
+
+		// the mirrored directory might contain files from a previous run
+		FString DiskDir = FPaths::GetPath(DiskFile);
+		if (!ClearedDirs.Contains(DiskDir))
+		{
+			RasterStatistics::InvalidateDirectory(DiskDir);
+			if (!PlatformFile.DeleteDirectoryRecursively(*DiskDir) || !PlatformFile.CreateDirectoryTree(*DiskDir))
+			{
+				CouldNotInitializeDirectory(DiskDir);
+				return false;
+			}
+			ClearedDirs.Add(DiskDir);
+		}
+
+		UE_LOG(LogImageDownloader, Log, TEXT("Writing in-memory file %s to disk"), *File);
+
+		// VRTs are detected by driver, as some of them have a .tif extension (e.g. the output of HMMerge)
+		GDALDriverH Driver = GDALIdentifyDriver(TCHAR_TO_UTF8(*File), nullptr);
+		if (Driver && FString(GDALGetDriverShortName(Driver)) == "VRT")
+		{
+			// a VRT references other (in-memory) files, so we write its content instead
+			DiskFile = FPaths::ChangeExtension(DiskFile, "tif");
+			if (!GDALInterface::Translate(File, DiskFile, { "-of", "GTiff" })) return false;
+		}
+		else if (VSICopyFile(TCHAR_TO_UTF8(*File), TCHAR_TO_UTF8(*DiskFile), nullptr, static_cast<vsi_l_offset>(-1), nullptr, nullptr, nullptr) != 0)
+		{
+			LCReporter::ShowError(
+				FText::Format(
+					LOCTEXT("WriteInMemoryFilesToDisk", "Could not write in-memory file '{0}' to disk.\n{1}"),
+					FText::FromString(File),
+					FText::FromString(FString(CPLGetLastErrorMsg()))
+				)
+			);
+			return false;
+		}
+
+		File = DiskFile;
+	}
+
+	return true;
+}
+
 #undef LOCTEXT_NAMESPACE
@@ -78,7 +78,8 @@ bool HMListDownloader::OnFetch(FString InputCRS, TArray<FString> InputFiles)
 		[this, Lines](int i)
 		{
 			return Download::SynchronousFromURL(Lines[i], OutputFiles[i], bIsUserInitiated);
-		}
+		},
+		EConcurrencyResource::Network
 	);
 }
 
@@ -3,6 +3,7 @@
 #include "ImageDownloader/Downloaders/HMLocalFolder.h"
 #include "ImageDownloader/LogImageDownloader.h"
 #include "ConcurrencyHelpers/LCReporter.h"
+#include "GDALInterface/RasterStatistics.h"
 
 #include "HAL/FileManagerGeneric.h"
 #include "Misc/MessageDialog.h"
@@ -28,6 +29,8 @@ bool HMLocalFolder::OnFetch(FString InputCRS, TArray<FString> InputFiles)
 
 	for (auto& FileName : FileNames)
 	{
+		// statistics cached next to the rasters are not rasters themselves
+		if (FileName.EndsWith(RasterStatistics::SidecarExtension())) continue;
 		OutputFiles.Add(FPaths::Combine(Folder, FileName));
 	}
 	
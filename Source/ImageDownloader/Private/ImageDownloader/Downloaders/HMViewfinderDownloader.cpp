@@ -70,7 +70,8 @@ bool HMViewfinderDownloader::OnFetch(FString InputCRS, TArray<FString> InputFile
 				for (auto &HGTFile: HGTFiles) OutputFilesQueue.Enqueue(HGTFile);
 			}
 			return true;
-		}
+		},
+		EConcurrencyResource::Network
 	);
 
 	if (bSuccess)
@@ -7,6 +7,7 @@
 #include "ConcurrencyHelpers/LCReporter.h"
 
 #include "FileDownloader/Download.h"
+#include "FileDownloader/TileCache.h"
 #include "GDALInterface/GDALInterface.h"
 
 #include "HAL/FileManagerGeneric.h"
@@ -142,14 +143,21 @@ bool HMWMS::OnFetch(FString InputCRS, TArray<FString> InputFiles)
 
 	
 	TQueue<FString> OutputFilesQueue; // thread-safe
+	const bool bUseTileCache = Directories::ConfigureTileCache();
 
-	bool bSuccess = Concurrency::RunManyAndWait(
-		bEnableParallelDownload,
-		DownloadURLs.Num(),
-		[this, DownloadURLs, Bounds, FileNames, bGeoTiff, &OutputFilesQueue](int i)
+	LCCancellationToken Cancellation;
+
+	TFunction<bool(int)> FetchTile = [this, &DownloadURLs, &Bounds, &FileNames, bGeoTiff, bUseTileCache, &OutputFilesQueue](int i)
 		{
 			const FString FileName = FPaths::Combine(DownloadDir, FileNames[i]);
-			if (!Download::SynchronousFromURL(DownloadURLs[i], FileName, bIsUserInitiated)) return false;
+			if (bUseTileCache)
+			{
+				if (!TileCache::SynchronousFromURL(DownloadURLs[i], FileName, bIsUserInitiated)) return false;
+			}
+			else
+			{
+				if (!Download::SynchronousFromURL(DownloadURLs[i], FileName, bIsUserInitiated)) return false;
+			}
 
 			if (!bGeoTiff || !GDALInterface::HasCRS(FileName))
 			{
@@ -162,9 +170,23 @@ bool HMWMS::OnFetch(FString InputCRS, TArray<FString> InputFiles)
 				OutputFilesQueue.Enqueue(FileName);
 			}
 			return true;
-		}
+		};
+
+	bool bSuccess = Concurrency::RunManyAndWait(
+		bEnableParallelDownload,
+		DownloadURLs.Num(),
+		[&FetchTile, &Cancellation](int i)
+		{
+			if (FetchTile(i)) return true;
+			Cancellation.Cancel();
+			return false;
+		},
+		EConcurrencyResource::Network,
+		&Cancellation
 	);
 
+	if (bUseTileCache) TileCache::SaveManifest();
+
 	if (bSuccess)
 	{
 		FString Element;
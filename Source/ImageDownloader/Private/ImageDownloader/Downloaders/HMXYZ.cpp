@@ -8,6 +8,7 @@
 #include "ConcurrencyHelpers/Concurrency.h"
 #include "ConcurrencyHelpers/LCReporter.h"
 #include "FileDownloader/Download.h"
+#include "FileDownloader/TileCache.h"
 #include "GDALInterface/GDALInterface.h"
 #include "MapboxHelpers/MapboxHelpers.h"
 #include "LCCommon/LCSettings.h"
@@ -88,13 +89,12 @@ bool HMXYZ::OnFetch(FString InputCRS, TArray<FString> InputFiles)
 
 	bool *bShowedDialog = new bool(false);
 	TQueue<FString> OutputFilesQueue; // thread-safe
+	const bool bUseTileCache = Directories::ConfigureTileCache();
 
-	UE_LOG(LogImageDownloader, Log, TEXT("Downloading and Georeferencing %d tiles"), NumTiles);
-	bool bSuccess = Concurrency::RunManyAndWait(
-		bEnableParallelDownload,
-		NumTiles,
+	// once a tile has failed, the whole fetch fails, so the tiles which are not started yet are cancelled
+	LCCancellationToken Cancellation;
 
-		[this, bShowedDialog, NumTiles, &OutputFilesQueue](int i)
+	TFunction<bool(int)> FetchTile = [this, bShowedDialog, NumTiles, bUseTileCache, &OutputFilesQueue](int i)
 		{
 			int X = i % (MaxX - MinX + 1) + MinX;
 			int Y = i / (MaxX - MinX + 1) + MinY;
@@ -109,8 +109,44 @@ bool HMXYZ::OnFetch(FString InputCRS, TArray<FString> InputFiles)
 
 			FString FileName = FString::Format(TEXT("{0}_x{1}_y{2}"), { Name, XOffset, YOffset });
 
-			if (!Download::SynchronousFromURL(ReplacedURL, DownloadFile, bIsUserInitiated && NumTiles < 20)) return false;
+			const bool bProgress = bIsUserInitiated && NumTiles < 20;
+			if (bUseTileCache)
+			{
+				if (!TileCache::SynchronousFromURL(ReplacedURL, DownloadFile, bProgress)) return false;
+			}
+			else
+			{
+				if (!Download::SynchronousFromURL(ReplacedURL, DownloadFile, bProgress)) return false;
+			}
 			
+			// decode and georeference in a single step, writing only one file per tile
+			if (bDecodeMapbox && bGeoreferenceSlippyTiles && !Format.Contains("."))
+			{
+				double MinLong, MaxLong, MinLat, MaxLat;
+				GDALInterface::XYZTileToEPSG3857(X, Y, Zoom, MinLong, MaxLat);
+				GDALInterface::XYZTileToEPSG3857(X+1, Y+1, Zoom, MaxLong, MinLat);
+
+				FString OutputFile = FPaths::Combine(OutputDir, FileName + ".tif");
+				if (!MapboxHelpers::DecodeMapboxThreeBandsGeoreferenced(
+					DownloadFile, OutputFile, bUseTerrariumFormula, bShowedDialog,
+					"EPSG:3857", MinLong, MaxLong, MinLat, MaxLat
+				))
+				{
+					LCReporter::ShowOneError(
+						FText::Format(
+							LOCTEXT("HMXYZ::Fetch::Decode", "Could not decode file {0}."),
+							FText::FromString(DownloadFile)
+						),
+						bShowedDialog
+					);
+					return bAllowInvalidTiles;
+				}
+
+				UE_LOG(LogImageDownloader, Log, TEXT("Adding file: %s"), *OutputFile);
+				OutputFilesQueue.Enqueue(OutputFile);
+				return true;
+			}
+
 			FString DecodedFile = DownloadFile;
 
 			if (bDecodeMapbox)
@@ -180,10 +216,24 @@ bool HMXYZ::OnFetch(FString InputCRS, TArray<FString> InputFiles)
 			}
 
 			return true;
-		}
+		};
+
+	UE_LOG(LogImageDownloader, Log, TEXT("Downloading and Georeferencing %d tiles"), NumTiles);
+	bool bSuccess = Concurrency::RunManyAndWait(
+		bEnableParallelDownload,
+		NumTiles,
+		[&FetchTile, &Cancellation](int i)
+		{
+			if (FetchTile(i)) return true;
+			Cancellation.Cancel();
+			return false;
+		},
+		EConcurrencyResource::Network,
+		&Cancellation
 	);
 
 	if (bShowedDialog) delete(bShowedDialog);
+	if (bUseTileCache) TileCache::SaveManifest();
 
 	if (bSuccess)
 	{
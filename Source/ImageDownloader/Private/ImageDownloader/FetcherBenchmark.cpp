@@ -0,0 +1,128 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#include "ImageDownloader/ImageDownloader.h"
+#include "ImageDownloader/Directories.h"
+#include "ImageDownloader/FetcherMetrics.h"
+#include "ImageDownloader/HMFetcher.h"
+#include "GDALInterface/GDALInterface.h"
+
+#include "HAL/PlatformFileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+/* Runs the fetcher chains of LocalFile and LocalFolder sources on synthetic heightmaps of several sizes,
+ * and writes the metrics of each run to ImageDownloaderDir/Metrics/Benchmark-<Source>-<Size>.csv.
+ * Run it from the Session Frontend or with `Automation RunTests LandscapeCombinator.ImageDownloader.FetcherBenchmark`. */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FFetcherBenchmarkTest, "LandscapeCombinator.ImageDownloader.FetcherBenchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter
+)
+
+namespace
+{
+	const int Sizes[] = { 256, 1024, 4096 };
+
+	/* Writes a Float32 GeoTIFF in EPSG:4326, with smooth hills so that the compression and the statistics are realistic */
+	bool WriteSyntheticHeightmap(const FString &File, int Size, double MinLong, double MaxLat, double Degrees)
+	{
+		GDALDriver *TIFDriver = GetGDALDriverManager()->GetDriverByName("GTiff");
+		if (!TIFDriver) return false;
+
+		GDALDataset *Dataset = TIFDriver->Create(TCHAR_TO_UTF8(*File), Size, Size, 1, GDT_Float32, nullptr);
+		if (!Dataset) return false;
+
+		double GeoTransform[6] = { MinLong, Degrees / Size, 0, MaxLat, 0, -Degrees / Size };
+		OGRSpatialReference Srs;
+		bool bSuccess =
+			Dataset->SetGeoTransform(GeoTransform) == CE_None &&
+			GDALInterface::SetCRSFromEPSG(Srs, 4326) &&
+			Dataset->SetSpatialRef(&Srs) == CE_None;
+
+		TArray<float> Row;
+		Row.SetNumUninitialized(Size);
+		for (int Y = 0; bSuccess && Y < Size; Y++)
+		{
+			for (int X = 0; X < Size; X++)
+			{
+				const double Long = MinLong + X * Degrees / Size;
+				const double Lat = MaxLat - Y * Degrees / Size;
+				Row[X] = 1000 + 500 * FMath::Sin(Long * 40) * FMath::Cos(Lat * 40);
+			}
+			bSuccess = Dataset->GetRasterBand(1)->RasterIO(GF_Write, 0, Y, Size, 1, Row.GetData(), Size, 1, GDT_Float32, 0, 0) == CE_None;
+		}
+
+		GDALClose(Dataset);
+		return bSuccess;
+	}
+
+	bool RunChain(FAutomationTestBase &Test, UImageDownloader *ImageDownloader, const FString &Name)
+	{
+		HMFetcher *Fetcher = ImageDownloader->CreateFetcher(false, Name, false, true, true, false, false, nullptr, nullptr);
+		if (!Fetcher) return false;
+
+		const bool bSuccess = Fetcher->Fetch("", {});
+		const TArray<FFetcherStageMetrics> Report = Fetcher->MetricsReport ? Fetcher->MetricsReport->GetReport() : TArray<FFetcherStageMetrics>();
+		delete Fetcher;
+
+		double WallSeconds = 0;
+		for (const FFetcherStageMetrics &Metrics : Report) WallSeconds += Metrics.WallSeconds;
+		Test.AddInfo(FString::Printf(TEXT("%s: %.3f s in %d phases"), *Name, WallSeconds, Report.Num()));
+
+		return bSuccess;
+	}
+}
+
+bool FFetcherBenchmarkTest::RunTest(const FString &Parameters)
+{
+	const FString ImageDownloaderDir = Directories::ImageDownloaderDir();
+	if (!TestFalse(TEXT("ImageDownloaderDir is set"), ImageDownloaderDir.IsEmpty())) return false;
+
+	const FString BenchmarkDir = FPaths::Combine(ImageDownloaderDir, "Benchmark");
+	IPlatformFile &PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.DeleteDirectoryRecursively(*BenchmarkDir);
+
+	UImageDownloader *ImageDownloader = NewObject<UImageDownloader>();
+	ImageDownloader->CRS = "EPSG:4326";
+	FetcherMetrics::SetCountOutputPixels(true);
+
+	for (int Size : Sizes)
+	{
+		// one file covering one degree
+		const FString FileDir = FPaths::Combine(BenchmarkDir, FString::Printf(TEXT("File%d"), Size));
+		const FString File = FPaths::Combine(FileDir, "Heightmap.tif");
+		if (!TestTrue(TEXT("Create file directory"), PlatformFile.CreateDirectoryTree(*FileDir))) break;
+		if (!TestTrue(TEXT("Write synthetic heightmap"), WriteSyntheticHeightmap(File, Size, 6, 46, 1))) break;
+
+		ImageDownloader->ImageSourceKind = EImageSourceKind::LocalFile;
+		ImageDownloader->LocalFilePath = File;
+		ImageDownloader->bMergeImages = false;
+		TestTrue(FString::Printf(TEXT("LocalFile chain with size %d"), Size), RunChain(*this, ImageDownloader, FString::Printf(TEXT("Benchmark-LocalFile-%d"), Size)));
+
+		// the same degree split in 2x2 tiles, which are merged
+		const FString FolderDir = FPaths::Combine(BenchmarkDir, FString::Printf(TEXT("Folder%d"), Size));
+		if (!TestTrue(TEXT("Create folder directory"), PlatformFile.CreateDirectoryTree(*FolderDir))) break;
+		bool bTilesWritten = true;
+		for (int X = 0; X < 2; X++)
+		{
+			for (int Y = 0; Y < 2; Y++)
+			{
+				const FString Tile = FPaths::Combine(FolderDir, FString::Printf(TEXT("Heightmap_x%d_y%d.tif"), X, Y));
+				bTilesWritten &= WriteSyntheticHeightmap(Tile, Size / 2, 6 + X * 0.5, 46 - Y * 0.5, 0.5);
+			}
+		}
+		if (!TestTrue(TEXT("Write synthetic tiles"), bTilesWritten)) break;
+
+		ImageDownloader->ImageSourceKind = EImageSourceKind::LocalFolder;
+		ImageDownloader->LocalFolderPath = FolderDir;
+		ImageDownloader->bMergeImages = true;
+		TestTrue(FString::Printf(TEXT("LocalFolder chain with size %d"), Size), RunChain(*this, ImageDownloader, FString::Printf(TEXT("Benchmark-LocalFolder-%d"), Size)));
+	}
+
+	FetcherMetrics::SetCountOutputPixels(false);
+	PlatformFile.DeleteDirectoryRecursively(*BenchmarkDir);
+	return true;
+}
+
+#endif
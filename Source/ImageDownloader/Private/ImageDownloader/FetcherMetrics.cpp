@@ -0,0 +1,160 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#include "ImageDownloader/FetcherMetrics.h"
+#include "ImageDownloader/LogImageDownloader.h"
+
+#include "GDALInterface/GDALInterface.h"
+
+#include "HAL/CriticalSection.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+
+#include <atomic>
+
+#if PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+	std::atomic<bool> bCountPixels = false;
+
+	double GetProcessCPUSeconds()
+	{
+#if PLATFORM_WINDOWS
+		FILETIME CreationTime, ExitTime, KernelTime, UserTime;
+		if (!GetProcessTimes(GetCurrentProcess(), &CreationTime, &ExitTime, &KernelTime, &UserTime)) return 0;
+		auto ToSeconds = [](const FILETIME &Time) {
+			return ((((uint64) Time.dwHighDateTime) << 32) | Time.dwLowDateTime) / 1e7;
+		};
+		return ToSeconds(KernelTime) + ToSeconds(UserTime);
+#else
+		struct rusage Usage;
+		if (getrusage(RUSAGE_SELF, &Usage) != 0) return 0;
+		return
+			Usage.ru_utime.tv_sec + Usage.ru_utime.tv_usec / 1e6 +
+			Usage.ru_stime.tv_sec + Usage.ru_stime.tv_usec / 1e6;
+#endif
+	}
+
+	/* Size of the files, which can be on disk or in GDAL's in-memory file system */
+	int64 GetFilesSize(const TArray<FString> &Files)
+	{
+		int64 Size = 0;
+		for (const FString &File : Files)
+		{
+			VSIStatBufL Stat;
+			if (VSIStatL(TCHAR_TO_UTF8(*File), &Stat) == 0) Size += Stat.st_size;
+		}
+		return Size;
+	}
+
+	int64 GetFilesPixels(const TArray<FString> &Files)
+	{
+		int64 Pixels = 0;
+		CPLPushErrorHandler(CPLQuietErrorHandler);
+		for (const FString &File : Files)
+		{
+			GDALDatasetH Dataset = GDALOpenEx(TCHAR_TO_UTF8(*File), GDAL_OF_RASTER | GDAL_OF_READONLY, nullptr, nullptr, nullptr);
+			if (!Dataset) continue;
+			Pixels += (int64) GDALGetRasterXSize(Dataset) * GDALGetRasterYSize(Dataset);
+			GDALClose(Dataset);
+		}
+		CPLPopErrorHandler();
+		return Pixels;
+	}
+}
+
+FString FFetcherStageMetrics::ToString() const
+{
+	return FString::Printf(
+		TEXT("Phase %s (%s): %.3f s wall, %.3f s process CPU, %d input files (%lld bytes), %d output files (%lld bytes, %lld pixels), GDAL cache +%lld bytes, process peak memory %llu MB"),
+		*Name, bSuccess ? TEXT("success") : TEXT("failure"), WallSeconds, ProcessCPUSeconds,
+		NumInputFiles, InputBytes, NumOutputFiles, OutputBytes, OutputPixels, GDALCacheBytes, ProcessPeakUsedPhysicalBytes / (1024 * 1024)
+	);
+}
+
+void FetcherMetrics::Begin(FFetcherStageMetrics &Metrics, const TArray<FString> &InputFiles)
+{
+	Metrics.NumInputFiles = InputFiles.Num();
+	Metrics.InputBytes = GetFilesSize(InputFiles);
+
+	// the values at the beginning of the phase are subtracted in End
+	Metrics.GDALCacheBytes = -GDALGetCacheUsed64();
+	Metrics.ProcessCPUSeconds = -GetProcessCPUSeconds();
+	Metrics.WallSeconds = -FPlatformTime::Seconds();
+}
+
+void FetcherMetrics::End(FFetcherStageMetrics &Metrics, const TArray<FString> &OutputFiles, bool bSuccess)
+{
+	Metrics.WallSeconds += FPlatformTime::Seconds();
+	Metrics.ProcessCPUSeconds += GetProcessCPUSeconds();
+	Metrics.GDALCacheBytes += GDALGetCacheUsed64();
+
+	Metrics.bSuccess = bSuccess;
+	Metrics.ProcessPeakUsedPhysicalBytes = FPlatformMemory::GetStats().PeakUsedPhysical;
+	Metrics.NumOutputFiles = OutputFiles.Num();
+	Metrics.OutputBytes = GetFilesSize(OutputFiles);
+	if (bCountPixels) Metrics.OutputPixels = GetFilesPixels(OutputFiles);
+
+	UE_LOG(LogImageDownloader, Log, TEXT("%s"), *Metrics.ToString());
+}
+
+void FetcherMetrics::SetCountOutputPixels(bool bCountOutputPixels)
+{
+	bCountPixels = bCountOutputPixels;
+}
+
+void FetcherMetrics::Reset()
+{
+	FScopeLock Lock(&ReportLock);
+	Report.Empty();
+}
+
+void FetcherMetrics::Add(const FFetcherStageMetrics &Metrics)
+{
+	FScopeLock Lock(&ReportLock);
+	Report.Add(Metrics);
+}
+
+TArray<FFetcherStageMetrics> FetcherMetrics::GetReport() const
+{
+	FScopeLock Lock(&ReportLock);
+	return Report;
+}
+
+void FetcherMetrics::LogReport() const
+{
+	TArray<FFetcherStageMetrics> CurrentReport = GetReport();
+	UE_LOG(LogImageDownloader, Log, TEXT("Metrics of %d fetcher phases:"), CurrentReport.Num());
+	for (const FFetcherStageMetrics &Metrics : CurrentReport)
+	{
+		UE_LOG(LogImageDownloader, Log, TEXT("%s"), *Metrics.ToString());
+	}
+}
+
+bool FetcherMetrics::WriteReport(const FString &File) const
+{
+	TArray<FString> Lines;
+	Lines.Add("Phase,Success,WallSeconds,ProcessCPUSeconds,NumInputFiles,InputBytes,NumOutputFiles,OutputBytes,OutputPixels,GDALCacheBytes,ProcessPeakUsedPhysicalBytes");
+	for (const FFetcherStageMetrics &Metrics : GetReport())
+	{
+		Lines.Add(FString::Printf(
+			TEXT("%s,%d,%f,%f,%d,%lld,%d,%lld,%lld,%lld,%llu"),
+			*Metrics.Name, Metrics.bSuccess ? 1 : 0, Metrics.WallSeconds, Metrics.ProcessCPUSeconds,
+			Metrics.NumInputFiles, Metrics.InputBytes, Metrics.NumOutputFiles, Metrics.OutputBytes, Metrics.OutputPixels,
+			Metrics.GDALCacheBytes, Metrics.ProcessPeakUsedPhysicalBytes
+		));
+	}
+
+	if (!FFileHelper::SaveStringArrayToFile(Lines, *File))
+	{
+		UE_LOG(LogImageDownloader, Error, TEXT("Could not write fetcher metrics to %s"), *File);
+		return false;
+	}
+	return true;
+}
@@ -2,6 +2,7 @@
 
 #include "ImageDownloader/HMDebugFetcher.h"
 #include "ImageDownloader/LogImageDownloader.h"
+#include "ImageDownloader/FetcherMetrics.h"
 #include "ConcurrencyHelpers/LCReporter.h"
 
 #include "Async/Async.h"
@@ -25,7 +26,15 @@ bool HMDebugFetcher::OnFetch(FString InputCRS, TArray<FString> InputFiles)
 	UE_LOG(LogImageDownloader, Log, TEXT("Running Phase %s on files:\n%s"), *Name, *FString::Join(InputFiles, TEXT("\n")));
 	UE_LOG(LogImageDownloader, Log, TEXT("InputCRS: %s"), *InputCRS);
 
-	if (Fetcher->Fetch(InputCRS, InputFiles))
+	FFetcherStageMetrics Metrics;
+	Metrics.Name = Name;
+	FetcherMetrics::Begin(Metrics, InputFiles);
+
+	const bool bSuccess = Fetcher->Fetch(InputCRS, InputFiles);
+	FetcherMetrics::End(Metrics, bSuccess ? Fetcher->OutputFiles : TArray<FString>(), bSuccess);
+	if (MetricsReport) MetricsReport->Add(Metrics);
+
+	if (bSuccess)
 	{
 		if (!this)
 		{
@@ -59,4 +68,24 @@ bool HMDebugFetcher::OnFetch(FString InputCRS, TArray<FString> InputFiles)
 	}
 }
 
+bool HMMetricsFetcher::OnFetch(FString InputCRS, TArray<FString> InputFiles)
+{
+	if (!Fetcher)
+	{
+		return false;
+	}
+
+	Report.Reset();
+	const bool bSuccess = Fetcher->Fetch(InputCRS, InputFiles);
+
+	Report.LogReport();
+	Report.WriteReport(FPaths::Combine(ImageDownloaderDir, "Metrics", Name + ".csv"));
+
+	if (!bSuccess) return false;
+
+	OutputFiles = Fetcher->OutputFiles;
+	OutputCRS = Fetcher->OutputCRS;
+	return true;
+}
+
 #undef LOCTEXT_NAMESPACE
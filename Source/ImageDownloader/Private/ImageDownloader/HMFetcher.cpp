@@ -41,6 +41,18 @@ bool HMAndThenFetcher::OnFetch(FString InputCRS, TArray<FString> InputFiles)
 		{
 			OutputCRS = Fetcher1->OutputCRS;
 		}
+
+		// the in-memory files of Fetcher1 are not needed anymore, unless Fetcher2 passed them through or references them
+		bool bFetcher1OutputsInUse = Fetcher2->KeepsReferencesToInputs();
+		for (const FString &File : Fetcher2->OutputFiles)
+		{
+			bFetcher1OutputsInUse = bFetcher1OutputsInUse || Fetcher1->OutputFiles.Contains(File);
+		}
+		if (!bFetcher1OutputsInUse)
+		{
+			Fetcher1->ReleaseInMemoryOutputs();
+		}
+
 		return true;
 	}
 	else
@@ -32,16 +32,19 @@
 #include "ImageDownloader/Transformers/HMPercentResolution.h"
 #include "ImageDownloader/Transformers/HMToPNG.h"
 #include "ImageDownloader/Transformers/HMMerge.h"
+#include "ImageDownloader/Transformers/HMMosaic.h"
 #include "ImageDownloader/Transformers/HMReadCRS.h"
 #include "ImageDownloader/Transformers/HMConvert.h"
 #include "ImageDownloader/Transformers/HMAddMissingTiles.h"
 #include "ImageDownloader/Transformers/HMFunction.h"
+#include "ImageDownloader/Transformers/HMWriteToDisk.h"
 
 #include "LCCommon/LCSettings.h"
 #include "Coordinates/LevelCoordinates.h"
 #include "LandscapeUtils/LandscapeUtils.h"
 #include "ConcurrencyHelpers/Concurrency.h"
 #include "ConcurrencyHelpers/LCReporter.h"
+#include "FileDownloader/TileCache.h"
 
 #include "Engine/World.h"
 #include "HAL/FileManagerGeneric.h"
@@ -97,6 +100,131 @@ TArray<FString> UImageDownloader::GetTitles()
 	return WMS_Provider.Titles;
 }
 
+bool UImageDownloader::GetXYZSource(bool bIsUserInitiated, FString &Layer, FString &Format, FString &URL2, bool &bGeoreferenceSlippyTiles2, bool &bMaxY_IsNorth2)
+{
+	if (IsMapbox())
+	{
+		if (bIsUserInitiated && !ShowMapboxFreeTierWarning()) return false;
+
+		FString MapboxToken2 = GetMapboxToken();
+		if (MapboxToken2.IsEmpty())
+		{
+			LCReporter::ShowError(
+				LOCTEXT("MapboxTokenMissing", "Please add a Mapbox Token (can be obtained from a free Mapbox account) in your Editor Preferences or in the Details Panel.")
+			); 
+			return false;
+		}
+
+		if (ImageSourceKind == EImageSourceKind::Mapbox_Heightmaps)
+		{
+			Layer = "MapboxTerrainDEMV1";
+			Format = "png";
+			if (Mapbox_2x)
+			{
+				URL2 = FString("https://api.mapbox.com/v4/mapbox.mapbox-terrain-dem-v1/{z}/{x}/{y}@2x.pngraw?access_token=") + MapboxToken2;
+			}
+			else
+			{
+				URL2 = FString("https://api.mapbox.com/v4/mapbox.mapbox-terrain-dem-v1/{z}/{x}/{y}.pngraw?access_token=") + MapboxToken2;
+			}
+
+			bGeoreferenceSlippyTiles2 = true;
+			bMaxY_IsNorth2 = false;
+		}
+		else if (ImageSourceKind == EImageSourceKind::Mapbox_Satellite)
+		{
+			Layer = "MapboxSatellite";
+			Format = "jpg";
+			if (Mapbox_2x)
+			{
+				URL2 = FString("https://api.mapbox.com/v4/mapbox.satellite/{z}/{x}/{y}@2x.jpg90?access_token=") + MapboxToken2;
+			}
+			else
+			{
+				URL2 = FString("https://api.mapbox.com/v4/mapbox.satellite/{z}/{x}/{y}.jpg90?access_token=") + MapboxToken2;
+			}
+
+			bGeoreferenceSlippyTiles2 = true;
+			bMaxY_IsNorth2 = false;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	else if (IsMapTiler())
+	{
+		if (bIsUserInitiated && !ShowMapTilerFreeTierWarning()) return false;
+
+		FString MapTilerToken2 = GetMapTilerToken();
+		if (MapTilerToken2.IsEmpty())
+		{
+			LCReporter::ShowError(
+				LOCTEXT("MapTilerTokenMissing", "Please add a MapTiler Token (can be obtained from a free MapTiler account) in your Editor Preferences or in the Details Panel.")
+			); 
+			return false;
+		}
+
+		if (ImageSourceKind == EImageSourceKind::MapTiler_Heightmaps)
+		{
+			Layer = "MapTilerTerrainRGB";
+			Format = "webp";
+			URL2 = FString("https://api.maptiler.com/tiles/terrain-rgb-v2/{z}/{x}/{y}.webp?key=") + MapTilerToken2;
+
+			bGeoreferenceSlippyTiles2 = true;
+			bMaxY_IsNorth2 = false;
+		}
+		else if (ImageSourceKind == EImageSourceKind::MapTiler_Satellite)
+		{
+			Layer = "MapTilerSatellite";
+			Format = "jpg";
+			URL2 = FString("https://api.maptiler.com/tiles/satellite-v2/{z}/{x}/{y}.jpg?key=") + MapTilerToken2;
+
+			bGeoreferenceSlippyTiles2 = true;
+			bMaxY_IsNorth2 = false;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	else if (IsNextZen())
+	{
+		FString NextZenToken2 = GetNextZenToken();
+		if (NextZenToken2.IsEmpty())
+		{
+			LCReporter::ShowError(
+				LOCTEXT("NextZenTokenMissing", "Please add a NextZen Token (can be obtained from a free NextZen account) in your Editor Preferences or in the Details Panel.")
+			); 
+			return false;
+		}
+
+		if (ImageSourceKind == EImageSourceKind::NextZen_Heightmaps)
+		{
+			Layer = "NextZenTerrainRGB";
+			Format = "png";
+			URL2 = FString("https://tile.nextzen.org/tilezen/terrain/v1/256/terrarium/{z}/{x}/{y}.png?api_key=") + NextZenToken2;
+
+			bGeoreferenceSlippyTiles2 = true;
+			bMaxY_IsNorth2 = false;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	else
+	{
+		Layer = XYZ_Name;
+		Format = XYZ_Format;
+		URL2 = XYZ_URL;
+		bGeoreferenceSlippyTiles2 = bGeoreferenceSlippyTiles;
+		bMaxY_IsNorth2 = bMaxY_IsNorth;
+	}
+
+	return true;
+}
+
 HMFetcher* UImageDownloader::CreateInitialFetcher(bool bIsUserInitiated, FString Name)
 {
 	switch (ImageSourceKind)
@@ -216,127 +344,11 @@ HMFetcher* UImageDownloader::CreateInitialFetcher(bool bIsUserInitiated, FString
 				bool bGeoreferenceSlippyTiles2;
 				bool bMaxY_IsNorth2;
 
-
-				if (IsMapbox())
-				{
-					if (bIsUserInitiated && !ShowMapboxFreeTierWarning()) return nullptr;
-
-					FString MapboxToken2 = GetMapboxToken();
-					if (MapboxToken2.IsEmpty())
-					{
-						LCReporter::ShowError(
-							LOCTEXT("MapboxTokenMissing", "Please add a Mapbox Token (can be obtained from a free Mapbox account) in your Editor Preferences or in the Details Panel.")
-						); 
-						return nullptr;
-					}
-
-					if (ImageSourceKind == EImageSourceKind::Mapbox_Heightmaps)
-					{
-						Layer = "MapboxTerrainDEMV1";
-						Format = "png";
-						if (Mapbox_2x)
-						{
-							URL2 = FString("https://api.mapbox.com/v4/mapbox.mapbox-terrain-dem-v1/{z}/{x}/{y}@2x.pngraw?access_token=") + MapboxToken2;
-						}
-						else
-						{
-							URL2 = FString("https://api.mapbox.com/v4/mapbox.mapbox-terrain-dem-v1/{z}/{x}/{y}.pngraw?access_token=") + MapboxToken2;
-						}
-
-						bGeoreferenceSlippyTiles2 = true;
-						bMaxY_IsNorth2 = false;
-					}
-					else if (ImageSourceKind == EImageSourceKind::Mapbox_Satellite)
-					{
-						Layer = "MapboxSatellite";
-						Format = "jpg";
-						if (Mapbox_2x)
-						{
-							URL2 = FString("https://api.mapbox.com/v4/mapbox.satellite/{z}/{x}/{y}@2x.jpg90?access_token=") + MapboxToken2;
-						}
-						else
-						{
-							URL2 = FString("https://api.mapbox.com/v4/mapbox.satellite/{z}/{x}/{y}.jpg90?access_token=") + MapboxToken2;
-						}
-
-						bGeoreferenceSlippyTiles2 = true;
-						bMaxY_IsNorth2 = false;
-					}
-					else
-					{
-						return nullptr;
-					}
-				}
-				else if (IsMapTiler())
-				{
-					if (bIsUserInitiated && !ShowMapTilerFreeTierWarning()) return nullptr;
-
-					FString MapTilerToken2 = GetMapTilerToken();
-					if (MapTilerToken2.IsEmpty())
-					{
-						LCReporter::ShowError(
-							LOCTEXT("MapTilerTokenMissing", "Please add a MapTiler Token (can be obtained from a free MapTiler account) in your Editor Preferences or in the Details Panel.")
-						); 
-						return nullptr;
-					}
-
-					if (ImageSourceKind == EImageSourceKind::MapTiler_Heightmaps)
-					{
-						Layer = "MapTilerTerrainRGB";
-						Format = "webp";
-						URL2 = FString("https://api.maptiler.com/tiles/terrain-rgb-v2/{z}/{x}/{y}.webp?key=") + MapTilerToken2;
-
-						bGeoreferenceSlippyTiles2 = true;
-						bMaxY_IsNorth2 = false;
-					}
-					else if (ImageSourceKind == EImageSourceKind::MapTiler_Satellite)
-					{
-						Layer = "MapTilerSatellite";
-						Format = "jpg";
-						URL2 = FString("https://api.maptiler.com/tiles/satellite-v2/{z}/{x}/{y}.jpg?key=") + MapTilerToken2;
-
-						bGeoreferenceSlippyTiles2 = true;
-						bMaxY_IsNorth2 = false;
-					}
-					else
-					{
-						return nullptr;
-					}
-				}
-				else if (IsNextZen())
-				{
-					FString NextZenToken2 = GetNextZenToken();
-					if (NextZenToken2.IsEmpty())
-					{
-						LCReporter::ShowError(
-							LOCTEXT("NextZenTokenMissing", "Please add a NextZen Token (can be obtained from a free NextZen account) in your Editor Preferences or in the Details Panel.")
-						); 
-						return nullptr;
-					}
-
-					if (ImageSourceKind == EImageSourceKind::NextZen_Heightmaps)
-					{
-						Layer = "NextZenTerrainRGB";
-						Format = "png";
-						URL2 = FString("https://tile.nextzen.org/tilezen/terrain/v1/256/terrarium/{z}/{x}/{y}.png?api_key=") + NextZenToken2;
-
-						bGeoreferenceSlippyTiles2 = true;
-						bMaxY_IsNorth2 = false;
-					}
-					else
-					{
-						return nullptr;
-					}
-				}
-				else
+				if (!GetXYZSource(bIsUserInitiated, Layer, Format, URL2, bGeoreferenceSlippyTiles2, bMaxY_IsNorth2))
 				{
-					Layer = XYZ_Name;
-					Format = XYZ_Format;
-					URL2 = XYZ_URL;
-					bGeoreferenceSlippyTiles2 = bGeoreferenceSlippyTiles;
-					bMaxY_IsNorth2 = bMaxY_IsNorth;
+					return nullptr;
 				}
-				
+
 				HMFetcher *Result = new HMDebugFetcher(
 					"XYZ_Download",
 					new HMXYZ(
@@ -368,6 +380,46 @@ HMFetcher* UImageDownloader::CreateInitialFetcher(bool bIsUserInitiated, FString
 	}
 }
 
+TFunction<bool(LCCancellationToken*)> UImageDownloader::MakePrefetchTask(const TArray<FTile> &Tiles)
+{
+	check(IsInGameThread());
+
+	if (!IsXYZ() || Tiles.IsEmpty() || !Directories::ConfigureTileCache()) return nullptr;
+
+	FString Layer, Format;
+	FString URL2;
+	bool bGeoreferenceSlippyTiles2;
+	bool bMaxY_IsNorth2;
+	if (!GetXYZSource(false, Layer, Format, URL2, bGeoreferenceSlippyTiles2, bMaxY_IsNorth2)) return nullptr;
+
+	TArray<FString> URLs;
+	URLs.Reserve(Tiles.Num());
+	for (const FTile &Tile : Tiles)
+	{
+		URLs.Add(
+			URL2.Replace(TEXT("{z}"), *FString::FromInt(Tile.Zoom))
+				.Replace(TEXT("{x}"), *FString::FromInt(Tile.X))
+				.Replace(TEXT("{y}"), *FString::FromInt(Tile.Y))
+		);
+	}
+
+	return [Layer, URLs = MoveTemp(URLs)](LCCancellationToken *Cancellation) -> bool
+	{
+		UE_LOG(LogImageDownloader, Log, TEXT("Prefetching %d tiles of %s"), URLs.Num(), *Layer);
+
+		// tiles are submitted in the given order, so the first ones are downloaded first
+		bool bSuccess = Concurrency::RunManyAndWait<FString>(
+			URLs,
+			[](FString URL) { return TileCache::Prefetch(URL); },
+			EConcurrencyResource::Network,
+			Cancellation
+		);
+
+		TileCache::SaveManifest();
+		return bSuccess;
+	};
+}
+
 HMFetcher* UImageDownloader::CreateFetcher(
 	bool bIsUserInitiated, FString Name, bool bEnsureOneBand, bool bScaleAltitude,
 	bool bConvertToPNG, bool bConvertFirstOnly, bool bAddMissingTiles,
@@ -380,7 +432,7 @@ HMFetcher* UImageDownloader::CreateFetcher(
 	if (bRemap)
 	{
 		Result = Result->AndThen(new HMDebugFetcher("Convert", new HMConvert(Name, "tif")));
-		Result = Result->AndThen(new HMDebugFetcher("FixNoData", new HMFunction([this](float x) { return x == OriginalValue ? TransformedValue : x; })));
+		Result = Result->AndThen(new HMDebugFetcher("FixNoData", new HMFunction(HMFunctionOp::ReplaceValue(OriginalValue, TransformedValue))));
 	}
 	
 	if (bPreprocess)
@@ -398,15 +450,10 @@ HMFetcher* UImageDownloader::CreateFetcher(
 		Result = Result->AndThen(new HMDebugFetcher("Reproject", new HMReproject(Name, GlobalCoordinates->CRS)));
 	}
 
-	if (bMergeImages)
-	{
-		Result = Result->AndThen(new HMDebugFetcher("Merge", new HMMerge(Name)));
-	}
-
+	FIntPoint ImageSize(0, 0);
 #if WITH_EDITOR
 	if (bAdaptResolution)
 	{
-		FIntPoint ImageSize(0, 0);
 		if (!IsValid(TargetLandscape))
 		{
 			LCReporter::ShowError(
@@ -417,8 +464,6 @@ HMFetcher* UImageDownloader::CreateFetcher(
 
 		ImageSize.X = TargetLandscape->ComputeComponentCounts().X * TargetLandscape->ComponentSizeQuads + 1;
 		ImageSize.Y = TargetLandscape->ComputeComponentCounts().Y * TargetLandscape->ComponentSizeQuads + 1;
-
-		Result = Result->AndThen(new HMDebugFetcher("AdaptImage", new HMResolution(Name, ImageSize)));
 	}
 #else
 	if (bAdaptResolution)
@@ -442,8 +487,35 @@ HMFetcher* UImageDownloader::CreateFetcher(
 				return nullptr;
 			}
 		}
+	}
+
+	// When the images are merged, merging, resizing, cropping and scaling are done in a single warp from a virtual mosaic
+	const bool bUseMosaic = bMergeImages && (bAdaptResolution || bCropCoordinates);
+	const bool bScaleResolutionInMosaic = bUseMosaic && bScaleResolution && !bAddMissingTiles;
+
+	if (bUseMosaic)
+	{
+		Result = Result->AndThen(new HMDebugFetcher("Mosaic", new HMMosaic(
+			Name, ImageSize, bScaleResolutionInMosaic ? PrecisionPercent : 100,
+			bCropCoordinates, AllowsParametersSelection() && bCropFollowingParametersSelection, ParametersSelection, CroppingActor
+		)));
+	}
+	else
+	{
+		if (bMergeImages)
+		{
+			Result = Result->AndThen(new HMDebugFetcher("Merge", new HMMerge(Name)));
+		}
 
-		Result = Result->AndThen(new HMDebugFetcher("Crop", new HMCrop(Name, AllowsParametersSelection() && bCropFollowingParametersSelection, ParametersSelection, CroppingActor)));
+		if (bAdaptResolution)
+		{
+			Result = Result->AndThen(new HMDebugFetcher("AdaptImage", new HMResolution(Name, ImageSize)));
+		}
+
+		if (bCropCoordinates)
+		{
+			Result = Result->AndThen(new HMDebugFetcher("Crop", new HMCrop(Name, AllowsParametersSelection() && bCropFollowingParametersSelection, ParametersSelection, CroppingActor)));
+		}
 	}
 
 	if (RunBeforePNG)
@@ -461,12 +533,19 @@ HMFetcher* UImageDownloader::CreateFetcher(
 		Result = Result->AndThen(new HMDebugFetcher("AddMissingTiles", new HMAddMissingTiles()));
 	}
 
-	if (bScaleResolution)
+	if (bScaleResolution && !bScaleResolutionInMosaic)
 	{
 		Result = Result->AndThen(new HMDebugFetcher("PercentResolution", new HMPercentResolution(Name, PrecisionPercent)));
 	}
 
-	return Result;
+	if (bKeepIntermediateImagesInMemory)
+	{
+		// all phases exchange in-memory datasets, and only the final images are written to disk
+		Result->SetOutputInMemory(true);
+		Result = Result->AndThen(new HMDebugFetcher("WriteToDisk", new HMWriteToDisk()));
+	}
+
+	return new HMMetricsFetcher(Name, Result);
 }
 
 bool UImageDownloader::HasMapTilerToken()
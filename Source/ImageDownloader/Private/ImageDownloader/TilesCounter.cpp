@@ -20,6 +20,16 @@ void TilesCounter::ComputeMinMaxTiles()
 	}
 }
 
+bool TilesCounter::TryTileOf(const FString &Tile, FIntPoint &OutTile)
+{
+	FRegexPattern Pattern(TEXT("_x(\\d+)_y(\\d+)\\."));
+	FRegexMatcher Matcher(Pattern, Tile);
+	if (!Matcher.FindNext()) return false;
+
+	OutTile = FIntPoint(FCString::Atoi(*Matcher.GetCaptureGroup(1)), FCString::Atoi(*Matcher.GetCaptureGroup(2)));
+	return true;
+}
+
 int TilesCounter::TileToX(FString Tile) const
 {
 	FRegexPattern Pattern(TEXT("_x(\\d+)_y\\d+\\."));
@@ -5,6 +5,7 @@
 #include "ImageDownloader/LogImageDownloader.h"
 #include "GDALInterface/GDALInterface.h"
 
+#include "Async/ParallelFor.h"
 #include "HAL/PlatformFile.h"
 #include "Misc/Paths.h"
 #include "Misc/MessageDialog.h"
@@ -23,22 +24,21 @@ bool HMConvert::OnFetch(FString InputCRS, TArray<FString> InputFiles)
 		return true;
 	}
 
-	FVector2D Altitudes;
-	if (!GDALInterface::GetMinMax(Altitudes, InputFiles)) return false;
-
-	double MinAltitude = Altitudes[0];
-	double MaxAltitude = Altitudes[1];
-
+	TArray<FString> ConvertedFiles;
 	for (int32 i = 0; i < InputFiles.Num(); i++)
 	{
-		FString InputFile = InputFiles[i];
-		FString ConvertedFile = FPaths::Combine(OutputDir, FPaths::GetBaseFilename(InputFile) + "." + NewExtension);
-		OutputFiles.Add(ConvertedFile);
-
-		if (!GDALInterface::Translate(InputFile, ConvertedFile, TArray<FString>())) return false;
+		ConvertedFiles.Add(FPaths::Combine(OutputDir, FPaths::GetBaseFilename(InputFiles[i]) + "." + NewExtension));
 	}
 
-	return true;
+	// files are independent, so they are converted concurrently
+	std::atomic<bool> bSuccess = true;
+	ParallelFor(InputFiles.Num(), [&](int32 i)
+	{
+		if (bSuccess && !GDALInterface::Translate(InputFiles[i], ConvertedFiles[i], TArray<FString>())) bSuccess = false;
+	});
+
+	OutputFiles.Append(ConvertedFiles);
+	return bSuccess;
 }
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
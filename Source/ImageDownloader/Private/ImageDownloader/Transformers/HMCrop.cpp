@@ -14,11 +14,9 @@
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
-bool HMCrop::OnFetch(FString InputCRS, TArray<FString> InputFiles)
+bool HMCrop::GetCropCoordinates(FString InputCRS, FVector4d &Coordinates)
 {
-	OutputCRS = InputCRS;
-
-	FVector4d Coordinates(0, 0, 0, 0);
+	Coordinates = FVector4d(0, 0, 0, 0);
 	if (bCropFollowingParametersSelection)
 	{	
 		if (ParametersSelection.ParametersSelectionMethod == EParametersSelectionMethod::FromBoundingActor)
@@ -84,6 +82,16 @@ bool HMCrop::OnFetch(FString InputCRS, TArray<FString> InputFiles)
 		}
 	}
 
+	return true;
+}
+
+bool HMCrop::OnFetch(FString InputCRS, TArray<FString> InputFiles)
+{
+	OutputCRS = InputCRS;
+
+	FVector4d Coordinates;
+	if (!GetCropCoordinates(InputCRS, Coordinates)) return false;
+
 	double BoundingSouth = Coordinates[2];
 	double BoundingWest = Coordinates[0];
 	double BoundingNorth = Coordinates[3];
@@ -6,9 +6,54 @@
 #include "GDALInterface/GDALInterface.h"
 #include "ConcurrencyHelpers/LCReporter.h"
 #include "Misc/MessageDialog.h"
+#include "Async/ParallelFor.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/ScopeLock.h"
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
+void HMFunctionOp::Apply(float* RESTRICT Data, int64 Num) const
+{
+	switch (Kind)
+	{
+		case EKind::ReplaceValue:
+		{
+			const float From = A;
+			const float To = B;
+			for (int64 i = 0; i < Num; i++) Data[i] = Data[i] == From ? To : Data[i];
+			return;
+		}
+
+		case EKind::Scale:
+		{
+			const float Factor = A;
+			for (int64 i = 0; i < Num; i++) Data[i] *= Factor;
+			return;
+		}
+
+		case EKind::Offset:
+		{
+			const float Delta = A;
+			for (int64 i = 0; i < Num; i++) Data[i] += Delta;
+			return;
+		}
+
+		case EKind::Clamp:
+		{
+			const float Min = A;
+			const float Max = B;
+			for (int64 i = 0; i < Num; i++) Data[i] = FMath::Min(FMath::Max(Data[i], Min), Max);
+			return;
+		}
+
+		case EKind::Custom:
+		{
+			for (int64 i = 0; i < Num; i++) Data[i] = Function(Data[i]);
+			return;
+		}
+	}
+}
+
 bool HMFunction::OnFetch(FString InputCRS, TArray<FString> InputFiles)
 {
 	OutputCRS = InputCRS;
@@ -16,92 +61,147 @@ bool HMFunction::OnFetch(FString InputCRS, TArray<FString> InputFiles)
 
 	for (auto &InputFile : InputFiles)
 	{
+		if (!ApplyOps(InputFile)) return false;
+	}
 
-		const char* openOptions[] = { "IGNORE_COG_LAYOUT_BREAK=YES", nullptr }; // import for Swiss ALTI 3D source
-		GDALDataset *Dataset = (GDALDataset *) GDALOpenEx(
-			TCHAR_TO_UTF8(*InputFile),
-			GDAL_OF_UPDATE | GDAL_OF_RASTER,
-			nullptr,
-			openOptions,
-			nullptr
-		);
-		if (!Dataset)
-		{
-			LCReporter::ShowError(
-				FText::Format(
-					LOCTEXT("HMFunction::Fetch::1", "Image Downloader Error: Could not open heightmap file '{0}'.\nError: {1}"),
-					FText::FromString(InputFile),
-					FText::FromString(FString(CPLGetLastErrorMsg()))
-				)
-			);
-			return false;
-		}
-
-		GDALRasterBand *Band = Dataset->GetRasterBand(1);
+	return true;
+}
 
-		if (!Band)
-		{
-			LCReporter::ShowError(FText::Format(
-				LOCTEXT("HMFunction::Fetch::2", "Internal error: Could not get raster band of file {0}.\nError: {1}"),
+bool HMFunction::ApplyOps(FString InputFile)
+{
+	const char* openOptions[] = { "IGNORE_COG_LAYOUT_BREAK=YES", nullptr }; // import for Swiss ALTI 3D source
+	GDALDataset *Dataset = (GDALDataset *) GDALOpenEx(
+		TCHAR_TO_UTF8(*InputFile),
+		GDAL_OF_UPDATE | GDAL_OF_RASTER,
+		nullptr,
+		openOptions,
+		nullptr
+	);
+	if (!Dataset)
+	{
+		LCReporter::ShowError(
+			FText::Format(
+				LOCTEXT("HMFunction::Fetch::1", "Image Downloader Error: Could not open heightmap file '{0}'.\nError: {1}"),
 				FText::FromString(InputFile),
 				FText::FromString(FString(CPLGetLastErrorMsg()))
-			));
-			GDALClose(Dataset);
-			return false;
-		}
+			)
+		);
+		return false;
+	}
 
-		int SizeX = Band->GetXSize();
-		int SizeY = Band->GetYSize();
-		float *Data = (float*) CPLMalloc(SizeX * SizeY * sizeof(float));
+	GDALRasterBand *Band = Dataset->GetRasterBand(1);
+
+	if (!Band)
+	{
+		LCReporter::ShowError(FText::Format(
+			LOCTEXT("HMFunction::Fetch::2", "Internal error: Could not get raster band of file {0}.\nError: {1}"),
+			FText::FromString(InputFile),
+			FText::FromString(FString(CPLGetLastErrorMsg()))
+		));
+		GDALClose(Dataset);
+		return false;
+	}
+
+	const int SizeX = Band->GetXSize();
+	const int SizeY = Band->GetYSize();
+
+	// We work on windows aligned with the natural blocks of the band, so that each read or write
+	// only touches whole blocks. Striped images have blocks of one row, so we group several block
+	// rows together to keep the windows large enough to be worth a task.
+	int BlockSizeX = 0;
+	int BlockSizeY = 0;
+	Band->GetBlockSize(&BlockSizeX, &BlockSizeY);
+	BlockSizeX = FMath::Clamp(BlockSizeX, 1, SizeX);
+	BlockSizeY = FMath::Clamp(BlockSizeY, 1, SizeY);
+
+	const int MinWindowPixels = 256 * 256;
+	const int BlockRowsPerWindow = FMath::Max(1, MinWindowPixels / (BlockSizeX * BlockSizeY));
+	const int WindowSizeX = BlockSizeX;
+	const int WindowSizeY = FMath::Min(SizeY, BlockSizeY * BlockRowsPerWindow);
+
+	const int NumWindowsX = FMath::DivideAndRoundUp(SizeX, WindowSizeX);
+	const int NumWindowsY = FMath::DivideAndRoundUp(SizeY, WindowSizeY);
+	const int NumWindows = NumWindowsX * NumWindowsY;
+
+	UE_LOG(LogImageDownloader, Log, TEXT("Applying %d operations on %s using %d windows of size %dx%d"),
+		Ops.Num(), *InputFile, NumWindows, WindowSizeX, WindowSizeY
+	);
+
+	// GDAL datasets cannot be accessed concurrently, so reads and writes are serialized,
+	// while the operations on the pixels run in parallel
+	FCriticalSection DatasetLock;
+	std::atomic<bool> bFailed = false;
+	bool bReadError = false;
+	FString ErrorMessage;
+
+	ParallelFor(NumWindows, [&](int32 WindowIndex)
+	{
+		if (bFailed) return;
+
+		const int X = (WindowIndex % NumWindowsX) * WindowSizeX;
+		const int Y = (WindowIndex / NumWindowsX) * WindowSizeY;
+		const int Width = FMath::Min(WindowSizeX, SizeX - X);
+		const int Height = FMath::Min(WindowSizeY, SizeY - Y);
+		const int64 NumPixels = (int64) Width * Height;
+
+		TArray<float> Data;
+		Data.SetNumUninitialized(NumPixels);
 
-		if (!Data)
 		{
-			LCReporter::ShowError(
-				LOCTEXT("HMFunction::Fetch::3", "Internal error: Could not allocate memory.")
-			);
-			GDALClose(Dataset);
-			return false;
+			FScopeLock Lock(&DatasetLock);
+			if (Band->RasterIO(GF_Read, X, Y, Width, Height, Data.GetData(), Width, Height, GDT_Float32, 0, 0) != CE_None)
+			{
+				if (!bFailed.exchange(true))
+				{
+					bReadError = true;
+					ErrorMessage = FString(CPLGetLastErrorMsg());
+				}
+				return;
+			}
 		}
 
-		CPLErr Err;
-		Err = Band->RasterIO(GF_Read, 0, 0, SizeX, SizeY, Data, SizeX, SizeY, GDT_Float32, 0, 0);
-
-		if (Err != CE_None)
+		for (const HMFunctionOp& Op : Ops)
 		{
-			LCReporter::ShowError(FText::Format(
-				LOCTEXT("HMFunction::Fetch::4", "Internal error: Could not read data from file {0}.\nError: {1}"),
-				FText::FromString(InputFile),
-				FText::FromString(FString(CPLGetLastErrorMsg()))
-			));
-			GDALClose(Dataset);
-			return false;
+			Op.Apply(Data.GetData(), NumPixels);
 		}
 
-		for (int i = 0; i < SizeX; i++)
 		{
-			for (int j = 0; j < SizeY; j++)
+			FScopeLock Lock(&DatasetLock);
+			if (Band->RasterIO(GF_Write, X, Y, Width, Height, Data.GetData(), Width, Height, GDT_Float32, 0, 0) != CE_None)
 			{
-				Data[i + j * SizeX] = Function(Data[i + j * SizeX]);
+				if (!bFailed.exchange(true))
+				{
+					ErrorMessage = FString(CPLGetLastErrorMsg());
+				}
+				return;
 			}
 		}
-		Err = Band->RasterIO(GF_Write, 0, 0, SizeX, SizeY, Data, SizeX, SizeY, GDT_Float32, 0, 0);
-		CPLFree(Data);
+	});
 
-		if (Err != CE_None)
+	if (bFailed)
+	{
+		if (bReadError)
+		{
+			LCReporter::ShowError(FText::Format(
+				LOCTEXT("HMFunction::Fetch::4", "Internal error: Could not read data from file {0}.\nError: {1}"),
+				FText::FromString(InputFile),
+				FText::FromString(ErrorMessage)
+			));
+		}
+		else
 		{
 			LCReporter::ShowError(FText::Format(
 				LOCTEXT("HMFunction::Fetch::5", "Internal error: Could not write data to dataset in file {0}.\nError: {1}"),
 				FText::FromString(InputFile),
-				FText::FromString(FString(CPLGetLastErrorMsg()))
+				FText::FromString(ErrorMessage)
 			));
-			GDALClose(Dataset);
-			return false;
 		}
-
 		GDALClose(Dataset);
+		return false;
 	}
 
+	GDALClose(Dataset);
 	return true;
 }
 
-#undef LOCTEXT_NAMESPACE
\ No newline at end of file
+#undef LOCTEXT_NAMESPACE
@@ -21,7 +21,7 @@ bool HMMerge::OnFetch(FString InputCRS, TArray<FString> InputFiles)
 		return true;
 	}
 	
-	if (!IPlatformFile::GetPlatformPhysical().CreateDirectory(*OutputDir))
+	if (!bOutputInMemory && !IPlatformFile::GetPlatformPhysical().CreateDirectory(*OutputDir))
 	{
 		Directories::CouldNotInitializeDirectory(OutputDir);
 		return false;
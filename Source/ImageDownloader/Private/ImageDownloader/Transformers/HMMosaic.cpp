@@ -0,0 +1,121 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#include "ImageDownloader/Transformers/HMMosaic.h"
+#include "ImageDownloader/Directories.h"
+#include "ImageDownloader/LogImageDownloader.h"
+#include "GDALInterface/GDALInterface.h"
+#include "ConcurrencyHelpers/LCReporter.h"
+
+#include "HAL/PlatformFile.h"
+#include "Misc/Paths.h"
+
+#define LOCTEXT_NAMESPACE "FImageDownloaderModule"
+
+bool HMMosaic::OnFetch(FString InputCRS, TArray<FString> InputFiles)
+{
+	OutputCRS = InputCRS;
+
+	if (InputFiles.IsEmpty())
+	{
+		LCReporter::ShowError(
+			LOCTEXT("HMMosaic::Fetch::NoFiles", "Image Downloader Error: There are no images to merge.")
+		);
+		return false;
+	}
+
+	if (!bOutputInMemory && !IPlatformFile::GetPlatformPhysical().CreateDirectory(*OutputDir))
+	{
+		Directories::CouldNotInitializeDirectory(OutputDir);
+		return false;
+	}
+
+	/* Virtual mosaic of all the input files, nothing is read at this point */
+
+	FString MosaicFile = InputFiles[0];
+	if (InputFiles.Num() > 1)
+	{
+		MosaicFile = FPaths::Combine(OutputDir, Name + "-Mosaic.vrt");
+		if (!GDALInterface::Merge(InputFiles, MosaicFile)) return false;
+	}
+
+	FVector4d MosaicCoordinates;
+	FIntPoint MosaicPixels;
+	if (!GDALInterface::GetCoordinates(MosaicCoordinates, MosaicFile)) return false;
+	if (!GDALInterface::GetPixels(MosaicPixels, MosaicFile)) return false;
+
+	const double MosaicWest = MosaicCoordinates[0];
+	const double MosaicEast = MosaicCoordinates[1];
+	const double MosaicSouth = MosaicCoordinates[2];
+	const double MosaicNorth = MosaicCoordinates[3];
+
+
+	/* Pixel grid of the result, which is the grid of the resampled mosaic */
+
+	FIntPoint GridPixels = Pixels != FIntPoint::ZeroValue ? Pixels : MosaicPixels;
+	double PixelWidth = (MosaicEast - MosaicWest) / GridPixels[0];
+	double PixelHeight = (MosaicNorth - MosaicSouth) / GridPixels[1];
+
+
+	/* Cropping rectangle, snapped to the pixel grid like gdal_translate -projwin does */
+
+	double West = MosaicWest;
+	double East = MosaicEast;
+	double South = MosaicSouth;
+	double North = MosaicNorth;
+
+	if (bCrop)
+	{
+		FVector4d Coordinates;
+		if (!GetCropCoordinates(InputCRS, Coordinates)) return false;
+
+		const int MinCol = FMath::Clamp(FMath::RoundToInt((FMath::Max(Coordinates[0], MosaicWest) - MosaicWest) / PixelWidth), 0, GridPixels[0]);
+		const int MaxCol = FMath::Clamp(FMath::RoundToInt((FMath::Min(Coordinates[1], MosaicEast) - MosaicWest) / PixelWidth), 0, GridPixels[0]);
+		const int MinRow = FMath::Clamp(FMath::RoundToInt((MosaicNorth - FMath::Min(Coordinates[3], MosaicNorth)) / PixelHeight), 0, GridPixels[1]);
+		const int MaxRow = FMath::Clamp(FMath::RoundToInt((MosaicNorth - FMath::Max(Coordinates[2], MosaicSouth)) / PixelHeight), 0, GridPixels[1]);
+
+		if (MinCol >= MaxCol || MinRow >= MaxRow)
+		{
+			LCReporter::ShowError(
+				LOCTEXT("HMMosaic::Fetch::EmptyCrop", "Image Downloader Error: The cropping rectangle does not intersect the images.")
+			);
+			return false;
+		}
+
+		West = MosaicWest + MinCol * PixelWidth;
+		East = MosaicWest + MaxCol * PixelWidth;
+		North = MosaicNorth - MinRow * PixelHeight;
+		South = MosaicNorth - MaxRow * PixelHeight;
+	}
+
+	const int OutputWidth = FMath::Max(1, FMath::RoundToInt((East - West) / PixelWidth * PrecisionPercent / 100.0));
+	const int OutputHeight = FMath::Max(1, FMath::RoundToInt((North - South) / PixelHeight * PrecisionPercent / 100.0));
+
+
+	/* Single warp reading only the cropping rectangle, at the target resolution.
+	 * When the result is smaller than the source, GDAL reads from the overviews of the sources when they have some. */
+
+	FString OutputFile = FPaths::Combine(OutputDir, Name + ".tif");
+	OutputFiles.Add(OutputFile);
+
+	TArray<FString> Args;
+	Args.Add("-s_srs");
+	Args.Add(InputCRS);
+	Args.Add("-t_srs");
+	Args.Add(InputCRS);
+	Args.Add("-te");
+	Args.Add(FString::SanitizeFloat(West));
+	Args.Add(FString::SanitizeFloat(South));
+	Args.Add(FString::SanitizeFloat(East));
+	Args.Add(FString::SanitizeFloat(North));
+	Args.Add("-ts");
+	Args.Add(FString::FromInt(OutputWidth));
+	Args.Add(FString::FromInt(OutputHeight));
+
+	UE_LOG(LogImageDownloader, Log, TEXT("Warping mosaic of %d files (%dx%d pixels) to %dx%d pixels"),
+		InputFiles.Num(), MosaicPixels[0], MosaicPixels[1], OutputWidth, OutputHeight
+	);
+
+	return GDALInterface::Warp(MosaicFile, OutputFile, Args);
+}
+
+#undef LOCTEXT_NAMESPACE
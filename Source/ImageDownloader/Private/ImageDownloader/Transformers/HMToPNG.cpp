@@ -5,6 +5,7 @@
 #include "ImageDownloader/LogImageDownloader.h"
 #include "GDALInterface/GDALInterface.h"
 
+#include "Async/ParallelFor.h"
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
@@ -22,28 +23,29 @@ bool HMToPNG::OnFetch(FString InputCRS, TArray<FString> InputFiles)
 	double MaxAltitude = Altitudes[1];
 
 	int NumFilesToConvert = bConvertOnlyFirst ? 1 : InputFiles.Num();
+	TArray<FString> PNGFiles;
 	for (int32 i = 0; i < NumFilesToConvert; i++)
 	{
-		FString InputFile = InputFiles[i];
-		FString PNGFile = FPaths::Combine(OutputDir, FPaths::GetBaseFilename(InputFile) + ".png");
-		OutputFiles.Add(PNGFile);
-
-		if (bScaleAltitude)
-		{
-			if (!GDALInterface::ConvertToPNG(InputFile, PNGFile, MinAltitude - 100, MaxAltitude + 100))
-			{
-				return false;
-			}
-		}
-		else
-		{
-			if (!GDALInterface::ConvertToPNG(InputFile, PNGFile, 0, 255))
-			{
-				return false;
-			}
-		}
+		PNGFiles.Add(FPaths::Combine(OutputDir, FPaths::GetBaseFilename(InputFiles[i]) + ".png"));
 	}
 
+	// files are independent, so they are converted concurrently
+	std::atomic<bool> bSuccess = true;
+	ParallelFor(NumFilesToConvert, [&](int32 i)
+	{
+		if (!bSuccess) return;
+
+		const bool bConverted = bScaleAltitude ?
+			GDALInterface::ConvertToPNG(InputFiles[i], PNGFiles[i], MinAltitude - 100, MaxAltitude + 100) :
+			GDALInterface::ConvertToPNG(InputFiles[i], PNGFiles[i], 0, 255);
+
+		if (!bConverted) bSuccess = false;
+	});
+
+	if (!bSuccess) return false;
+
+	OutputFiles.Append(PNGFiles);
+
 	for (int32 i = NumFilesToConvert; i < InputFiles.Num(); i++)
 	{
 		OutputFiles.Add(InputFiles[i]);
@@ -0,0 +1,16 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#include "ImageDownloader/Transformers/HMWriteToDisk.h"
+#include "ImageDownloader/LogImageDownloader.h"
+
+#define LOCTEXT_NAMESPACE "FImageDownloaderModule"
+
+bool HMWriteToDisk::OnFetch(FString InputCRS, TArray<FString> InputFiles)
+{
+	// `HMFetcher::Fetch` already wrote the in-memory input files to disk, as this fetcher doesn't support in-memory inputs
+	OutputCRS = InputCRS;
+	OutputFiles.Append(InputFiles);
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -8,5 +8,23 @@ class IMAGEDOWNLOADER_API Directories {
 public:
 	static FString ImageDownloaderDir();
 	static FString DownloadDir();
+	static FString TileCacheDir();
+
+	/* Configures the persistent tile cache from the plugin settings, returns false if the cache is disabled */
+	static bool ConfigureTileCache();
 	static void CouldNotInitializeDirectory(FString Dir);
+
+	/* Deletes and creates the directory again, and drops the cached raster statistics of its files */
+	static bool ClearDirectory(const FString &Dir);
+
+	/* In-memory directories mirror the directories inside ImageDownloaderDir, using GDAL's /vsimem/ file system */
+	static FString InMemoryDir();
+	static bool IsInMemory(const FString &Path);
+	static FString ToInMemoryPath(const FString &DiskPath);
+	static FString ToDiskPath(const FString &InMemoryPath);
+	static bool ClearInMemoryDirectory(const FString &Dir);
+	static void DeleteInMemoryDirectory(const FString &Dir);
+
+	/* Replaces the in-memory files of the list by copies on disk, at their mirrored location */
+	static bool WriteInMemoryFilesToDisk(TArray<FString> &Files);
 };
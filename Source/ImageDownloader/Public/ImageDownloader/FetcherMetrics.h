@@ -0,0 +1,60 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+/* Measurements of one phase of a fetcher chain */
+struct FFetcherStageMetrics
+{
+	FString Name;
+	bool bSuccess = false;
+	double WallSeconds = 0;
+
+	// CPU time of the whole process while the phase was running, which includes the other threads
+	double ProcessCPUSeconds = 0;
+
+	int32 NumInputFiles = 0;
+	int32 NumOutputFiles = 0;
+	int64 InputBytes = 0;
+	int64 OutputBytes = 0;
+
+	// only counted when enabled with SetCountOutputPixels, as the output files must be opened again
+	int64 OutputPixels = 0;
+
+	// growth of GDAL's raster block cache during the phase (GDAL doesn't count cache hits)
+	int64 GDALCacheBytes = 0;
+
+	// peak physical memory of the whole process since it started, not of the phase itself
+	uint64 ProcessPeakUsedPhysicalBytes = 0;
+
+	FString ToString() const;
+};
+
+/* Report of the phases run by the HMDebugFetchers of one chain, so that the cost of each phase
+ * (reprojection, merge, crop, conversion...) can be compared between runs.
+ * Each HMMetricsFetcher owns the report of its chain, so chains running at the same time are reported separately. */
+class IMAGEDOWNLOADER_API FetcherMetrics
+{
+public:
+	void Reset();
+	void Add(const FFetcherStageMetrics &Metrics);
+	TArray<FFetcherStageMetrics> GetReport() const;
+
+	void LogReport() const;
+
+	/* Writes the report as a CSV file, with one line per phase */
+	bool WriteReport(const FString &File) const;
+
+	/* Opening the output files to count their pixels is off by default */
+	static void SetCountOutputPixels(bool bCountOutputPixels);
+
+	/* Measures a phase: Begin is called before running the phase, and End after it */
+	static void Begin(FFetcherStageMetrics &Metrics, const TArray<FString> &InputFiles);
+	static void End(FFetcherStageMetrics &Metrics, const TArray<FString> &OutputFiles, bool bSuccess);
+
+private:
+	mutable FCriticalSection ReportLock;
+	TArray<FFetcherStageMetrics> Report;
+};
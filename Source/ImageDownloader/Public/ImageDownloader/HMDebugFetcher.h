@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "ImageDownloader/HMFetcher.h"
+#include "ImageDownloader/FetcherMetrics.h"
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
@@ -28,8 +29,56 @@ public:
 		HMFetcher::SetIsUserInitiated(bIsUserInitiatedIn);
 		Fetcher->SetIsUserInitiated(bIsUserInitiatedIn);
 	}
+
+	void SetMetricsReport(FetcherMetrics *MetricsReportIn) override {
+		HMFetcher::SetMetricsReport(MetricsReportIn);
+		Fetcher->SetMetricsReport(MetricsReportIn);
+	}
+
+	void SetOutputInMemory(bool bOutputInMemoryIn) override { Fetcher->SetOutputInMemory(bOutputInMemoryIn); }
+	bool SupportsInMemoryOutput() override { return Fetcher->SupportsInMemoryOutput(); }
+	bool SupportsInMemoryInput() override { return true; }
+	bool KeepsReferencesToInputs() override { return Fetcher->KeepsReferencesToInputs(); }
+	void ReleaseInMemoryOutputs() override { Fetcher->ReleaseInMemoryOutputs(); }
 	
 	bool OnFetch(FString InputCRS, TArray<FString> InputFiles) override;
 };
 
+/* Wraps a whole fetcher chain, and owns the metrics report of its phases,
+ * which is logged and written to ImageDownloaderDir/Metrics/<Name>.csv after running the chain */
+class IMAGEDOWNLOADER_API HMMetricsFetcher : public HMFetcher
+{
+public:
+	HMMetricsFetcher(FString Name0, HMFetcher *Fetcher0)
+	{
+		Name = Name0;
+		Fetcher = Fetcher0;
+		HMFetcher::SetMetricsReport(&Report);
+		Fetcher->SetMetricsReport(&Report);
+	};
+	virtual ~HMMetricsFetcher() {
+		delete Fetcher;
+	};
+
+	FString Name;
+	HMFetcher *Fetcher;
+	FetcherMetrics Report;
+
+	void SetIsUserInitiated(bool bIsUserInitiatedIn) override {
+		HMFetcher::SetIsUserInitiated(bIsUserInitiatedIn);
+		Fetcher->SetIsUserInitiated(bIsUserInitiatedIn);
+	}
+
+	// the wrapped chain keeps reporting to this fetcher, even when it is part of a larger chain
+	void SetMetricsReport(FetcherMetrics *MetricsReportIn) override {}
+
+	void SetOutputInMemory(bool bOutputInMemoryIn) override { Fetcher->SetOutputInMemory(bOutputInMemoryIn); }
+	bool SupportsInMemoryOutput() override { return Fetcher->SupportsInMemoryOutput(); }
+	bool SupportsInMemoryInput() override { return true; }
+	bool KeepsReferencesToInputs() override { return Fetcher->KeepsReferencesToInputs(); }
+	void ReleaseInMemoryOutputs() override { Fetcher->ReleaseInMemoryOutputs(); }
+
+	bool OnFetch(FString InputCRS, TArray<FString> InputFiles) override;
+};
+
 #undef LOCTEXT_NAMESPACE
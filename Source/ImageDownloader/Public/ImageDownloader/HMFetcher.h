@@ -12,24 +12,58 @@
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
+class FetcherMetrics;
+
 class IMAGEDOWNLOADER_API HMFetcher
 {
 public:
 	HMFetcher() {};
-	virtual ~HMFetcher() {};
+	virtual ~HMFetcher()
+	{
+		HMFetcher::ReleaseInMemoryOutputs();
+	};
 
 	TArray<FString> OutputFiles;
 	FString OutputCRS = "";
 	bool bIsUserInitiated = false;
 
+	/* When true, the output files are written to GDAL's in-memory file system instead of the disk */
+	bool bOutputInMemory = false;
+
+	/* Report of the HMMetricsFetcher wrapping the chain, if any, to which the HMDebugFetchers add their phases */
+	FetcherMetrics *MetricsReport = nullptr;
+
 	virtual void SetIsUserInitiated(bool bIsUserInitiatedIn) { bIsUserInitiated = bIsUserInitiatedIn; }
+	virtual void SetMetricsReport(FetcherMetrics *MetricsReportIn) { MetricsReport = MetricsReportIn; }
+	virtual void SetOutputInMemory(bool bOutputInMemoryIn) { bOutputInMemory = bOutputInMemoryIn && SupportsInMemoryOutput(); }
+
+	/* Fetchers that only use GDAL to write their outputs can write them in memory */
+	virtual bool SupportsInMemoryOutput() { return false; }
+
+	/* Fetchers that only use GDAL to read their inputs can read them from memory, other fetchers get a copy on disk */
+	virtual bool SupportsInMemoryInput() { return false; }
+
+	/* True when the output files reference the input files (e.g. VRT), which must then be kept alive */
+	virtual bool KeepsReferencesToInputs() { return false; }
+
+	/* Frees the in-memory output files of this fetcher, if any */
+	virtual void ReleaseInMemoryOutputs()
+	{
+		if (bOutputInMemory && !OutputDir.IsEmpty())
+		{
+			Directories::DeleteInMemoryDirectory(OutputDir);
+		}
+	}
 
 	HMFetcher* AndThen(HMFetcher* OtherFetcher);
 	HMFetcher* AndRun(TFunction<bool(HMFetcher*)> Lambda);
 
 	bool Fetch(FString InputCRS, TArray<FString> InputFiles)
 	{
-		return SetDirectories() && OnFetch(InputCRS, InputFiles);
+		return
+			SetDirectories() &&
+			(SupportsInMemoryInput() || Directories::WriteInMemoryFilesToDisk(InputFiles)) &&
+			OnFetch(InputCRS, InputFiles);
 	}
 
 protected:
@@ -50,10 +84,14 @@ protected:
 		OutputDir = GetOutputDir();
 		if (OutputDir.IsEmpty()) return true; // This means this fetcher doesn't use an output directory
 
+		if (bOutputInMemory)
+		{
+			OutputDir = Directories::ToInMemoryPath(OutputDir);
+			return Directories::ClearInMemoryDirectory(OutputDir);
+		}
+
 		// in case an output dir is set, we attempt clear it (if it exists) or create it
-		return
-			IPlatformFile::GetPlatformPhysical().DeleteDirectoryRecursively(*OutputDir) &&
-			IPlatformFile::GetPlatformPhysical().CreateDirectory(*OutputDir);
+		return Directories::ClearDirectory(OutputDir);
 	}
 
 	virtual bool OnFetch(FString InputCRS, TArray<FString> InputFiles) = 0;
@@ -80,6 +118,25 @@ public:
 		Fetcher1->SetIsUserInitiated(bIsUserInitiatedIn);
 		Fetcher2->SetIsUserInitiated(bIsUserInitiatedIn);
 	}
+
+	void SetMetricsReport(FetcherMetrics *MetricsReportIn) override {
+		HMFetcher::SetMetricsReport(MetricsReportIn);
+		Fetcher1->SetMetricsReport(MetricsReportIn);
+		Fetcher2->SetMetricsReport(MetricsReportIn);
+	}
+
+	void SetOutputInMemory(bool bOutputInMemoryIn) override {
+		Fetcher1->SetOutputInMemory(bOutputInMemoryIn);
+		Fetcher2->SetOutputInMemory(bOutputInMemoryIn);
+	}
+
+	bool SupportsInMemoryInput() override { return true; }
+	bool KeepsReferencesToInputs() override { return Fetcher1->KeepsReferencesToInputs() || Fetcher2->KeepsReferencesToInputs(); }
+
+	void ReleaseInMemoryOutputs() override {
+		Fetcher1->ReleaseInMemoryOutputs();
+		Fetcher2->ReleaseInMemoryOutputs();
+	}
 	
 	bool OnFetch(FString InputCRS, TArray<FString> InputFiles) override;
 };
@@ -103,6 +160,16 @@ public:
 		HMFetcher::SetIsUserInitiated(bIsUserInitiatedIn);
 		Fetcher->SetIsUserInitiated(bIsUserInitiatedIn);
 	}
+
+	void SetMetricsReport(FetcherMetrics *MetricsReportIn) override {
+		HMFetcher::SetMetricsReport(MetricsReportIn);
+		Fetcher->SetMetricsReport(MetricsReportIn);
+	}
+
+	void SetOutputInMemory(bool bOutputInMemoryIn) override { Fetcher->SetOutputInMemory(bOutputInMemoryIn); }
+	bool SupportsInMemoryInput() override { return true; }
+	bool KeepsReferencesToInputs() override { return Fetcher->KeepsReferencesToInputs(); }
+	void ReleaseInMemoryOutputs() override { Fetcher->ReleaseInMemoryOutputs(); }
 	
 	bool OnFetch(FString InputCRS, TArray<FString> InputFiles) override;
 };
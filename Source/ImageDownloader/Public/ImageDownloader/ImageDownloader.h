@@ -7,6 +7,8 @@
 #include "ImageDownloader/ParametersSelection.h"
 #include "ConsoleHelpers/ExternalTool.h"
 #include "Coordinates/LevelCoordinates.h"
+#include "ConcurrencyHelpers/Executor.h"
+#include "LCCommon/LCPositionBasedGeneration.h"
 
 #include "CoreMinimal.h"
 #include "Templates/Function.h"
@@ -64,6 +66,12 @@ public:
 
 	bool ConfigureForTiles(int Zoom, int MinX, int MaxX, int MinY, int MaxY);
 
+	/* Must be called on the game thread. Returns a task, which only captures the resolved tile URLs, and which downloads
+	 * the given XYZ tiles to the tile cache, so that fetching them later does not wait for the network.
+	 * Returns nullptr when the source is not XYZ or when the tile cache is disabled. The task returns false when some
+	 * tiles could not be downloaded. */
+	TFunction<bool(LCCancellationToken*)> MakePrefetchTask(const TArray<FTile> &Tiles);
+
 	/**********************
 	 *  Heightmap Source  *
 	 **********************/
@@ -797,6 +805,22 @@ public:
 	TObjectPtr<AActor> CroppingActor;
 	
 
+	/***************
+	 * Performance *
+	 ***************/
+
+	UPROPERTY(
+		EditAnywhere, BlueprintReadWrite, Category = "Performance",
+		meta = (DisplayPriority = "1")
+	)
+	/**
+	  * Check this to keep the intermediate images (conversion, reprojection, merge, crop, etc.) in memory instead of writing them
+	  * to the temporary folder. Only the final images, and the inputs of the preprocessing tool, are written to disk.
+	  * Uncheck this if you run out of memory on very large heightmaps.
+	  **/
+	bool bKeepIntermediateImagesInMemory = true;
+	
+
 	/***********
 	 * Actions *
 	 ***********/
@@ -885,6 +909,7 @@ protected:
 	void ResetWMSProvider(TArray<FString> ExcludeCRS, TFunction<bool(FString)> LayerFilter, TFunction<void(bool)> OnComplete);
 	
 	HMFetcher* CreateInitialFetcher(bool bIsUserInitiated, FString Name);
+	bool GetXYZSource(bool bIsUserInitiated, FString &Layer, FString &Format, FString &URL2, bool &bGeoreferenceSlippyTiles2, bool &bMaxY_IsNorth2);
 
 	UFUNCTION()
 	bool HasMultipleLayers();
@@ -13,6 +13,9 @@ public:
 	TilesCounter(TArray<FString> Tiles0) : Tiles(Tiles0) {};
 	virtual ~TilesCounter() {};
 	void ComputeMinMaxTiles();
+
+	/* Returns false when the file name does not contain tile indices of the form _x0_y0 */
+	static bool TryTileOf(const FString &Tile, FIntPoint &OutTile);
 	int FirstTileX;
 	int FirstTileY;
 	int LastTileX;
@@ -17,6 +17,8 @@ public:
 		return FPaths::Combine(ImageDownloaderDir, Name + "-Convert");
 	}
 	bool OnFetch(FString InputCRS, TArray<FString> InputFiles) override;
+	bool SupportsInMemoryOutput() override { return true; }
+	bool SupportsInMemoryInput() override { return true; }
 
 protected:
 	FString Name;
@@ -21,6 +21,11 @@ public:
 		return FPaths::Combine(ImageDownloaderDir, Name + "-Crop");
 	}
 	bool OnFetch(FString InputCRS, TArray<FString> InputFiles) override;
+	bool SupportsInMemoryOutput() override { return true; }
+	bool SupportsInMemoryInput() override { return true; }
+
+	/* Computes the cropping rectangle (West, East, South, North) in InputCRS */
+	bool GetCropCoordinates(FString InputCRS, FVector4d &Coordinates);
 
 protected:
 	FString Name;
@@ -18,6 +18,7 @@ public:
 	{};
 
 	bool OnFetch(FString InputCRS, TArray<FString> InputFiles) override;
+	bool SupportsInMemoryInput() override { return true; }
 
 private:
 	int MinLong;
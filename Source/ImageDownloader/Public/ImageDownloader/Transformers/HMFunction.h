@@ -6,16 +6,62 @@
 
 #define LOCTEXT_NAMESPACE "FImageDownloaderModule"
 
+/* A per-pixel operation applied by HMFunction on contiguous rows of pixels.
+ * Apart from Custom, the operations are branchless loops that the compiler can vectorize. */
+struct HMFunctionOp
+{
+	enum class EKind : uint8
+	{
+		ReplaceValue,
+		Scale,
+		Offset,
+		Clamp,
+		Custom
+	};
+
+	static HMFunctionOp ReplaceValue(float From, float To) { return HMFunctionOp(EKind::ReplaceValue, From, To); }
+	static HMFunctionOp Scale(float Factor) { return HMFunctionOp(EKind::Scale, Factor, 0); }
+	static HMFunctionOp Offset(float Delta) { return HMFunctionOp(EKind::Offset, Delta, 0); }
+	static HMFunctionOp Clamp(float Min, float Max) { return HMFunctionOp(EKind::Clamp, Min, Max); }
+	static HMFunctionOp Custom(TFunction<float(float)> Function)
+	{
+		HMFunctionOp Op(EKind::Custom, 0, 0);
+		Op.Function = Function;
+		return Op;
+	}
+
+	void Apply(float* RESTRICT Data, int64 Num) const;
+
+private:
+	HMFunctionOp(EKind Kind0, float A0, float B0) :
+		Kind(Kind0), A(A0), B(B0) {};
+
+	EKind Kind;
+	float A;
+	float B;
+	TFunction<float(float)> Function;
+};
+
 class HMFunction : public HMFetcher
 {
 public:
 	HMFunction(TFunction<float(float)> Function0) :
-		Function(Function0) {};
+		Ops({ HMFunctionOp::Custom(Function0) }) {};
+
+	HMFunction(HMFunctionOp Op0) :
+		Ops({ Op0 }) {};
+
+	HMFunction(TArray<HMFunctionOp> Ops0) :
+		Ops(Ops0) {};
 
 	bool OnFetch(FString InputCRS, TArray<FString> InputFiles) override;
+	bool SupportsInMemoryInput() override { return true; }
 
 private:
-	TFunction<float(float)> Function;
+	/* Operations applied successively on each block of pixels */
+	TArray<HMFunctionOp> Ops;
+
+	bool ApplyOps(FString InputFile);
 };
 
 #undef LOCTEXT_NAMESPACE
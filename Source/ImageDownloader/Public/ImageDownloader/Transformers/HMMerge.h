@@ -16,6 +16,9 @@ public:
 		return FPaths::Combine(ImageDownloaderDir, Name + "-Merge");
 	}
 	bool OnFetch(FString InputCRS, TArray<FString> InputFiles) override;
+	bool SupportsInMemoryOutput() override { return true; }
+	bool SupportsInMemoryInput() override { return true; }
+	bool KeepsReferencesToInputs() override { return true; }
 
 private:
 	FString Name;
@@ -0,0 +1,41 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "ImageDownloader/Transformers/HMCrop.h"
+
+#define LOCTEXT_NAMESPACE "FImageDownloaderModule"
+
+/* Merges, crops and resamples the input images in a single warp from a virtual mosaic,
+ * reading only the pixels inside the cropping rectangle, at the target resolution.
+ * The result is the same as HMMerge, followed by HMResolution (if Pixels is non-zero) and HMCrop (if bCrop is true). */
+class IMAGEDOWNLOADER_API HMMosaic : public HMCrop
+{
+public:
+	HMMosaic(
+		FString Name0, FIntPoint Pixels0, int PrecisionPercent0,
+		bool bCrop0, bool bCropFollowingParametersSelection0, FParametersSelection ParametersSelection0, AActor *CroppingActor0
+	) :
+		HMCrop(Name0, bCropFollowingParametersSelection0, ParametersSelection0, CroppingActor0),
+		Pixels(Pixels0),
+		PrecisionPercent(PrecisionPercent0),
+		bCrop(bCrop0)
+	{};
+
+	FString GetOutputDir() override
+	{
+		return FPaths::Combine(ImageDownloaderDir, Name + "-Mosaic");
+	}
+	bool OnFetch(FString InputCRS, TArray<FString> InputFiles) override;
+
+private:
+	/* Size of the full mosaic after resampling, or zero to keep the original resolution */
+	FIntPoint Pixels;
+
+	/* Additional decimation of the output, in percent */
+	int PrecisionPercent;
+
+	bool bCrop;
+};
+
+#undef LOCTEXT_NAMESPACE
@@ -17,6 +17,8 @@ public:
 	}
 
 	bool OnFetch(FString InputCRS, TArray<FString> InputFiles) override;
+	bool SupportsInMemoryOutput() override { return true; }
+	bool SupportsInMemoryInput() override { return true; }
 
 protected:
 	FString Name;
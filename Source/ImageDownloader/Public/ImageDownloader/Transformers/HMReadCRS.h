@@ -12,6 +12,7 @@ public:
 	HMReadCRS() {};
 
 	bool OnFetch(FString InputCRS, TArray<FString> InputFiles) override;
+	bool SupportsInMemoryInput() override { return true; }
 };
 
 #undef LOCTEXT_NAMESPACE
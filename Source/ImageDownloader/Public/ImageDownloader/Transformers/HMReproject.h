@@ -24,6 +24,8 @@ public:
 	}
 
 	bool OnFetch(FString InputCRS, TArray<FString> InputFiles) override;
+	bool SupportsInMemoryOutput() override { return true; }
+	bool SupportsInMemoryInput() override { return true; }
 
 private:
 	FString Name;
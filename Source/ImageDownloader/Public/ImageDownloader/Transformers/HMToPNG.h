@@ -22,6 +22,8 @@ public:
 	}
 
 	bool OnFetch(FString InputCRS, TArray<FString> InputFiles) override;
+	bool SupportsInMemoryOutput() override { return true; }
+	bool SupportsInMemoryInput() override { return true; }
 
 protected:
 	FString Name;
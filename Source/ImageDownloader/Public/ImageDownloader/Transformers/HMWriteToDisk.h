@@ -0,0 +1,18 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "ImageDownloader/HMFetcher.h"
+
+#define LOCTEXT_NAMESPACE "FImageDownloaderModule"
+
+/* Makes sure that all the files passed to this fetcher are on disk, by writing in-memory files to disk */
+class HMWriteToDisk : public HMFetcher
+{
+public:
+	HMWriteToDisk() {};
+
+	bool OnFetch(FString InputCRS, TArray<FString> InputFiles) override;
+};
+
+#undef LOCTEXT_NAMESPACE
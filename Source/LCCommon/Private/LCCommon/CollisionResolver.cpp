@@ -0,0 +1,407 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#include "LCCommon/CollisionResolver.h"
+#include "LCCommon/LogLCCommon.h"
+
+#include "Async/ParallelFor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+
+namespace
+{
+	const FVector2D Directions[] =
+	{
+		{ 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
+		{ 0.7071f,  0.7071f }, { 0.7071f, -0.7071f },
+		{ -0.7071f, 0.7071f }, { -0.7071f, -0.7071f }
+	};
+
+	// polygons that only touch each other within this distance (for instance buildings sharing a wall) do not overlap
+	const double Tolerance = 1;
+
+	// obstacles covering more cells than this (such as large terrains) are checked for every candidate location
+	const int MaxObstacleCells = 64;
+
+	int NumCandidates(const FCollisionFootprint &Footprint)
+	{
+		return 1 + 8 * FMath::Max(0, Footprint.MaxSteps);
+	}
+
+	/* Candidate 0 is the original location, and the next ones go step by step in each direction */
+	FVector2D GetCandidateOffset(const FCollisionFootprint &Footprint, int Candidate)
+	{
+		if (Candidate == 0) return FVector2D::ZeroVector;
+		const int Direction = (Candidate - 1) / Footprint.MaxSteps;
+		const int Step = (Candidate - 1) % Footprint.MaxSteps + 1;
+		return Directions[Direction] * (Footprint.StepSize * Step);
+	}
+
+	FIntPoint GetCell(const FVector2D &Point, double CellSize)
+	{
+		return FIntPoint(FMath::FloorToInt(Point.X / CellSize), FMath::FloorToInt(Point.Y / CellSize));
+	}
+
+	int64 NumCells(const FBox2D &Box, double CellSize)
+	{
+		const FIntPoint Min = GetCell(Box.Min, CellSize);
+		const FIntPoint Max = GetCell(Box.Max, CellSize);
+		return (int64) (Max.X - Min.X + 1) * (Max.Y - Min.Y + 1);
+	}
+
+	template<typename Fn>
+	void ForEachCell(const FBox2D &Box, double CellSize, Fn &&Callback)
+	{
+		const FIntPoint Min = GetCell(Box.Min, CellSize);
+		const FIntPoint Max = GetCell(Box.Max, CellSize);
+		for (int X = Min.X; X <= Max.X; X++)
+		{
+			for (int Y = Min.Y; Y <= Max.Y; Y++)
+			{
+				Callback(FIntPoint(X, Y));
+			}
+		}
+	}
+
+	/* Segments [A, B] and [C, D] cross each other, by more than the tolerance */
+	bool SegmentsCross(const FVector2D &A, const FVector2D &B, const FVector2D &C, const FVector2D &D)
+	{
+		const double LengthAB = FVector2D::Distance(A, B);
+		const double LengthCD = FVector2D::Distance(C, D);
+		if (LengthAB < Tolerance || LengthCD < Tolerance) return false;
+
+		// signed distances of C and D to the line AB, and of A and B to the line CD
+		const double DistanceC = FVector2D::CrossProduct(B - A, C - A) / LengthAB;
+		const double DistanceD = FVector2D::CrossProduct(B - A, D - A) / LengthAB;
+		const double DistanceA = FVector2D::CrossProduct(D - C, A - C) / LengthCD;
+		const double DistanceB = FVector2D::CrossProduct(D - C, B - C) / LengthCD;
+
+		return
+			((DistanceC > Tolerance && DistanceD < -Tolerance) || (DistanceC < -Tolerance && DistanceD > Tolerance)) &&
+			((DistanceA > Tolerance && DistanceB < -Tolerance) || (DistanceA < -Tolerance && DistanceB > Tolerance));
+	}
+
+	/* Point is inside Polygon, farther than the tolerance from its edges */
+	bool IsInside(const TArray<FVector2D> &Polygon, const FVector2D &Point)
+	{
+		const int NumVertices = Polygon.Num();
+		bool bInside = false;
+		for (int i = 0, j = NumVertices - 1; i < NumVertices; j = i++)
+		{
+			const FVector2D &A = Polygon[i];
+			const FVector2D &B = Polygon[j];
+
+			if (FVector2D::DistSquared(FMath::ClosestPointOnSegment2D(Point, A, B), Point) <= Tolerance * Tolerance) return false;
+
+			if ((A.Y > Point.Y) != (B.Y > Point.Y) && Point.X < (B.X - A.X) * (Point.Y - A.Y) / (B.Y - A.Y) + A.X)
+			{
+				bInside = !bInside;
+			}
+		}
+		return bInside;
+	}
+
+	/* Polygon1 shifted by Offset overlaps Polygon2 */
+	bool PolygonsOverlap(const TArray<FVector2D> &Polygon1, const FVector2D &Offset, const TArray<FVector2D> &Polygon2)
+	{
+		const int NumVertices1 = Polygon1.Num();
+		const int NumVertices2 = Polygon2.Num();
+		if (NumVertices1 < 3 || NumVertices2 < 3) return false;
+
+		for (int i = 0; i < NumVertices1; i++)
+		{
+			const FVector2D A = Polygon1[i] + Offset;
+			const FVector2D B = Polygon1[(i + 1) % NumVertices1] + Offset;
+			for (int j = 0; j < NumVertices2; j++)
+			{
+				if (SegmentsCross(A, B, Polygon2[j], Polygon2[(j + 1) % NumVertices2])) return true;
+			}
+		}
+
+		// without crossing edges, the polygons overlap only if one is inside the other
+		for (const FVector2D &Vertex : Polygon1)
+		{
+			if (IsInside(Polygon2, Vertex + Offset)) return true;
+		}
+
+		for (const FVector2D &Vertex : Polygon2)
+		{
+			if (IsInside(Polygon1, Vertex - Offset)) return true;
+		}
+
+		return false;
+	}
+}
+
+FCollisionFootprint FCollisionFootprint::FromActorBounds(AActor *Actor, int MaxSteps, double StepSize)
+{
+	FCollisionFootprint Footprint;
+	Footprint.Actor = Actor;
+	Footprint.MaxSteps = MaxSteps;
+	Footprint.StepSize = StepSize;
+
+	if (!IsValid(Actor)) return Footprint;
+
+	FVector Origin;
+	FVector HalfExtent;
+	Actor->GetActorBounds(/* bOnlyCollidingComponents */ false, Origin, HalfExtent);
+
+	Footprint.Polygon = {
+		{ Origin.X - HalfExtent.X, Origin.Y - HalfExtent.Y },
+		{ Origin.X + HalfExtent.X, Origin.Y - HalfExtent.Y },
+		{ Origin.X + HalfExtent.X, Origin.Y + HalfExtent.Y },
+		{ Origin.X - HalfExtent.X, Origin.Y + HalfExtent.Y }
+	};
+	Footprint.MinZ = Origin.Z - HalfExtent.Z;
+	Footprint.MaxZ = Origin.Z + HalfExtent.Z;
+
+	return Footprint;
+}
+
+FBox2D FCollisionFootprint::GetBounds2D() const
+{
+	return Polygon.IsEmpty() ? FBox2D(ForceInit) : FBox2D(Polygon);
+}
+
+void CollisionResolver::AddPlaced(const FCollisionFootprint &Footprint)
+{
+	const FBox2D Bounds = Footprint.GetBounds2D();
+	if (!Bounds.bIsValid) return;
+
+	const int32 Index = Placed.Add(Footprint);
+	PlacedBounds.Add(Bounds);
+	ForEachCell(Bounds, CellSize, [&](const FIntPoint &Cell) { Cells.FindOrAdd(Cell).Add(Index); });
+}
+
+bool CollisionResolver::OverlapsPlaced(const FCollisionFootprint &Footprint, const FVector2D &Offset) const
+{
+	const FBox2D Bounds = Footprint.GetBounds2D().ShiftBy(Offset);
+	if (!Bounds.bIsValid) return false;
+
+	TSet<int32, DefaultKeyFuncs<int32>, TInlineSetAllocator<16>> Tested;
+	bool bOverlaps = false;
+
+	ForEachCell(Bounds, CellSize, [&](const FIntPoint &Cell)
+	{
+		if (bOverlaps) return;
+
+		const TArray<int32> *Indices = Cells.Find(Cell);
+		if (!Indices) return;
+
+		for (int32 Index : *Indices)
+		{
+			bool bAlreadyTested = false;
+			Tested.Add(Index, &bAlreadyTested);
+			if (bAlreadyTested) continue;
+
+			const FCollisionFootprint &Other = Placed[Index];
+			if (Other.Actor == Footprint.Actor) continue;
+			if (Other.MaxZ <= Footprint.MinZ || Footprint.MaxZ <= Other.MinZ) continue;
+			if (!PlacedBounds[Index].Intersect(Bounds)) continue;
+
+			if (PolygonsOverlap(Footprint.Polygon, Offset, Other.Polygon))
+			{
+				bOverlaps = true;
+				return;
+			}
+		}
+	});
+
+	return bOverlaps;
+}
+
+bool CollisionResolver::OverlapsUnknownObstacle(UWorld *World, const FCollisionFootprint &Footprint, const FBox &Box) const
+{
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(PushOutOfCollision), /* bTraceComplex */ true, /* Ignore Actor */ Footprint.Actor.Get());
+
+	TArray<FOverlapResult> Overlaps;
+	World->OverlapMultiByChannel(Overlaps, Box.GetCenter(), FQuat::Identity, ECC_Visibility, FCollisionShape::MakeBox(Box.GetExtent()), QueryParams);
+
+	for (const FOverlapResult &Overlap : Overlaps)
+	{
+		const AActor *Owner = Overlap.GetActor();
+		if (Owner && (KnownActors.Contains(Owner) || IgnoredActors.Contains(Owner))) continue;
+		return true;
+	}
+
+	return false;
+}
+
+void CollisionResolver::Resolve(UWorld *World, TArray<FCollisionFootprint> &Footprints)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("CollisionResolver::Resolve");
+	check(IsInGameThread());
+
+	if (!IsValid(World) || Footprints.IsEmpty()) return;
+
+	if (!bIgnoredActorsFound)
+	{
+		TArray<AActor*> TaggedActors;
+		UGameplayStatics::GetAllActorsWithTag(World, FName("no-push-collision"), TaggedActors);
+		for (AActor *TaggedActor : TaggedActors) IgnoredActors.Add(TaggedActor);
+		bIgnoredActorsFound = true;
+	}
+
+	const int NumFootprints = Footprints.Num();
+
+	// cells are about the size of a footprint, so that each footprint only covers a few cells
+	if (CellSize <= 0)
+	{
+		double TotalSize = 0;
+		for (const FCollisionFootprint &Footprint : Footprints)
+		{
+			const FBox2D Bounds = Footprint.GetBounds2D();
+			if (Bounds.bIsValid) TotalSize += Bounds.GetSize().GetMax();
+		}
+		CellSize = FMath::Max(100.0, TotalSize / NumFootprints);
+	}
+
+	/* Bounds of the actors to push, and region covering all their candidate locations */
+
+	TArray<FBox> Boxes;
+	Boxes.Init(FBox(ForceInit), NumFootprints);
+	FBox Region(ForceInit);
+
+	for (int i = 0; i < NumFootprints; i++)
+	{
+		FCollisionFootprint &Footprint = Footprints[i];
+		if (!Footprint.Actor.IsValid()) continue;
+
+		KnownActors.Add(Footprint.Actor.Get());
+
+		if (!Footprint.bPushOutOfCollision) continue;
+
+		USceneComponent* RootComponent = Footprint.Actor->GetRootComponent();
+		if (IsValid(RootComponent)) RootComponent->SetMobility(EComponentMobility::Movable);
+
+		FVector Origin;
+		FVector HalfExtent;
+		Footprint.Actor->GetActorBounds(/* bOnlyCollidingComponents */ false, Origin, HalfExtent);
+		Boxes[i] = FBox(Origin - HalfExtent, Origin + HalfExtent);
+
+		const double MaxDistance = FMath::Max(0, Footprint.MaxSteps) * Footprint.StepSize;
+		Region += Boxes[i].ExpandBy(FVector(MaxDistance, MaxDistance, 0));
+	}
+
+	if (!Region.IsValid) return;
+
+	/* Obstacles unknown to the resolver, gathered with a single query over the whole region */
+
+	TArray<FBox> Obstacles;
+	TArray<int32> LargeObstacles;
+	TMap<FIntPoint, TArray<int32>> ObstacleCells;
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE_STR("CollisionResolver::FindObstacles");
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(PushOutOfCollision), /* bTraceComplex */ true);
+		TArray<FOverlapResult> Overlaps;
+		World->OverlapMultiByChannel(Overlaps, Region.GetCenter(), FQuat::Identity, ECC_Visibility, FCollisionShape::MakeBox(Region.GetExtent()), QueryParams);
+
+		TSet<const UPrimitiveComponent*> Components;
+		for (const FOverlapResult &Overlap : Overlaps)
+		{
+			const UPrimitiveComponent *Component = Overlap.GetComponent();
+			if (!IsValid(Component) || Components.Contains(Component)) continue;
+			Components.Add(Component);
+
+			const AActor *Owner = Overlap.GetActor();
+			if (Owner && (KnownActors.Contains(Owner) || IgnoredActors.Contains(Owner))) continue;
+
+			const FBox Box = Component->Bounds.GetBox();
+			const FBox2D Box2D(FVector2D(Box.Min), FVector2D(Box.Max));
+			const int32 Index = Obstacles.Add(Box);
+
+			if (NumCells(Box2D, CellSize) > MaxObstacleCells)
+			{
+				LargeObstacles.Add(Index);
+			}
+			else
+			{
+				ForEachCell(Box2D, CellSize, [&](const FIntPoint &Cell) { ObstacleCells.FindOrAdd(Cell).Add(Index); });
+			}
+		}
+	}
+
+	/* Candidate locations which might hit an unknown obstacle, and need a physics query, computed in parallel */
+
+	TArray<TBitArray<>> NeedsPhysicsQuery;
+	NeedsPhysicsQuery.SetNum(NumFootprints);
+
+	ParallelFor(TEXT("CollisionResolver::ClassifyCandidates"), NumFootprints, 1, [&](int32 i)
+	{
+		if (!Boxes[i].IsValid) return;
+
+		const FCollisionFootprint &Footprint = Footprints[i];
+		const int Num = NumCandidates(Footprint);
+		NeedsPhysicsQuery[i].Init(false, Num);
+
+		for (int Candidate = 0; Candidate < Num; Candidate++)
+		{
+			const FBox Box = Boxes[i].ShiftBy(FVector(GetCandidateOffset(Footprint, Candidate), 0));
+
+			bool bMayHit = false;
+			for (int32 Index : LargeObstacles)
+			{
+				if (Obstacles[Index].Intersect(Box)) { bMayHit = true; break; }
+			}
+
+			if (!bMayHit)
+			{
+				ForEachCell(FBox2D(FVector2D(Box.Min), FVector2D(Box.Max)), CellSize, [&](const FIntPoint &Cell)
+				{
+					if (bMayHit) return;
+					const TArray<int32> *Indices = ObstacleCells.Find(Cell);
+					if (!Indices) return;
+					for (int32 Index : *Indices)
+					{
+						if (Obstacles[Index].Intersect(Box)) { bMayHit = true; return; }
+					}
+				});
+			}
+
+			NeedsPhysicsQuery[i][Candidate] = bMayHit;
+		}
+	});
+
+	/* Footprints are placed in order, so that each one is tested against the previous ones */
+
+	int NumMoved = 0;
+	int NumPhysicsQueries = 0;
+
+	for (int i = 0; i < NumFootprints; i++)
+	{
+		FCollisionFootprint &Footprint = Footprints[i];
+		if (!Footprint.Actor.IsValid()) continue;
+
+		if (Boxes[i].IsValid)
+		{
+			const int Num = NumCandidates(Footprint);
+			for (int Candidate = 0; Candidate < Num; Candidate++)
+			{
+				const FVector2D Offset = GetCandidateOffset(Footprint, Candidate);
+				if (OverlapsPlaced(Footprint, Offset)) continue;
+
+				if (NeedsPhysicsQuery[i][Candidate])
+				{
+					NumPhysicsQueries++;
+					if (OverlapsUnknownObstacle(World, Footprint, Boxes[i].ShiftBy(FVector(Offset, 0)))) continue;
+				}
+
+				if (Candidate > 0)
+				{
+					Footprint.Actor->SetActorLocation(Footprint.Actor->GetActorLocation() + FVector(Offset, 0));
+					for (FVector2D &Vertex : Footprint.Polygon) Vertex += Offset;
+					NumMoved++;
+				}
+				break;
+			}
+		}
+
+		if (Footprint.bBlocksOthers) AddPlaced(Footprint);
+	}
+
+	UE_LOG(LogLCCommon, Log, TEXT("Resolved collisions of %d actors (%d moved) with %d obstacles and %d physics queries"),
+		NumFootprints, NumMoved, Obstacles.Num(), NumPhysicsQueries
+	);
+}
@@ -2,6 +2,7 @@
 
 #include "LCCommon/LCBlueprintLibrary.h"
 #include "LCCommon/LogLCCommon.h"
+#include "LCCommon/CollisionResolver.h"
 #include "ConcurrencyHelpers/LCReporter.h"
 #include "EngineUtils.h"
 #include "Kismet/GameplayStatics.h"
@@ -17,6 +18,25 @@
 
 #define LOCTEXT_NAMESPACE "FLandscapeCombinatorModule"
 
+FString ULCBlueprintLibrary::DescribeObjects(const TArray<UObject*> &Objects, int MaxNames)
+{
+	FString Result;
+	int NumValidObjects = 0;
+	for (UObject* Object : Objects)
+	{
+		if (!IsValid(Object)) continue;
+		if (NumValidObjects < MaxNames) Result += Object->GetName() + "\n";
+		NumValidObjects++;
+	}
+
+	if (NumValidObjects > MaxNames)
+	{
+		Result += FString::Printf(TEXT("... and %d more object(s)\n"), NumValidObjects - MaxNames);
+	}
+
+	return Result;
+}
+
 void ULCBlueprintLibrary::SortByLabel(UPARAM(ref) TArray<AActor*> &Actors)
 {
 	Actors.Sort([](const AActor& Actor1, const AActor& Actor2) {
@@ -157,47 +177,8 @@ void ULCBlueprintLibrary::PushOutOfCollision(TWeakObjectPtr<AActor> Actor, int M
 
 	if (!Actor.IsValid()) return;
 
-	UWorld* World = Actor->GetWorld();
-	if (!IsValid(World)) return;
-
-	USceneComponent* RootComponent = Actor->GetRootComponent();
-	if (IsValid(RootComponent)) RootComponent->SetMobility(EComponentMobility::Movable);
-
-	const FVector ActorLocation = Actor->GetActorLocation();
-	FVector Origin;
-	FVector HalfExtent;
-	Actor->GetActorBounds(/* bOnlyCollidingComponents */ false, Origin, HalfExtent);
-
-	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(PushOutOfCollision), /* bTraceComplex */ true, /* Ignore Actor */ Actor.Get());
-
-	TArray<AActor*> TaggedActors;
-	UGameplayStatics::GetAllActorsWithTag(World, FName("no-push-collision"), TaggedActors);
-	QueryParams.AddIgnoredActors(TaggedActors);
-
-	FHitResult Hit;
-	const FCollisionShape Shape = FCollisionShape::MakeBox(HalfExtent);
-	if (!World->OverlapAnyTestByChannel(ActorLocation, FQuat::Identity, ECC_Visibility, FCollisionShape::MakeBox(HalfExtent), QueryParams)) return;
-
-	static const FVector2D Directions[] =
-	{
-		{ 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
-		{ 0.7071f,  0.7071f }, { 0.7071f, -0.7071f },
-		{ -0.7071f, 0.7071f }, { -0.7071f, -0.7071f }
-	};
-
-	for (auto &D2 : Directions)
-	{
-		const FVector Dir(D2.X, D2.Y, 0);
-		for (int Step = 1; Step <= MaxSteps; Step++)
-		{
-			const FVector Candidate = ActorLocation + Dir * (StepSize * Step);
-			if (!World->OverlapAnyTestByChannel(Candidate, FQuat::Identity, ECC_Visibility, FCollisionShape::MakeBox(HalfExtent), QueryParams))
-			{
-				Actor->SetActorLocation(Candidate);
-				return;
-			}
-		}
-	}
+	TArray<FCollisionFootprint> Footprints = { FCollisionFootprint::FromActorBounds(Actor.Get(), MaxSteps, StepSize) };
+	CollisionResolver().Resolve(Actor->GetWorld(), Footprints);
 }
 
 
@@ -238,11 +219,53 @@ bool ULCBlueprintLibrary::HasActor(UWorld &World, FFolder InFolder)
 
 void ULCBlueprintLibrary::DeleteFolder(UWorld &World, FFolder Folder)
 {
-	if (Folder != Folder.GetRootObject() && !HasActor(World, Folder))
+	DeleteEmptyFolders(World, { Folder });
+}
+
+void ULCBlueprintLibrary::DeleteEmptyFolders(UWorld &World, const TSet<FFolder> &Folders)
+{
+	// the candidates are the given folders and all their ancestors
+	TSet<FFolder> Candidates;
+	for (const FFolder &Folder : Folders)
+	{
+		FFolder RootObject = Folder.GetRootObject();
+		for (FFolder Current = Folder; Current != RootObject && !Candidates.Contains(Current); Current = Current.GetParent())
+		{
+			Candidates.Add(Current);
+		}
+	}
+
+	if (Candidates.IsEmpty()) return;
+
+	// folders which still contain an actor, directly or in a subfolder
+	TSet<FFolder> NonEmptyFolders;
+	for (FActorIterator ActorIt(&World); ActorIt; ++ActorIt)
+	{
+		AActor* CurrentActor = *ActorIt;
+		if (!IsValid(CurrentActor)) continue;
+
+		FFolder Folder = CurrentActor->GetFolder();
+		FFolder RootObject = Folder.GetRootObject();
+		for (; Folder != RootObject && !NonEmptyFolders.Contains(Folder); Folder = Folder.GetParent())
+		{
+			NonEmptyFolders.Add(Folder);
+		}
+	}
+
+	TArray<FFolder> EmptyFolders;
+	for (const FFolder &Folder : Candidates)
+	{
+		if (!NonEmptyFolders.Contains(Folder)) EmptyFolders.Add(Folder);
+	}
+
+	// subfolders are deleted before their parents
+	EmptyFolders.Sort([](const FFolder &A, const FFolder &B) {
+		return A.GetPath().ToString().Len() > B.GetPath().ToString().Len();
+	});
+
+	for (const FFolder &Folder : EmptyFolders)
 	{
 		FActorFolders::Get().DeleteFolder(World, Folder);
-		FFolder Parent = Folder.GetParent();
-		if (Parent != Folder.GetRootObject()) DeleteFolder(World, Parent);
 	}
 }
 
@@ -36,10 +36,19 @@ bool ILCGenerator::Generate(FName SpawnedActorsPath, bool bIsUserInitiated)
 			return false;
 		}
 
-		int Zoom = PositionBasedGeneration->ZoomLevel;		
-		FVector2D Location2D, Coordinates;
-		Location2D.X = Position.X;
-		Location2D.Y = Position.Y;
+		/* The tiles state of the component (GeneratedTiles, TileObjects, PrefetchCancellation) is also reset from the game thread
+		 * (ClearGeneratedTilesCache), so it is only read and written on the game thread. */
+
+		// stale prefetches would compete with the tiles needed now
+		TSet<FTile> GeneratedTiles;
+		Concurrency::RunOnGameThreadAndWait([PositionBasedGeneration, &GeneratedTiles]() -> bool
+		{
+			if (PositionBasedGeneration->PrefetchCancellation.IsValid()) PositionBasedGeneration->PrefetchCancellation->Cancel();
+			GeneratedTiles = PositionBasedGeneration->GeneratedTiles;
+			return true;
+		});
+
+		int Zoom = PositionBasedGeneration->ZoomLevel;
 
 		UGlobalCoordinates *GlobalCoordinates = ALevelCoordinates::GetGlobalCoordinates(Self->GetWorld(), true);
 		if (!IsValid(GlobalCoordinates))
@@ -48,22 +57,41 @@ bool ILCGenerator::Generate(FName SpawnedActorsPath, bool bIsUserInitiated)
 			return false;
 		}
 
-		if (!GlobalCoordinates->GetCRSCoordinatesFromUnrealLocation(Location2D, "EPSG:4326", Coordinates)) return false;
-
 		double n = 1 << Zoom;
-		double LatRad = FMath::DegreesToRadians(Coordinates.Y);
-		int CurrentX = (Coordinates.X + 180) / 360 * n;
-		int CurrentY = (1.0 - asinh(FMath::Tan(LatRad)) / UE_PI) / 2.0 * n;
+		const int MaxTile = (1 << Zoom) - 1;
+		auto GetTile = [GlobalCoordinates, Zoom, n, MaxTile](const FVector &Location, FTile &OutTile)
+		{
+			FVector2D Coordinates;
+			if (!GlobalCoordinates->GetCRSCoordinatesFromUnrealLocation(FVector2D(Location.X, Location.Y), "EPSG:4326", Coordinates)) return false;
+
+			double LatRad = FMath::DegreesToRadians(Coordinates.Y);
+			int X = (Coordinates.X + 180) / 360 * n;
+			int Y = (1.0 - asinh(FMath::Tan(LatRad)) / UE_PI) / 2.0 * n;
+			OutTile = FTile(Zoom, FMath::Clamp(X, 0, MaxTile), FMath::Clamp(Y, 0, MaxTile));
+			return true;
+		};
+
+		FTile CurrentTile, PredictedTile;
+		if (!GetTile(Position, CurrentTile)) return false;
+		if (!GetTile(PositionBasedGeneration->PredictPosition(Position), PredictedTile)) PredictedTile = CurrentTile;
 
+		int CurrentX = CurrentTile.X;
+		int CurrentY = CurrentTile.Y;
 		int TileDist = PositionBasedGeneration->GenerateAllTilesAtDistance;
-		CurrentX = FMath::Clamp(CurrentX, 0, n - 1);
-		CurrentY = FMath::Clamp(CurrentY, 0, n - 1);
-		int MinX = FMath::Clamp(CurrentX - TileDist, 0, n - 1);
-		int MaxX = FMath::Clamp(CurrentX + TileDist, 0, n - 1);
-		int MinY = FMath::Clamp(CurrentY - TileDist, 0, n - 1);
-		int MaxY = FMath::Clamp(CurrentY + TileDist, 0, n - 1);
+		int MinX = FMath::Clamp(CurrentX - TileDist, 0, MaxTile);
+		int MaxX = FMath::Clamp(CurrentX + TileDist, 0, MaxTile);
+		int MinY = FMath::Clamp(CurrentY - TileDist, 0, MaxTile);
+		int MaxY = FMath::Clamp(CurrentY + TileDist, 0, MaxTile);
 
-		UE_LOG(LogLCCommon, Log, TEXT("Zoom = %d, CurrentX = %d, CurrentY = %d"), Zoom, CurrentX, CurrentY);
+		UE_LOG(LogLCCommon, Log, TEXT("Zoom = %d, CurrentX = %d, CurrentY = %d, PredictedX = %d, PredictedY = %d"),
+			Zoom, CurrentX, CurrentY, PredictedTile.X, PredictedTile.Y
+		);
+
+		// tiles closest to the player are the most urgent
+		auto ByDistanceToCurrentTile = [CurrentX, CurrentY](const FTile &A, const FTile &B)
+		{
+			return FMath::Square(A.X - CurrentX) + FMath::Square(A.Y - CurrentY) < FMath::Square(B.X - CurrentX) + FMath::Square(B.Y - CurrentY);
+		};
 
 		TArray<FTile> MissingTiles;
 		for (int X = MinX; X <= MaxX; ++X)
@@ -71,31 +99,39 @@ bool ILCGenerator::Generate(FName SpawnedActorsPath, bool bIsUserInitiated)
 			for (int Y = MinY; Y <= MaxY; ++Y)
 			{
 				FTile Tile(Zoom, X, Y);
-				if (!PositionBasedGeneration->GeneratedTiles.Contains(Tile)) MissingTiles.Add(Tile);
+				if (!GeneratedTiles.Contains(Tile)) MissingTiles.Add(Tile);
 			}
 		}
+		MissingTiles.Sort(ByDistanceToCurrentTile);
+
+		// tiles around the predicted position which are not generated now
+		TArray<FTile> TilesToPrefetch;
+		if (PositionBasedGeneration->PrefetchSeconds > 0)
+		{
+			for (int X = FMath::Max(0, PredictedTile.X - TileDist); X <= FMath::Min(MaxTile, PredictedTile.X + TileDist); ++X)
+			{
+				for (int Y = FMath::Max(0, PredictedTile.Y - TileDist); Y <= FMath::Min(MaxTile, PredictedTile.Y + TileDist); ++Y)
+				{
+					FTile Tile(Zoom, X, Y);
+					const bool bGeneratedNow = X >= MinX && X <= MaxX && Y >= MinY && Y <= MaxY;
+					if (!bGeneratedNow && !GeneratedTiles.Contains(Tile)) TilesToPrefetch.Add(Tile);
+				}
+			}
+			TilesToPrefetch.Sort(ByDistanceToCurrentTile);
+		}
+
+		bool bSuccess = true;
 
 		// if all tiles are missing, we regenerate the whole rectangle
 		if (MissingTiles.Num() == (MaxX - MinX + 1) * (MaxY - MinY + 1))
 		{
-			if (!ConfigureForTiles(Zoom, MinX, MaxX, MinY, MaxY)) return false;
 			UE_LOG(LogLCCommon, Log,
 				TEXT("All tiles from (%d, %d, %d) to (%d, %d, %d) are missing, generating them now"),
 				Zoom, MinX, MinY,
 				Zoom, MaxX, MaxY
 			);
 
-			if (OnGenerate(SpawnedActorsPath, bIsUserInitiated))
-			{
-				PositionBasedGeneration->GeneratedTiles.Append(MissingTiles);
-				GenerationFinished(true);
-				return true;
-			}
-			else
-			{
-				GenerationFinished(false);
-				return false;
-			}
+			bSuccess = GenerateTiles(PositionBasedGeneration, MissingTiles, Zoom, MinX, MaxX, MinY, MaxY, SpawnedActorsPath, bIsUserInitiated);
 		}
 		else if (MissingTiles.Num() > 0)
 		// we generate tile by tile
@@ -109,23 +145,18 @@ bool ILCGenerator::Generate(FName SpawnedActorsPath, bool bIsUserInitiated)
 			for (FTile& Tile : MissingTiles)
 			{
 				UE_LOG(LogLCCommon, Log, TEXT("Generating Tile (%d, %d, %d)"), Tile.Zoom, Tile.X, Tile.Y);
-				if (!ConfigureForTiles(Tile.Zoom, Tile.X, Tile.X, Tile.Y, Tile.Y)) return false;
 
-				if (OnGenerate(SpawnedActorsPath, bIsUserInitiated))
+				if (GenerateTiles(PositionBasedGeneration, { Tile }, Tile.Zoom, Tile.X, Tile.X, Tile.Y, Tile.Y, SpawnedActorsPath, bIsUserInitiated))
 				{
 					UE_LOG(LogLCCommon, Log, TEXT("Finished Generating Tile (%d, %d, %d)"), Tile.Zoom, Tile.X, Tile.Y);
-					PositionBasedGeneration->GeneratedTiles.Add(Tile);
 				}
 				else
 				{
 					UE_LOG(LogLCCommon, Error, TEXT("Faield to generating Tile (%d, %d, %d)"), Tile.Zoom, Tile.X, Tile.Y);
-					GenerationFinished(false);
-					return false;
+					bSuccess = false;
+					break;
 				}
 			}
-
-			GenerationFinished(true);
-			return true;
 		}
 		else
 		{
@@ -134,10 +165,16 @@ bool ILCGenerator::Generate(FName SpawnedActorsPath, bool bIsUserInitiated)
 				Zoom, MinX, MinY,
 				Zoom, MaxX, MaxY
 			);
+		}
 
-			GenerationFinished(true);
-			return true;
+		if (bSuccess)
+		{
+			StartPrefetch(PositionBasedGeneration, TilesToPrefetch);
+			UnloadFarTiles(PositionBasedGeneration, CurrentTile, TileDist);
 		}
+
+		GenerationFinished(bSuccess);
+		return bSuccess;
 	}
 	else
 	{
@@ -147,6 +184,126 @@ bool ILCGenerator::Generate(FName SpawnedActorsPath, bool bIsUserInitiated)
 	}
 }
 
+bool ILCGenerator::GenerateTiles(
+	ULCPositionBasedGeneration *PositionBasedGeneration, const TArray<FTile> &Tiles,
+	int Zoom, int MinX, int MaxX, int MinY, int MaxY, FName SpawnedActorsPath, bool bIsUserInitiated
+)
+{
+	if (!ConfigureForTiles(Zoom, MinX, MaxX, MinY, MaxY)) return false;
+
+	// objects are only tracked when they might be unloaded later
+	const bool bTrackObjects = PositionBasedGeneration->MaxGeneratedTiles > 0 && CanUnloadTiles();
+
+	TSet<UObject*> ObjectsBefore;
+	if (bTrackObjects)
+	{
+		Concurrency::RunOnGameThreadAndWait([this, &ObjectsBefore]() {
+			ObjectsBefore.Append(GetGeneratedObjects());
+			return true;
+		});
+	}
+
+	if (!OnGenerate(SpawnedActorsPath, bIsUserInitiated)) return false;
+
+	Concurrency::RunOnGameThreadAndWait([this, PositionBasedGeneration, &Tiles, bTrackObjects, &ObjectsBefore]() {
+		PositionBasedGeneration->GeneratedTiles.Append(Tiles);
+		if (!bTrackObjects) return true;
+
+		TArray<TWeakObjectPtr<UObject>> NewObjects;
+		for (UObject *Object : GetGeneratedObjects())
+		{
+			if (IsValid(Object) && !ObjectsBefore.Contains(Object)) NewObjects.Add(Object);
+		}
+
+		for (const FTile &Tile : Tiles) PositionBasedGeneration->TileObjects.Add(Tile, NewObjects);
+		return true;
+	});
+
+	return true;
+}
+
+void ILCGenerator::StartPrefetch(ULCPositionBasedGeneration *PositionBasedGeneration, TArray<FTile> Tiles)
+{
+	if (Tiles.IsEmpty()) return;
+
+	// the sources are resolved on the game thread, so that the background task does not access this object
+	TFunction<bool(LCCancellationToken*)> PrefetchTask;
+	TSharedPtr<LCCancellationToken> Cancellation = MakeShared<LCCancellationToken>();
+	Concurrency::RunOnGameThreadAndWait([this, PositionBasedGeneration, &Tiles, &PrefetchTask, &Cancellation]() -> bool
+	{
+		PrefetchTask = MakePrefetchTask(Tiles);
+		if (PrefetchTask) PositionBasedGeneration->PrefetchCancellation = Cancellation;
+		return true;
+	});
+	if (!PrefetchTask) return;
+
+	UE_LOG(LogLCCommon, Log, TEXT("Prefetching %d tiles around the predicted position"), Tiles.Num());
+
+	Concurrency::RunAsync([PrefetchTask = MoveTemp(PrefetchTask), Cancellation]() {
+		if (Cancellation->IsCancelled()) return;
+		if (!PrefetchTask(Cancellation.Get()) && !Cancellation->IsCancelled())
+		{
+			UE_LOG(LogLCCommon, Log, TEXT("Some tiles could not be prefetched, they will be fetched when needed"));
+		}
+	});
+}
+
+void ILCGenerator::UnloadFarTiles(ULCPositionBasedGeneration *PositionBasedGeneration, const FTile &CurrentTile, int KeepAtDistance)
+{
+	if (PositionBasedGeneration->MaxGeneratedTiles <= 0 || !CanUnloadTiles()) return;
+
+	// the tiles state of the component is only accessed on the game thread, where the objects are also deleted
+	Concurrency::RunOnGameThreadAndWait([PositionBasedGeneration, &CurrentTile, KeepAtDistance]() -> bool
+	{
+		const int MaxGeneratedTiles = PositionBasedGeneration->MaxGeneratedTiles;
+		if (PositionBasedGeneration->GeneratedTiles.Num() <= MaxGeneratedTiles) return true;
+
+		auto Distance = [&CurrentTile](const FTile &Tile)
+		{
+			return FMath::Max(FMath::Abs(Tile.X - CurrentTile.X), FMath::Abs(Tile.Y - CurrentTile.Y));
+		};
+
+		// only tiles whose objects are known can be unloaded, the farthest ones first
+		TArray<FTile> Candidates;
+		for (auto &[Tile, Objects] : PositionBasedGeneration->TileObjects)
+		{
+			if (Tile.Zoom == CurrentTile.Zoom && Distance(Tile) > KeepAtDistance) Candidates.Add(Tile);
+		}
+		Candidates.Sort([&Distance](const FTile &A, const FTile &B) { return Distance(A) > Distance(B); });
+
+		TArray<FTile> TilesToUnload;
+		for (const FTile &Tile : Candidates)
+		{
+			if (PositionBasedGeneration->GeneratedTiles.Num() - TilesToUnload.Num() <= MaxGeneratedTiles) break;
+			TilesToUnload.Add(Tile);
+		}
+
+		if (TilesToUnload.IsEmpty()) return true;
+
+		TArray<TWeakObjectPtr<UObject>> UnloadedObjects;
+		for (const FTile &Tile : TilesToUnload)
+		{
+			UnloadedObjects.Append(PositionBasedGeneration->TileObjects.FindAndRemoveChecked(Tile));
+			PositionBasedGeneration->GeneratedTiles.Remove(Tile);
+		}
+
+		// objects shared with tiles that remain loaded are kept
+		TSet<TWeakObjectPtr<UObject>> KeptObjects;
+		for (auto &[Tile, Objects] : PositionBasedGeneration->TileObjects) KeptObjects.Append(Objects);
+
+		TArray<UObject*> ObjectsToDelete;
+		for (const TWeakObjectPtr<UObject> &Object : UnloadedObjects)
+		{
+			if (!KeptObjects.Contains(Object) && Object.IsValid()) ObjectsToDelete.AddUnique(Object.Get());
+		}
+
+		UE_LOG(LogLCCommon, Log, TEXT("Unloading %d tiles far from the player (%d objects)"), TilesToUnload.Num(), ObjectsToDelete.Num());
+
+		DeleteObjects_GameThread(ObjectsToDelete);
+		return true;
+	});
+}
+
 bool ILCGenerator::DeleteGeneratedObjects(bool bSkipPrompt)
 {
 	return Concurrency::RunOnGameThreadAndWait([this, bSkipPrompt]() {
@@ -173,17 +330,8 @@ bool ILCGenerator::DeleteGeneratedObjects_GameThread(bool bSkipPrompt)
 	UE_LOG(LogLCCommon, Log, TEXT("There are %d object(s) to delete"), GeneratedObjects.Num());
 	if (!bSkipPrompt)
 	{
-		FString ObjectsString;
-		for (UObject* Object : GeneratedObjects)
-		{
-			if (IsValid(Object)) ObjectsString += Object->GetName() + "\n";
-			else
-			{
-				UE_LOG(LogLCCommon, Warning, TEXT("Skipping delete invalid object"));
-			}
-		}
-
-		if (!ObjectsString.Replace(TEXT("\n"), TEXT("")).Replace(TEXT("  "), TEXT("")).IsEmpty())
+		FString ObjectsString = ULCBlueprintLibrary::DescribeObjects(GeneratedObjects);
+		if (!ObjectsString.IsEmpty())
 		{
 			if (!LCReporter::ShowMessage(
 				FText::Format(
@@ -200,20 +348,30 @@ bool ILCGenerator::DeleteGeneratedObjects_GameThread(bool bSkipPrompt)
 		}
 	}
 
-	for (UObject* Object: GeneratedObjects)
+	DeleteObjects_GameThread(GeneratedObjects);
+	GeneratedObjects.Empty();
+	return true;
+}
+
+void ILCGenerator::DeleteObjects_GameThread(const TArray<UObject*> &Objects)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("ILCGenerator::DeleteObjects_GameThread");
+
+#if WITH_EDITOR
+	// the folders of the deleted actors are grouped by world, so that the folders left empty are computed
+	// in one pass over each world, instead of scanning the whole world after each actor
+	TMap<UWorld*, TSet<FFolder>> FoldersByWorld;
+#endif
+
+	for (UObject* Object: Objects)
 	{
 		if (AActor *Actor = Cast<AActor>(Object))
 		{
 #if WITH_EDITOR
-			UWorld *World = Actor->GetWorld();
-			FFolder Folder = Actor->GetFolder();
+			if (UWorld *World = Actor->GetWorld()) FoldersByWorld.FindOrAdd(World).Add(Actor->GetFolder());
 #endif
 
 			Actor->Destroy();
-
-#if WITH_EDITOR
-			if (World) ULCBlueprintLibrary::DeleteFolder(*World, Folder);
-#endif
 		}
 		else if (UActorComponent *Component = Cast<UActorComponent>(Object))
 		{
@@ -224,8 +382,13 @@ bool ILCGenerator::DeleteGeneratedObjects_GameThread(bool bSkipPrompt)
 			Object->MarkAsGarbage();
 		}
 	}
-	GeneratedObjects.Empty();
-	return true;
+
+#if WITH_EDITOR
+	for (auto &[World, Folders] : FoldersByWorld)
+	{
+		ULCBlueprintLibrary::DeleteEmptyFolders(*World, Folders);
+	}
+#endif
 }
 
 #if WITH_EDITOR
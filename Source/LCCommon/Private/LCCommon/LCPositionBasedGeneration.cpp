@@ -6,4 +6,22 @@
 void ULCPositionBasedGeneration::ClearGeneratedTilesCache()
 {
 	GeneratedTiles.Empty();
+	TileObjects.Empty();
+	if (PrefetchCancellation.IsValid()) PrefetchCancellation->Cancel();
+	PrefetchCancellation.Reset();
+}
+
+FVector ULCPositionBasedGeneration::PredictPosition(const FVector &Position)
+{
+	const double Time = FPlatformTime::Seconds();
+	FVector Velocity = FVector::ZeroVector;
+	if (LastPositionTime >= 0 && Time > LastPositionTime)
+	{
+		Velocity = (Position - LastPosition) / (Time - LastPositionTime);
+	}
+
+	LastPosition = Position;
+	LastPositionTime = Time;
+
+	return Position + Velocity * FMath::Max(0.0, PrefetchSeconds);
 }
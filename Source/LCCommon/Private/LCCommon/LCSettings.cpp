@@ -1,3 +1,25 @@
 // Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
 
 #include "LCCommon/LCSettings.h"
+#include "ConcurrencyHelpers/Executor.h"
+
+void ULCSettings::PostInitProperties()
+{
+	Super::PostInitProperties();
+	if (HasAnyFlags(RF_ClassDefaultObject)) ApplyConcurrencySettings();
+}
+
+#if WITH_EDITOR
+void ULCSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	if (HasAnyFlags(RF_ClassDefaultObject)) ApplyConcurrencySettings();
+}
+#endif
+
+void ULCSettings::ApplyConcurrencySettings() const
+{
+	Executor::SetMaxConcurrency(EConcurrencyResource::Network, MaxNetworkConcurrency);
+	Executor::SetMaxConcurrency(EConcurrencyResource::DiskIO, MaxDiskIOConcurrency);
+	Executor::SetMaxConcurrency(EConcurrencyResource::CPU, MaxCPUConcurrency);
+}
@@ -0,0 +1,60 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+/* Footprint of an actor on the XY plane, in world space */
+struct LCCOMMON_API FCollisionFootprint
+{
+	TWeakObjectPtr<AActor> Actor;
+	TArray<FVector2D> Polygon;
+	double MinZ = 0;
+	double MaxZ = 0;
+
+	// when false, the actor is not moved, and is only an obstacle for the next footprints
+	bool bPushOutOfCollision = true;
+
+	// when false, the actor is not an obstacle for the next footprints (for instance when it has no collision)
+	bool bBlocksOthers = true;
+
+	int MaxSteps = 10;
+	double StepSize = 200;
+
+	/* Rectangular footprint from the bounds of the actor */
+	static FCollisionFootprint FromActorBounds(AActor *Actor, int MaxSteps, double StepSize);
+
+	FBox2D GetBounds2D() const;
+};
+
+/* Pushes actors out of collision, by trying to move them in 8 horizontal directions for a number of steps.
+ * Footprints given to the resolver are kept in a 2D spatial hash, and are tested against each other with polygon tests.
+ * Other obstacles are gathered with a single physics query over the whole region, and a candidate location only
+ * needs a physics query when it overlaps the bounds of one of these obstacles. Candidate locations are checked
+ * against these obstacle bounds in parallel. */
+class LCCOMMON_API CollisionResolver
+{
+public:
+	/* Must be called on the game thread. Footprints are resolved in order, each one being tested against the footprints
+	 * given before it (in this call or in previous calls), and against the other obstacles of the world.
+	 * The polygons of the footprints that are moved are updated accordingly. */
+	void Resolve(UWorld *World, TArray<FCollisionFootprint> &Footprints);
+
+private:
+	double CellSize = 0;
+	TArray<FCollisionFootprint> Placed;
+	TArray<FBox2D> PlacedBounds;
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	// actors known by the resolver, which are never treated as unknown obstacles
+	TSet<const AActor*> KnownActors;
+
+	// actors with the "no-push-collision" tag, found once per resolver
+	TSet<const AActor*> IgnoredActors;
+	bool bIgnoredActorsFound = false;
+
+	void AddPlaced(const FCollisionFootprint &Footprint);
+	bool OverlapsPlaced(const FCollisionFootprint &Footprint, const FVector2D &Offset) const;
+	bool OverlapsUnknownObstacle(UWorld *World, const FCollisionFootprint &Footprint, const FBox &Box) const;
+};
@@ -48,9 +48,27 @@ public:
 		double TotalWeight = 0.0;
 		for (const auto &Element: WeightedElements) TotalWeight += Element.Weight;
 
-		double RandomValue = FMath::RandRange(0.0, TotalWeight);
+		return GetWeightedIndex(WeightedElements, TotalWeight, FMath::RandRange(0.0, TotalWeight));
+	}
+
+	/* Same as GetRandomIndex, but draws from the given stream instead of the global random state */
+	template<typename T>
+	static int GetRandomIndex(const TArray<T> &WeightedElements, const FRandomStream &RandomStream)
+	{
+		int NumWeights = WeightedElements.Num();
+		if (NumWeights == 0) return -1;
+
+		double TotalWeight = 0.0;
+		for (const auto &Element: WeightedElements) TotalWeight += Element.Weight;
+
+		return GetWeightedIndex(WeightedElements, TotalWeight, RandomStream.FRandRange(0.0, TotalWeight));
+	}
+
+	template<typename T>
+	static int GetWeightedIndex(const TArray<T> &WeightedElements, double TotalWeight, double RandomValue)
+	{
 		double CurrentWeight = 0.0;
-		for (int i = 0; i < NumWeights; i++)
+		for (int i = 0; i < WeightedElements.Num(); i++)
 		{
 			CurrentWeight += WeightedElements[i].Weight;
 			if (RandomValue <= CurrentWeight) return i;
@@ -63,8 +81,13 @@ public:
 
 	static TSet<TObjectPtr<USplineComponent>> FindSplineComponents(UWorld *World, bool bIsUserInitiated, FName Tag, FName ComponentTag);
 
+	/* Pushes a single actor out of collision, CollisionResolver should be used directly to push many actors at once */
 	static void PushOutOfCollision(TWeakObjectPtr<AActor> Actor, int MaxSteps, double StepSize);
 
+	/* Names of the valid objects, one per line, for confirmation dialogs. Only the first MaxNames names are built,
+	 * followed by the number of remaining objects. Returns an empty string when there is no valid object. */
+	static FString DescribeObjects(const TArray<UObject*> &Objects, int MaxNames = 50);
+
 #if WITH_EDITOR
 
 	UFUNCTION(BlueprintCallable, Category="LandscapeCombinator")
@@ -74,6 +97,10 @@ public:
 
 	static void DeleteFolder(UWorld &World, FFolder Folder);
 
+	/* Deletes the given folders and their ancestors when they do not contain any actor anymore,
+	 * using a single pass over the actors of the world */
+	static void DeleteEmptyFolders(UWorld &World, const TSet<FFolder> &Folders);
+
 #endif
 };
 
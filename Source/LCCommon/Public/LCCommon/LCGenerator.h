@@ -41,6 +41,17 @@ public:
 		return false;
 	}
 
+	/* Returns a task that downloads what is needed to generate the given tiles later, the first tiles being the most urgent.
+	 * This is called on the game thread, while the task runs on a background thread: it must only capture plain values.
+	 * The tiles that have not started when the cancellation token is cancelled are skipped.
+	 * Returns nullptr when there is nothing to prefetch. */
+	virtual TFunction<bool(LCCancellationToken*)> MakePrefetchTask(const TArray<FTile> &Tiles) {
+		return nullptr;
+	}
+
+	/* Whether the objects generated for some tiles can be deleted without affecting the other tiles */
+	virtual bool CanUnloadTiles() const { return true; }
+
 	virtual bool OnGenerate(FName SpawnedActorsPathOverride, bool bIsUserInitiated) { return true; }
 
 	bool Generate(FName SpawnedActorsPath, bool bIsUserInitiated);
@@ -73,6 +84,15 @@ public:
 protected:
 	TWeakObjectPtr<AActor> Self;
 
+	static void DeleteObjects_GameThread(const TArray<UObject*> &Objects);
+
+	bool GenerateTiles(
+		ULCPositionBasedGeneration *PositionBasedGeneration, const TArray<FTile> &Tiles,
+		int Zoom, int MinX, int MaxX, int MinY, int MaxY, FName SpawnedActorsPath, bool bIsUserInitiated
+	);
+	void StartPrefetch(ULCPositionBasedGeneration *PositionBasedGeneration, TArray<FTile> Tiles);
+	void UnloadFarTiles(ULCPositionBasedGeneration *PositionBasedGeneration, const FTile &CurrentTile, int KeepAtDistance);
+
 	void GenerationFinished(bool bSuccess)
 	{
         TWeakObjectPtr<AActor> WeakSelf = Self;
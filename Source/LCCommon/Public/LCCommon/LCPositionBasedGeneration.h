@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Components/ActorComponent.h" 
+#include "ConcurrencyHelpers/Executor.h"
 #include "LCPositionBasedGeneration.generated.h"
 
 USTRUCT(BlueprintType)
@@ -62,9 +63,35 @@ public:
 	// Distance 0 means 1 tile, Distance 1 means 3x3=9 tiles, Distance 2 means 5x5=25 tiles, etc.
 	int GenerateAllTilesAtDistance = 1;
 
+	UPROPERTY(EditAnywhere, Category = "PositionBasedGeneration", meta=(DisplayPriority=6))
+	/* The tiles around the position where the player is expected to be after this many seconds, according to its
+	 * current velocity, are downloaded in the background so that they are ready when the player gets there.
+	 * Prefetching only applies to XYZ sources, when the tile cache is enabled. Set to 0 to disable it. */
+	double PrefetchSeconds = 10;
+
+	UPROPERTY(EditAnywhere, Category = "PositionBasedGeneration", meta=(DisplayPriority=7))
+	/* When more tiles than this are generated, the objects of the tiles farthest from the player are deleted.
+	 * 0 means that tiles are never unloaded. */
+	int MaxGeneratedTiles = 0;
+
 	UPROPERTY(DuplicateTransient)
 	TSet<FTile> GeneratedTiles;
 
+	/* Objects created when generating each tile. Tiles generated together share their objects,
+	 * which are deleted when all of these tiles are unloaded. */
+	TMap<FTile, TArray<TWeakObjectPtr<UObject>>> TileObjects;
+
+	/* Used to cancel the tiles of the previous prefetch which have not started yet */
+	TSharedPtr<LCCancellationToken> PrefetchCancellation;
+
+	/* Estimates the velocity of the player from the position given in the previous call,
+	 * and returns the position where the player will be after PrefetchSeconds */
+	FVector PredictPosition(const FVector &Position);
+
 	UFUNCTION(CallInEditor, BlueprintCallable, Category = "PositionBasedGeneration")
 	void ClearGeneratedTilesCache();
+
+private:
+	FVector LastPosition = FVector::ZeroVector;
+	double LastPositionTime = -1;
 };
@@ -20,6 +20,40 @@ public:
 	/* Folder to hold the downloaded and processed files */
 	FString TemporaryFolder = "";
 
+	UPROPERTY(config, EditAnywhere, Category = "LandscapeCombinator", meta=(DisplayPriority = "1"))
+	/* Keep downloaded XYZ and WMS tiles in a persistent cache, so that areas that were already downloaded do not need network access */
+	bool bEnableTileCache = true;
+
+	UPROPERTY(config, EditAnywhere, Category = "LandscapeCombinator", meta=(DisplayPriority = "2", EditCondition = "bEnableTileCache", EditConditionHides, ClampMin = "0", UIMin = "0"))
+	/* When the cache exceeds this size, the least recently used tiles are removed. Set to 0 for an unlimited cache. */
+	int32 TileCacheMaxSizeMB = 4096;
+
+	UPROPERTY(config, EditAnywhere, Category = "LandscapeCombinator", meta=(DisplayPriority = "3", EditCondition = "bEnableTileCache", EditConditionHides, ClampMin = "0", UIMin = "0"))
+	/* Cached tiles older than this number of days are revalidated with the server (using ETag and Last-Modified) before being used.
+	 * Set to 0 to always use cached tiles without network access. */
+	int32 TileCacheRevalidateAfterDays = 0;
+
+	UPROPERTY(config, EditAnywhere, Category = "LandscapeCombinator", meta=(DisplayPriority = "10", ClampMin = "1", UIMin = "1"))
+	/* Maximum number of simultaneous downloads */
+	int32 MaxNetworkConcurrency = 16;
+
+	UPROPERTY(config, EditAnywhere, Category = "LandscapeCombinator", meta=(DisplayPriority = "11", ClampMin = "1", UIMin = "1"))
+	/* Maximum number of tasks that read or write files at the same time */
+	int32 MaxDiskIOConcurrency = 4;
+
+	UPROPERTY(config, EditAnywhere, Category = "LandscapeCombinator", meta=(DisplayPriority = "12", ClampMin = "0", UIMin = "0"))
+	/* Maximum number of computation tasks running at the same time, 0 means one less than the number of logical cores */
+	int32 MaxCPUConcurrency = 0;
+
+	void PostInitProperties() override;
+
+#if WITH_EDITOR
+	void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	/* Sends the concurrency settings to the executor shared by the plugin */
+	void ApplyConcurrencySettings() const;
+
 	UPROPERTY(config, EditAnywhere, Category = "LandscapeCombinator", meta=(DisplayPriority = "100", DisplayName="MapTiler Token"))
 	FString MapTiler_Token = "";
 
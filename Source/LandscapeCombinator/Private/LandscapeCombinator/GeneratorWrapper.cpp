@@ -7,6 +7,7 @@
 #include "PropertyHandle.h"
 #include "Widgets/Layout/SBox.h"
 #include "IPropertyTypeCustomization.h"
+#include "IDetailChildrenBuilder.h"
 
 TSharedRef<IPropertyTypeCustomization> FGeneratorWrapperCustomization::MakeInstance()
 {
@@ -68,4 +69,10 @@ void FGeneratorWrapperCustomization::CustomizeHeader(TSharedRef<IPropertyHandle>
     ];
 }
 
+void FGeneratorWrapperCustomization::CustomizeChildren(TSharedRef<IPropertyHandle> StructHandle, IDetailChildrenBuilder& ChildBuilder, IPropertyTypeCustomizationUtils&)
+{
+    ChildBuilder.AddProperty(StructHandle->GetChildHandle("Inputs").ToSharedRef());
+    ChildBuilder.AddProperty(StructHandle->GetChildHandle("Outputs").ToSharedRef());
+}
+
 #endif
@@ -5,6 +5,7 @@
 #include "ConcurrencyHelpers/Concurrency.h"
 #include "HeightmapModifier/BlendLandscape.h"
 #include "Kismet/GameplayStatics.h"
+#include "Misc/ScopeLock.h"
 
 #if WITH_EDITOR
 #include "FileHelpers.h"
@@ -13,18 +14,80 @@
 
 #define LOCTEXT_NAMESPACE "FLandscapeCombinatorModule"
 
+namespace
+{
+	bool Intersects(const TArray<FName> &A, const TArray<FName> &B)
+	{
+		for (const FName &Name : A)
+		{
+			if (B.Contains(Name)) return true;
+		}
+		return false;
+	}
+
+	/* Generator J must wait for the earlier generator I when it reads what I writes, writes what I reads or writes,
+	 * or when one of them does not declare its inputs and outputs. */
+	bool DependsOn(const FGeneratorWrapper &J, const FGeneratorWrapper &I)
+	{
+		if (!J.DeclaresDependencies() || !I.DeclaresDependencies()) return true;
+		return Intersects(J.Inputs, I.Outputs) || Intersects(J.Outputs, I.Outputs) || Intersects(J.Outputs, I.Inputs);
+	}
+}
+
+bool ALandscapeCombination::RunGenerator(FGeneratorWrapper &GeneratorWrapper, FName SpawnedActorsPathOverride, bool bIsUserInitiated)
+{
+	TSoftObjectPtr<AActor> Generator = GeneratorWrapper.Generator;
+	if (!Generator.IsValid()) return false;
+
+	const FString GeneratorName = Generator->GetActorNameOrLabel();
+	TWeakObjectPtr<ALandscapeCombination> WeakThis(this);
+
+	double StartTime = FPlatformTime::Seconds();
+	UE_LOG(LogLandscapeCombinator, Log, TEXT("Starting Generation with %s"), *GeneratorName);
+
+	FName Path = SpawnedActorsPathOverride.IsNone() ? FName() : FName(SpawnedActorsPathOverride.ToString() / GeneratorName);
+
+	// the generator runs on the current thread, and its game thread work is serialized with the one of the other generators
+	bool bGeneratorSuccess = Cast<ILCGenerator>(Generator.Get())->Generate(Path, bIsUserInitiated);
+	GeneratorWrapper.GeneratorStatus = bGeneratorSuccess ? EGeneratorStatus::Success : EGeneratorStatus::Error;
+
+#if WITH_EDITOR
+	Concurrency::RunOnGameThreadAndWait([WeakThis](){
+		if (!GEditor || !WeakThis.IsValid()) return true;
+		if (USelection* Selection = GEditor->GetSelectedActors())
+		{
+			Selection->DeselectAll();
+			Selection->Select(WeakThis.Get());
+		}
+		return true;
+	});
+#endif
+
+	if (!bGeneratorSuccess) return false;
+
+	double Time = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogLandscapeCombinator, Log, TEXT("Generation with %s took %f seconds"), *GeneratorName, Time);
+
+	FScopeLock Lock(&TimeSpentLock);
+	if (!TimeSpent.Contains(Generator.Get())) TimeSpent.Add(Generator.Get(), Time);
+	else TimeSpent[Generator.Get()] += Time;
+
+	return true;
+}
+
 bool ALandscapeCombination::OnGenerate(FName SpawnedActorsPathOverride, bool bIsUserInitiated)
 {
 	UE_LOG(LogLandscapeCombinator, Log, TEXT("Starting Combination with %d Generators"), Generators.Num());
 
 	Modify();
-	TWeakObjectPtr<ALandscapeCombination> WeakThis(this);
 
 	for (auto &GeneratorWrapper: Generators)
 		GeneratorWrapper.GeneratorStatus = EGeneratorStatus::Idle;
 
-	for (auto &GeneratorWrapper: Generators)
+	TArray<int32> Enabled;
+	for (int32 i = 0; i < Generators.Num(); i++)
 	{
+		FGeneratorWrapper &GeneratorWrapper = Generators[i];
 		TSoftObjectPtr<AActor> Generator = GeneratorWrapper.Generator;
 		if (!Generator.IsValid())
 		{
@@ -33,83 +96,149 @@ bool ALandscapeCombination::OnGenerate(FName SpawnedActorsPathOverride, bool bIs
 			return false;
 		}
 
-		const FString GeneratorName = Generator->GetActorNameOrLabel();
-
 		if (!GeneratorWrapper.bIsEnabled) continue;
 
-		GeneratorWrapper.GeneratorStatus = EGeneratorStatus::Generating;
-
-#if WITH_EDITOR
-		Concurrency::RunOnGameThreadAndWait([]() {
-			FPropertyEditorModule& PropertyModule = FModuleManager::LoadModuleChecked<FPropertyEditorModule>("PropertyEditor");
-			PropertyModule.NotifyCustomizationModuleChanged();
-			return true;
-		});
-#endif
-		
-		if (!Generator.IsValid() || !Generator->Implements<ULCGenerator>())
+		if (!Generator->Implements<ULCGenerator>())
 		{
 			LCReporter::ShowError(
 				FText::Format(
 					LOCTEXT("NonGeneratorActor", "Non-generator actor in combination: {0}"),
-					FText::FromString(GeneratorName)
+					FText::FromString(Generator->GetActorNameOrLabel())
 				)
 			);
 			GeneratorWrapper.GeneratorStatus = EGeneratorStatus::Error;
 			return false;
 		}
 
-		double StartTime = FPlatformTime::Seconds();
-		UE_LOG(LogLandscapeCombinator, Log, TEXT("Starting Generation with %s"), *GeneratorName);
-
-		FName Path = SpawnedActorsPathOverride.IsNone() ? FName() : FName(SpawnedActorsPathOverride.ToString() / GeneratorName);
+		Enabled.Add(i);
+	}
 
-		bool bGeneratorSuccess = Cast<ILCGenerator>(Generator.Get())->Generate(Path, bIsUserInitiated);
-		GeneratorWrapper.GeneratorStatus = bGeneratorSuccess ? EGeneratorStatus::Success : EGeneratorStatus::Error;
+	/* Dependency graph of the enabled generators, the order of the list is a valid order of execution */
+	const int32 NumEnabled = Enabled.Num();
+	TArray<int32> NumDependencies;
+	TArray<TArray<int32>> Dependents;
+	NumDependencies.SetNumZeroed(NumEnabled);
+	Dependents.SetNum(NumEnabled);
 
-#if WITH_EDITOR
-		Concurrency::RunOnGameThreadAndWait([WeakThis](){
-			if (!GEditor || !WeakThis.IsValid()) return true;
-			if (USelection* Selection = GEditor->GetSelectedActors())
+	for (int32 J = 0; J < NumEnabled; J++)
+	{
+		FString DependenciesString;
+		for (int32 I = 0; I < J; I++)
+		{
+			if (DependsOn(Generators[Enabled[J]], Generators[Enabled[I]]))
 			{
-				Selection->DeselectAll();
-				Selection->Select(WeakThis.Get());
+				NumDependencies[J]++;
+				Dependents[I].Add(J);
+				DependenciesString += " " + Generators[Enabled[I]].Generator->GetActorNameOrLabel();
 			}
-			return true;
-		});
-#endif
+		}
+
+		UE_LOG(LogLandscapeCombinator, Log, TEXT("Generator %s waits for:%s"),
+			*Generators[Enabled[J]].Generator->GetActorNameOrLabel(),
+			DependenciesString.IsEmpty() ? TEXT(" nothing") : *DependenciesString
+		);
+	}
+
+	FEvent* GeneratorFinished = FPlatformProcess::GetSynchEventFromPool(false);
+	if (!GeneratorFinished)
+	{
+		LCReporter::ShowError(LOCTEXT("NoSyncEvent", "Failed to create sync event for the combination."));
+		return false;
+	}
+
+	FCriticalSection GraphLock;
+	TArray<int32> Ready;
+	int32 NumRunning = 0;
+	bool bFailed = false;
+
+	for (int32 J = 0; J < NumEnabled; J++)
+	{
+		if (NumDependencies[J] == 0) Ready.Add(J);
+	}
+
+	// each ready generator runs on its own thread, as generators spend most of their time waiting
+	// for downloads, GDAL or the game thread, and must not hold workers of the executor
+	while (true)
+	{
+		TArray<int32> ToStart;
+		{
+			FScopeLock Lock(&GraphLock);
+			if (!bFailed) ToStart = MoveTemp(Ready);
+			Ready.Empty();
+			NumRunning += ToStart.Num();
+			if (NumRunning == 0) break;
+		}
 
-		if (!bGeneratorSuccess) return false;
+		for (int32 J : ToStart)
+		{
+			Generators[Enabled[J]].GeneratorStatus = EGeneratorStatus::Generating;
+		}
 
 #if WITH_EDITOR
-		if (bSaveAfterEachGenerator)
-		{
-			UE_LOG(LogLandscapeCombinator, Log, TEXT("Saving Level"));
-			if (!Concurrency::RunOnGameThreadAndWait([bIsUserInitiated](){
-				const bool bPromptUserToSave = bIsUserInitiated;
-				const bool bSaveMapPackages = true;
-				const bool bSaveContentPackages = true;
-				const bool bFastSave = false;
-				const bool bNotifyNoPackagesSaved = false;
-				const bool bCanBeDeclined = false;
-				return FEditorFileUtils::SaveDirtyPackages( bPromptUserToSave, bSaveMapPackages, bSaveContentPackages, bFastSave, bNotifyNoPackagesSaved, bCanBeDeclined );
-			}))
-			{
-				GeneratorWrapper.GeneratorStatus = EGeneratorStatus::Error;
-				return false;
-			}
+		if (!ToStart.IsEmpty())
+		{
+			Concurrency::RunOnGameThreadAndWait([]() {
+				FPropertyEditorModule& PropertyModule = FModuleManager::LoadModuleChecked<FPropertyEditorModule>("PropertyEditor");
+				PropertyModule.NotifyCustomizationModuleChanged();
+				return true;
+			});
 		}
 #endif
-		double Time = FPlatformTime::Seconds() - StartTime;
 
-		if (!TimeSpent.Contains(Generator.Get())) TimeSpent.Add(Generator.Get(), Time);
-		else TimeSpent[Generator.Get()] += Time;
+		for (int32 J : ToStart)
+		{
+			Async(EAsyncExecution::Thread, [&, J, SpawnedActorsPathOverride, bIsUserInitiated]() {
+				const bool bSuccess = RunGenerator(Generators[Enabled[J]], SpawnedActorsPathOverride, bIsUserInitiated);
+
+				// the event is triggered under the lock, so that the combination cannot return before it is triggered
+				FScopeLock Lock(&GraphLock);
+				NumRunning--;
+				if (!bSuccess) bFailed = true;
+				else
+				{
+					for (int32 K : Dependents[J])
+					{
+						if (--NumDependencies[K] == 0) Ready.Add(K);
+					}
+				}
+				GeneratorFinished->Trigger();
+			});
+		}
+
+		GeneratorFinished->Wait();
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(GeneratorFinished);
+
+	if (bFailed) return false;
+
+#if WITH_EDITOR
+	// saving after each generator would stall the other running generators, so the level is saved once at the end
+	if (bSaveAfterGeneration)
+	{
+		UE_LOG(LogLandscapeCombinator, Log, TEXT("Saving Level"));
+		if (!Concurrency::RunOnGameThreadAndWait([bIsUserInitiated](){
+			const bool bPromptUserToSave = bIsUserInitiated;
+			const bool bSaveMapPackages = true;
+			const bool bSaveContentPackages = true;
+			const bool bFastSave = false;
+			const bool bNotifyNoPackagesSaved = false;
+			const bool bCanBeDeclined = false;
+			return FEditorFileUtils::SaveDirtyPackages( bPromptUserToSave, bSaveMapPackages, bSaveContentPackages, bFastSave, bNotifyNoPackagesSaved, bCanBeDeclined );
+		}))
+		{
+			return false;
+		}
 	}
+#endif
 
 	TArray<TPair<AActor*, double>> Times;
-	for (auto &Time : TimeSpent)
 	{
-		Times.Add(TPair<AActor*, double>(Time.Key, Time.Value));
+		FScopeLock Lock(&TimeSpentLock);
+		for (auto &Time : TimeSpent)
+		{
+			Times.Add(TPair<AActor*, double>(Time.Key, Time.Value));
+		}
 	}
 	Times.Sort([](const TPair<AActor*, double> &A, const TPair<AActor*, double> &B) { return A.Value < B.Value; });
 
@@ -144,13 +273,8 @@ bool ALandscapeCombination::Cleanup_Implementation(bool bSkipPrompt)
 			}
 		}
 
-		FString ObjectsString;
-		for (UObject* Object : ObjectsToDelete)
-		{
-			if (IsValid(Object)) ObjectsString += Object->GetName() + "\n";
-		}
-
-		if (!ObjectsString.Replace(TEXT("\n"), TEXT("")).Replace(TEXT("  "), TEXT("")).IsEmpty())
+		FString ObjectsString = ULCBlueprintLibrary::DescribeObjects(ObjectsToDelete);
+		if (!ObjectsString.IsEmpty())
 		{
 			if (!LCReporter::ShowMessage(
 				FText::Format(
@@ -206,6 +330,8 @@ AActor* ALandscapeCombination::Duplicate(FName FromName, FName ToName)
 				DuplicatedGenerator->SetFolderPath(ToName);
 				NewGeneratorWrapper.bIsEnabled = GeneratorWrapper.bIsEnabled;
 				NewGeneratorWrapper.Generator = DuplicatedGenerator;
+				NewGeneratorWrapper.Inputs = GeneratorWrapper.Inputs;
+				NewGeneratorWrapper.Outputs = GeneratorWrapper.Outputs;
 				NewCombination->Generators.Add(NewGeneratorWrapper);
 			}
 			else
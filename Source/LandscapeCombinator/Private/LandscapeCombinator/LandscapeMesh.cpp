@@ -2,6 +2,7 @@
 
 #include "LandscapeCombinator/LandscapeMesh.h"
 #include "LandscapeCombinator/LandscapeMeshSpawner.h"
+#include "LandscapeCombinator/LogLandscapeCombinator.h"
 #include "GDALInterface/GDALInterface.h"
 #include "ConcurrencyHelpers/Concurrency.h"
 #include "ConcurrencyHelpers/LCReporter.h"
@@ -11,24 +12,177 @@
 #include "GeometryScript/MeshNormalsFunctions.h"
 #include "GeometryScript/MeshUVFunctions.h"
 #include "DynamicMesh/MeshNormals.h"
-#include "Math/ConvexHull2d.h"
 #include "Kismet/GameplayStatics.h"
+#include "Async/ParallelFor.h"
 
 using namespace UE::Geometry;
 
 #define LOCTEXT_NAMESPACE "FLandscapeCombinatorModule"
 
-void FHeightmap::UpdateBoundary()
+void FHeightmap::UpdateBounds()
 {
-	TArray<FVector2D> Points2D;
-	TArray<int32> OutIndices;
+	Bounds = FBox2D(ForceInit);
+	if (Width <= 0 || Height <= 0) return;
 
-	for (const FVector& Point : Points) Points2D.Add(FVector2D(Point.X, Point.Y));
+	Bounds += Origin;
+	Bounds += Origin + FVector2D((Width - 1) * Step.X, (Height - 1) * Step.Y);
+}
+
+bool FHeightmap::CoversLocation(const FVector2D &Location) const
+{
+	if (Width < 2 || Height < 2 || Step.X == 0 || Step.Y == 0) return false;
+
+	const int32 i = FMath::FloorToInt32((Location.X - Origin.X) / Step.X);
+	const int32 j = FMath::FloorToInt32((Location.Y - Origin.Y) / Step.Y);
+	if (i < 0 || j < 0 || i >= Width - 1 || j >= Height - 1) return false;
+
+	return FullCells[j * (Width - 1) + i];
+}
+
+namespace
+{
+	struct FHeightmapRef
+	{
+		int Priority;
+		FHeightmap *Heightmap;
+
+		/* Whether the points of this heightmap replace the ones of Other */
+		bool HasPrecedenceOver(const FHeightmapRef &Other) const
+		{
+			return Priority > Other.Priority || (Priority == Other.Priority && Heightmap->Order > Other.Heightmap->Order);
+		}
+	};
 
-	ConvexHull2D::ComputeConvexHull(Points2D, OutIndices);
+	/* Uniform grid over the bounds of the heightmaps, to find the heightmaps around a location without testing all of them */
+	class FHeightmapsIndex
+	{
+	public:
+		FHeightmapsIndex(const TArray<FHeightmapRef> &Refs0) : Refs(Refs0)
+		{
+			for (const FHeightmapRef &Ref : Refs)
+			{
+				CellSize = FMath::Max(CellSize, Ref.Heightmap->Bounds.GetSize().GetMax());
+			}
+
+			for (int32 k = 0; k < Refs.Num(); k++)
+			{
+				ForEachCell(Refs[k].Heightmap->Bounds, [this, k](const FIntPoint &Cell) { Cells.FindOrAdd(Cell).Add(k); });
+			}
+		}
+
+		/* Indices in Refs of the heightmaps whose bounds intersect Box */
+		TArray<int32> Query(const FBox2D &Box) const
+		{
+			TArray<int32> Result;
+			ForEachCell(Box, [this, &Box, &Result](const FIntPoint &Cell)
+			{
+				if (const TArray<int32> *Indices = Cells.Find(Cell))
+				{
+					for (int32 k : *Indices)
+					{
+						if (Refs[k].Heightmap->Bounds.Intersect(Box)) Result.AddUnique(k);
+					}
+				}
+			});
+			return Result;
+		}
+
+	private:
+		template<typename F>
+		void ForEachCell(const FBox2D &Box, F Fn) const
+		{
+			const int32 MinX = FMath::FloorToInt32(Box.Min.X / CellSize);
+			const int32 MinY = FMath::FloorToInt32(Box.Min.Y / CellSize);
+			const int32 MaxX = FMath::FloorToInt32(Box.Max.X / CellSize);
+			const int32 MaxY = FMath::FloorToInt32(Box.Max.Y / CellSize);
+			for (int32 Y = MinY; Y <= MaxY; Y++)
+				for (int32 X = MinX; X <= MaxX; X++)
+					Fn(FIntPoint(X, Y));
+		}
+
+		const TArray<FHeightmapRef> &Refs;
+		double CellSize = 1;
+		TMap<FIntPoint, TArray<int32>> Cells;
+	};
 
-	Boundary.SetVertices(TArray<FVector2D>());
-	for (int32 Index : OutIndices) Boundary.AppendVertex(Points2D[Index]);
+	/* Range of grid indices whose coordinate Origin + Index * Step is in [Min, Max] */
+	void GetIndexRange(double Origin, double Step, int32 Size, double Min, double Max, int32 &OutFirst, int32 &OutLast)
+	{
+		const double T1 = (Min - Origin) / Step;
+		const double T2 = (Max - Origin) / Step;
+		OutFirst = FMath::Max(0, FMath::CeilToInt32(FMath::Min(T1, T2)));
+		OutLast = FMath::Min(Size - 1, FMath::FloorToInt32(FMath::Max(T1, T2)));
+	}
+
+	void TriangulatePatch(const FHeightmapRef &Ref, const FHeightmapsIndex &Index, const TArray<FHeightmapRef> &Refs)
+	{
+		FHeightmap &Heightmap = *Ref.Heightmap;
+		const int32 Width = Heightmap.Width;
+		const int32 Height = Heightmap.Height;
+
+		// remove the points covered by heightmaps with precedence over this one
+		Heightmap.KeptPoints.Init(true, Width * Height);
+		for (int32 k : Index.Query(Heightmap.Bounds))
+		{
+			if (!Refs[k].HasPrecedenceOver(Ref)) continue;
+
+			const FBox2D &OtherBounds = Refs[k].Heightmap->Bounds;
+			int32 FirstI, LastI, FirstJ, LastJ;
+			GetIndexRange(Heightmap.Origin.X, Heightmap.Step.X, Width, OtherBounds.Min.X, OtherBounds.Max.X, FirstI, LastI);
+			GetIndexRange(Heightmap.Origin.Y, Heightmap.Step.Y, Height, OtherBounds.Min.Y, OtherBounds.Max.Y, FirstJ, LastJ);
+
+			for (int32 j = FirstJ; j <= LastJ; j++)
+				for (int32 i = FirstI; i <= LastI; i++)
+					Heightmap.KeptPoints[j * Width + i] = false;
+		}
+
+		// two triangles per cell whose four corners are kept
+		Heightmap.Triangles.Empty();
+		Heightmap.FullCells.Init(false, FMath::Max(0, (Width - 1) * (Height - 1)));
+		for (int32 j = 0; j < Height - 1; j++)
+		{
+			for (int32 i = 0; i < Width - 1; i++)
+			{
+				const int32 P00 = j * Width + i;
+				const int32 P10 = P00 + 1;
+				const int32 P01 = P00 + Width;
+				const int32 P11 = P01 + 1;
+				if (!Heightmap.KeptPoints[P00] || !Heightmap.KeptPoints[P10] || !Heightmap.KeptPoints[P01] || !Heightmap.KeptPoints[P11]) continue;
+
+				Heightmap.FullCells[j * (Width - 1) + i] = true;
+				Heightmap.Triangles.Add(FIntVector(P00, P10, P11));
+				Heightmap.Triangles.Add(FIntVector(P00, P11, P01));
+			}
+		}
+
+		// kept points which are not surrounded by full cells are stitched to the neighbouring patches
+		auto IsFullCell = [&Heightmap, Width, Height](int32 i, int32 j)
+		{
+			return i >= 0 && j >= 0 && i < Width - 1 && j < Height - 1 && Heightmap.FullCells[j * (Width - 1) + i];
+		};
+
+		Heightmap.FrontierPoints.Empty();
+		for (int32 j = 0; j < Height; j++)
+		{
+			for (int32 i = 0; i < Width; i++)
+			{
+				if (!Heightmap.KeptPoints[j * Width + i]) continue;
+				if (IsFullCell(i - 1, j - 1) && IsFullCell(i, j - 1) && IsFullCell(i - 1, j) && IsFullCell(i, j)) continue;
+
+				Heightmap.FrontierPoints.Add(j * Width + i);
+			}
+		}
+
+		Heightmap.bDirty = false;
+	}
+
+	/* Triangles are oriented counter-clockwise when seen from above */
+	void AppendOrientedTriangle(FDynamicMesh3 &Mesh, const TArray<FVector2D> &Locations, int A, int B, int C)
+	{
+		const double Cross = FVector2D::CrossProduct(Locations[B] - Locations[A], Locations[C] - Locations[A]);
+		if (Cross > 0) Mesh.AppendTriangle(A, B, C);
+		else if (Cross < 0) Mesh.AppendTriangle(A, C, B);
+	}
 }
 
 ALandscapeMesh::ALandscapeMesh()
@@ -44,6 +198,7 @@ ALandscapeMesh::ALandscapeMesh()
 void ALandscapeMesh::Clear()
 {
 	PriorityToHeightmaps.Empty();
+	NextHeightmapOrder = 0;
 	if (IsValid(MeshComponent) && IsValid(MeshComponent->GetDynamicMesh()))
 	{
 		MeshComponent->GetDynamicMesh()->GetMeshRef().Clear();
@@ -83,107 +238,169 @@ bool ALandscapeMesh::AddHeightmap(int Priority, FVector4d Coordinates, UGlobalCo
 		LCReporter::ShowError(LOCTEXT("HeightmapError", "Could not read heightmap from file: {0}"), FText::FromString(File));
 		return false;
 	}
-	for (int32 j = 0; j < Height; ++j)
+
+	// the conversion from the global CRS to Unreal coordinates is affine, so the pixels form a regular grid
+	FVector2D FirstPixel, SecondPixel;
+	GlobalCoordinates->GetUnrealCoordinatesFromCRS(LeftCoord + 0.5 * (RightCoord - LeftCoord) / Width, TopCoord - 0.5 * (TopCoord - BottomCoord) / Height, FirstPixel);
+	GlobalCoordinates->GetUnrealCoordinatesFromCRS(LeftCoord + 1.5 * (RightCoord - LeftCoord) / Width, TopCoord - 1.5 * (TopCoord - BottomCoord) / Height, SecondPixel);
+
+	Heightmap.Width = Width;
+	Heightmap.Height = Height;
+	Heightmap.Origin = FirstPixel;
+	Heightmap.Step = SecondPixel - FirstPixel;
+	Heightmap.Heights = MoveTemp(Data);
+	for (float &Z : Heightmap.Heights) Z *= 100;
+
+	Heightmap.Order = NextHeightmapOrder++;
+	Heightmap.UpdateBounds();
+
+	// the patches of the heightmaps covered by the new one must be triangulated again
+	for (auto &[OtherPriority, OtherHeightmaps] : PriorityToHeightmaps)
 	{
-		for (int32 i = 0; i < Width; ++i)
+		if (OtherPriority > Priority) continue;
+		for (FHeightmap &OtherHeightmap : OtherHeightmaps.Heightmaps)
 		{
-			double X = LeftCoord + (i + 0.5) * (RightCoord - LeftCoord) / Width;
-			double Y = TopCoord - (j + 0.5) * (TopCoord - BottomCoord) / Height;
-			FVector2D UnrealCoordinates;
-			GlobalCoordinates->GetUnrealCoordinatesFromCRS(X, Y, UnrealCoordinates);
-			float Z = Data[j * Width + i] * 100;
-			FVector Point(UnrealCoordinates.X, UnrealCoordinates.Y, Z);
-			Heightmap.Points.Add(Point);
+			if (OtherHeightmap.Bounds.Intersect(Heightmap.Bounds)) OtherHeightmap.bDirty = true;
 		}
 	}
-	Heightmap.UpdateBoundary();
+
 	FHeightmaps& Heightmaps = PriorityToHeightmaps.FindOrAdd(Priority);
-	Heightmaps.Heightmaps.Add(Heightmap);
+	Heightmaps.Heightmaps.Add(MoveTemp(Heightmap));
 	return true;
 }
 
 bool ALandscapeMesh::RegenerateMesh(double SplitNormalsAngle)
 {
-	TSet<FVector> Points;
-	TArray<int32> Priorities;
-	PriorityToHeightmaps.GetKeys(Priorities);
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("ALandscapeMesh::RegenerateMesh");
+
 	if (PriorityToHeightmaps.IsEmpty())
 	{
 		LCReporter::ShowError(LOCTEXT("NoHeightmaps", "There are no heightmaps in the Landscape Mesh, cannot generate"));
 		return false;
 	}
 
-	Priorities.Sort();
-	for (int32 Priority : Priorities)
+	TArray<FHeightmapRef> Refs;
+	for (auto &[Priority, Heightmaps] : PriorityToHeightmaps)
 	{
-		FHeightmaps& Heightmaps = PriorityToHeightmaps[Priority];
-		for (FHeightmap& Heightmap : Heightmaps.Heightmaps)
+		for (FHeightmap &Heightmap : Heightmaps.Heightmaps)
 		{
-			// Make a copy to avoid modifying Points while iterating on it
-			TSet<FVector> InitialPoints(Points);
-			for (FVector Point : InitialPoints)
-				if (Heightmap.Boundary.Contains({ Point.X, Point.Y })) Points.Remove(Point);
+			if (Heightmap.Width > 0 && Heightmap.Height > 0 && Heightmap.Heights.Num() == Heightmap.Width * Heightmap.Height)
+			{
+				Refs.Add({ Priority, &Heightmap });
+			}
 		}
-
-		for (FHeightmap& Heightmap : Heightmaps.Heightmaps)
-			for (FVector Point : Heightmap.Points)
-				Points.Add(Point);
 	}
 
-	if (Points.IsEmpty())
+	FHeightmapsIndex Index(Refs);
+
+	TArray<int32> DirtyRefs;
+	for (int32 k = 0; k < Refs.Num(); k++)
 	{
-		LCReporter::ShowError(LOCTEXT("NoPoint", "Trying to generate empty mesh, something went wrong in the Landscape Mesh Spawner"));
-		return false;
+		if (Refs[k].Heightmap->bDirty) DirtyRefs.Add(k);
 	}
-	
-	FDelaunay2 Delaunay;
-	Delaunay.bAutomaticallyFixEdgesToDuplicateVertices = true;
-	
-	TArray<FVector> PointsArray = Points.Array();
-	TArray<TVector2<double>> Points2D;
-	TArray<FIndex2i> Edges;
 
-	for (const FVector& Point : PointsArray)
+	UE_LOG(LogLandscapeCombinator, Log, TEXT("Triangulating %d patches out of %d"), DirtyRefs.Num(), Refs.Num());
+
+	ParallelFor(DirtyRefs.Num(), [&](int32 d)
 	{
-		Points2D.Add({ Point[0], Point[1]});
-	}
+		TriangulatePatch(Refs[DirtyRefs[d]], Index, Refs);
+	});
 
-	if (!Delaunay.Triangulate(Points2D, Edges))
+	if (!IsValid(MeshComponent) || !IsValid(MeshComponent->GetDynamicMesh()))
 	{
-		LCReporter::ShowError(LOCTEXT("DelaunayError", "Delaunay triangulation failed"));
+		LCReporter::ShowError(LOCTEXT("MeshComponentError", "Dynamic mesh is not valid"));
 		return false;
 	}
 
-	if (!IsValid(MeshComponent) || !IsValid(MeshComponent->GetDynamicMesh()))
+	/* Assemble the patches */
+
+	FDynamicMesh3 NewMesh;
+	FTransform WorldToMesh = MeshComponent->GetComponentTransform().Inverse();
+	TArray<FVector2D> VertexLocations;
+	TArray<TVector2<double>> FrontierLocations;
+	TArray<int32> FrontierVertices;
+
+	for (const FHeightmapRef &Ref : Refs)
 	{
-		LCReporter::ShowError(LOCTEXT("MeshComponentError", "Dynamic mesh is not valid"));
+		const FHeightmap &Heightmap = *Ref.Heightmap;
+		TArray<int32> GridToVertex;
+		GridToVertex.Init(INDEX_NONE, Heightmap.Width * Heightmap.Height);
+
+		for (TConstSetBitIterator<> It(Heightmap.KeptPoints); It; ++It)
+		{
+			const FVector Point = Heightmap.GetPoint(It.GetIndex());
+			GridToVertex[It.GetIndex()] = NewMesh.AppendVertex(WorldToMesh.TransformPosition(Point));
+			VertexLocations.Add(FVector2D(Point.X, Point.Y));
+		}
+
+		for (const FIntVector &Triangle : Heightmap.Triangles)
+		{
+			AppendOrientedTriangle(NewMesh, VertexLocations, GridToVertex[Triangle.X], GridToVertex[Triangle.Y], GridToVertex[Triangle.Z]);
+		}
+
+		for (int32 GridIndex : Heightmap.FrontierPoints)
+		{
+			const int32 Vertex = GridToVertex[GridIndex];
+			FrontierVertices.Add(Vertex);
+			FrontierLocations.Add(VertexLocations[Vertex]);
+		}
+	}
+
+	if (NewMesh.VertexCount() == 0)
+	{
+		LCReporter::ShowError(LOCTEXT("NoPoint", "Trying to generate empty mesh, something went wrong in the Landscape Mesh Spawner"));
 		return false;
 	}
 
-	// Validate the triangles
-	for (auto &Triangle : Delaunay.GetTriangles())
+	/* Stitch the patches by triangulating the points on their borders, skipping the triangles that are inside a patch */
+
+	if (FrontierLocations.Num() >= 3)
 	{
-		if (
-			Triangle.A < 0 || Triangle.B < 0 || Triangle.C < 0 ||
-			Triangle.A >= PointsArray.Num() || Triangle.B >= PointsArray.Num() || Triangle.C >= PointsArray.Num())
-		{
-			LCReporter::ShowError(
-				FText::Format(
-					LOCTEXT("InvalidTriangleError", "Delaunay returned an invalid triangle {0} {1} {2} ({3} vertices)"),
-					FText::AsNumber(Triangle.A),
-					FText::AsNumber(Triangle.B),
-					FText::AsNumber(Triangle.C),
-					FText::AsNumber(PointsArray.Num())
-				)
-			);
+		TRACE_CPUPROFILER_EVENT_SCOPE_STR("ALandscapeMesh::RegenerateMesh/Stitch");
+
+		FDelaunay2 Delaunay;
+		Delaunay.bAutomaticallyFixEdgesToDuplicateVertices = true;
+		TArray<FIndex2i> Edges;
+
+		if (!Delaunay.Triangulate(FrontierLocations, Edges))
+		{
+			LCReporter::ShowError(LOCTEXT("DelaunayError", "Delaunay triangulation failed"));
 			return false;
 		}
-	}
 
-	FDynamicMesh3 NewMesh;
-	FTransform WorldToMesh = MeshComponent->GetComponentTransform().Inverse();
-	for (auto &Point : Points) NewMesh.AppendVertex(WorldToMesh.TransformPosition(Point));
-	for (auto &Triangle : Delaunay.GetTriangles()) NewMesh.AppendTriangle(Triangle.A, Triangle.C, Triangle.B);
+		for (auto &Triangle : Delaunay.GetTriangles())
+		{
+			if (
+				Triangle.A < 0 || Triangle.B < 0 || Triangle.C < 0 ||
+				Triangle.A >= FrontierLocations.Num() || Triangle.B >= FrontierLocations.Num() || Triangle.C >= FrontierLocations.Num())
+			{
+				LCReporter::ShowError(
+					FText::Format(
+						LOCTEXT("InvalidTriangleError", "Delaunay returned an invalid triangle {0} {1} {2} ({3} vertices)"),
+						FText::AsNumber(Triangle.A),
+						FText::AsNumber(Triangle.B),
+						FText::AsNumber(Triangle.C),
+						FText::AsNumber(FrontierLocations.Num())
+					)
+				);
+				return false;
+			}
+
+			const FVector2D Centroid = (FrontierLocations[Triangle.A] + FrontierLocations[Triangle.B] + FrontierLocations[Triangle.C]) / 3;
+			bool bInsidePatch = false;
+			for (int32 k : Index.Query(FBox2D(Centroid, Centroid)))
+			{
+				if (Refs[k].Heightmap->CoversLocation(Centroid))
+				{
+					bInsidePatch = true;
+					break;
+				}
+			}
+			if (bInsidePatch) continue;
+
+			AppendOrientedTriangle(NewMesh, VertexLocations, FrontierVertices[Triangle.A], FrontierVertices[Triangle.B], FrontierVertices[Triangle.C]);
+		}
+	}
 
 	Concurrency::RunOnGameThreadAndWait([this, &NewMesh]() {;
 		FDynamicMesh3 &TargetMesh = MeshComponent->GetDynamicMesh()->GetMeshRef();
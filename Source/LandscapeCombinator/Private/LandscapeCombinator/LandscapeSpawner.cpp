@@ -99,6 +99,48 @@ bool GetPixels(FIntPoint& InsidePixels, TArray<FString> Files)
 	return true;
 }
 
+/* Reads the heightmaps (tiles of the form Filename_x0_y0 when there are several) in memory, with altitudes
+ * scaled to the uint16 range, and assembles them in a single heightmap */
+bool ReadHeightmapTiles(TArray<FString> Files, FVector2D Altitudes, TArray<uint16> &OutData, int &OutWidth, int &OutHeight)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("LandscapeSpawner::ReadHeightmapTiles");
+
+	// same margins as the PNG conversion of the heightmap downloader
+	const double MinAltitude = Altitudes[0] - 100;
+	const double MaxAltitude = Altitudes[1] + 100;
+
+	TFunction<bool(FString, FLandscapeImportTile&)> ReadTile = [&](FString File, FLandscapeImportTile &OutTile)
+	{
+		OutTile.Tile = FIntPoint(0, 0);
+		if (Files.Num() > 1 && !TilesCounter::TryTileOf(File, OutTile.Tile))
+		{
+			LCReporter::ShowError(FText::Format(
+				LOCTEXT("ReadHeightmapTiles::TileName", "Heightmap '{0}' is not named like Filename_x0_y0, so its position among the other heightmaps is unknown."),
+				FText::FromString(File)
+			));
+			return false;
+		}
+
+		return GDALInterface::ReadHeightmapFromFile(File, MinAltitude, MaxAltitude, OutTile.Width, OutTile.Height, OutTile.Data);
+	};
+
+	TArray<FLandscapeImportTile> Tiles;
+	if (IsInGameThread())
+	{
+		Tiles.SetNum(Files.Num());
+		for (int32 i = 0; i < Files.Num(); i++)
+		{
+			if (!ReadTile(Files[i], Tiles[i])) return false;
+		}
+	}
+	else if (!Concurrency::RunArrayAndWait<FString, FLandscapeImportTile>(Files, Tiles, ReadTile, EConcurrencyResource::DiskIO))
+	{
+		return false;
+	}
+
+	return LandscapeUtils::BuildTiledLayout(Tiles, OutData, OutWidth, OutHeight);
+}
+
 void ALandscapeSpawner::DeleteLandscape()
 {
 	Execute_Cleanup(this, false);
@@ -239,9 +281,9 @@ bool ALandscapeSpawner::SpawnLandscape(FName SpawnedActorsPathOverride, bool bIs
 		Name,
 		true,
 		true,
-		SpawnMethod == ESpawnMethod::CreateFreshLandscape, // convert to PNG only for non-extension
+		false, // fresh landscapes are imported from memory, and the other spawn methods don't need PNG files
 		SpawnMethod == ESpawnMethod::CreateFreshLandscapeIncrementally, // convert only first file to PNG for incremental spawning
-		SpawnMethod == ESpawnMethod::CreateFreshLandscape, // add missing tiles only for non-incremental mode
+		false, // missing tiles are filled with zeros when building the in-memory heightmap
 		[Altitudes, Coordinates, CRS, this](HMFetcher *FetcherBeforePNG)
 		{
 			*CRS = FetcherBeforePNG->OutputCRS;
@@ -303,6 +345,14 @@ bool ALandscapeSpawner::SpawnLandscape(FName SpawnedActorsPathOverride, bool bIs
 		return false;
 	}
 
+	// the heightmaps of fresh landscapes are read in memory directly, instead of going through 16-bit PNG files
+	TArray<uint16> HeightmapData;
+	int HeightmapWidth = 0, HeightmapHeight = 0;
+	if (SpawnMethod == ESpawnMethod::CreateFreshLandscape && !ReadHeightmapTiles(Files, *Altitudes, HeightmapData, HeightmapWidth, HeightmapHeight))
+	{
+		return false;
+	}
+
 	if (SpawnMethod == ESpawnMethod::CreateFreshLandscape || SpawnMethod == ESpawnMethod::CreateFreshLandscapeIncrementally)
 	{
 		if (!Concurrency::RunOnGameThreadAndWait([&]() {
@@ -349,14 +399,29 @@ bool ALandscapeSpawner::SpawnLandscape(FName SpawnedActorsPathOverride, bool bIs
 				Files2 = Files;
 			}
 
-			bool bSpawnLandscapeSuccess = LandscapeUtils::SpawnLandscape(
-				SpawnMethod == ESpawnMethod::CreateFreshLandscapeIncrementally,
-				Files2, LandscapeLabel, bCreateLandscapeStreamingProxies,
-				ComponentsMethod == EComponentsMethod::Auto || ComponentsMethod == EComponentsMethod::AutoWithoutBorder,
-				ComponentsMethod == EComponentsMethod::AutoWithoutBorder && SpawnMethod == ESpawnMethod::CreateFreshLandscape,
-				QuadsPerSubsection, SectionsPerComponent, ComponentCount,
-				OutLandscape, SpawnedLandscapeStreamingProxies
-			);
+			bool bSpawnLandscapeSuccess;
+			if (SpawnMethod == ESpawnMethod::CreateFreshLandscape)
+			{
+				bSpawnLandscapeSuccess = LandscapeUtils::SpawnLandscapeFromData(
+					HeightmapData, HeightmapWidth, HeightmapHeight, LandscapeLabel, bCreateLandscapeStreamingProxies,
+					ComponentsMethod == EComponentsMethod::Auto || ComponentsMethod == EComponentsMethod::AutoWithoutBorder,
+					ComponentsMethod == EComponentsMethod::AutoWithoutBorder,
+					QuadsPerSubsection, SectionsPerComponent, ComponentCount,
+					OutLandscape, SpawnedLandscapeStreamingProxies
+				);
+				HeightmapData.Empty();
+			}
+			else
+			{
+				bSpawnLandscapeSuccess = LandscapeUtils::SpawnLandscape(
+					true,
+					Files2, LandscapeLabel, bCreateLandscapeStreamingProxies,
+					ComponentsMethod == EComponentsMethod::Auto || ComponentsMethod == EComponentsMethod::AutoWithoutBorder,
+					false,
+					QuadsPerSubsection, SectionsPerComponent, ComponentCount,
+					OutLandscape, SpawnedLandscapeStreamingProxies
+				);
+			}
 
 			if (!bSpawnLandscapeSuccess || !IsValid(OutLandscape))
 			{
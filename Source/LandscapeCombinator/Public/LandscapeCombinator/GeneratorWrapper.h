@@ -32,6 +32,17 @@ struct FGeneratorWrapper
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GeneratorWrapper", meta = (DisplayPriority = "2"))
 	EGeneratorStatus GeneratorStatus = EGeneratorStatus::Idle;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GeneratorWrapper", meta = (DisplayPriority = "3"))
+	/* Names of the data read by the generator, for instance "Landscape:Alps" when it needs the heights of that landscape */
+	TArray<FName> Inputs;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GeneratorWrapper", meta = (DisplayPriority = "4"))
+	/* Names of the data created or modified by the generator, for instance "Landscape:Alps" for the spawner of that landscape.
+	 * Generators that declare neither inputs nor outputs wait for all the previous generators, and are waited for by the next ones. */
+	TArray<FName> Outputs;
+
+	bool DeclaresDependencies() const { return !Inputs.IsEmpty() || !Outputs.IsEmpty(); }
 };
 
 #if WITH_EDITOR
@@ -41,7 +52,7 @@ class FGeneratorWrapperCustomization : public IPropertyTypeCustomization
 public:
 	static TSharedRef<IPropertyTypeCustomization> MakeInstance();
 	virtual void CustomizeHeader(TSharedRef<IPropertyHandle> StructHandle, FDetailWidgetRow& Row, IPropertyTypeCustomizationUtils&);
-	virtual void CustomizeChildren(TSharedRef<IPropertyHandle>, IDetailChildrenBuilder&, IPropertyTypeCustomizationUtils&) override {}
+	virtual void CustomizeChildren(TSharedRef<IPropertyHandle> StructHandle, IDetailChildrenBuilder& ChildBuilder, IPropertyTypeCustomizationUtils&) override;
 };
 
 #endif
\ No newline at end of file
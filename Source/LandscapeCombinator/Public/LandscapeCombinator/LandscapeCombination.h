@@ -60,8 +60,8 @@ public:
 
 #if WITH_EDITORONLY_DATA
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "LandscapeCombination",meta = (DisplayPriority = "0"))
-	/* Save level when one generator finishes successfully */
-	bool bSaveAfterEachGenerator = false;
+	/* Save level once all generators finished successfully */
+	bool bSaveAfterGeneration = false;
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Duplication", meta = (DisplayPriority = "1"))
 	FName RenameLabelsAndTagsContaining = "OldCombination";
@@ -78,4 +78,8 @@ public:
 
 protected:
 	TMap<AActor*, double> TimeSpent;
+	FCriticalSection TimeSpentLock;
+
+private:
+	bool RunGenerator(FGeneratorWrapper &GeneratorWrapper, FName SpawnedActorsPathOverride, bool bIsUserInitiated);
 };
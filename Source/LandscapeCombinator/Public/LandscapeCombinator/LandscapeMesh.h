@@ -4,22 +4,58 @@
 
 #include "Coordinates/GlobalCoordinates.h"
 #include "Components/DynamicMeshComponent.h"
-#include "Polygon2.h"
 #include "LandscapeMesh.generated.h"
 
 using namespace UE::Geometry;
 
+/* A heightmap is stored as a regular grid of points, and is triangulated as its own patch of the landscape mesh.
+ * Points covered by heightmaps with a higher priority are removed from the patch. */
 USTRUCT(BlueprintType)
 struct FHeightmap
 {
 	GENERATED_BODY()
 
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FHeightmap")
-	TSet<FVector> Points;
+	int32 Width = 0;
 
-	TPolygon2<double> Boundary;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FHeightmap")
+	int32 Height = 0;
+
+	/* Heights in cm, row by row */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FHeightmap")
+	TArray<float> Heights;
+
+	/* Unreal location of the center of the first pixel */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FHeightmap")
+	FVector2D Origin = FVector2D::ZeroVector;
+
+	/* Unreal distance between the centers of two consecutive pixels, which can be negative */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FHeightmap")
+	FVector2D Step = FVector2D::ZeroVector;
+
+	/* Heightmaps added later have precedence over the ones with the same priority */
+	int32 Order = 0;
+
+	FBox2D Bounds = FBox2D(ForceInit);
+
+	/* The patch has to be triangulated again */
+	bool bDirty = true;
+
+	/* Cached patch, using the indices of the points in the grid */
+	TBitArray<> KeptPoints;
+	TBitArray<> FullCells;
+	TArray<FIntVector> Triangles;
+	TArray<int32> FrontierPoints;
+
+	void UpdateBounds();
+
+	FVector GetPoint(int32 Index) const
+	{
+		return FVector(Origin.X + (Index % Width) * Step.X, Origin.Y + (Index / Width) * Step.Y, Heights[Index]);
+	}
 
-	void UpdateBoundary();
+	/* Whether Location is inside a cell of the patch whose four corners are kept */
+	bool CoversLocation(const FVector2D &Location) const;
 };
 
 USTRUCT(BlueprintType)
@@ -50,7 +86,11 @@ public:
 
 	bool AddHeightmap(int Priority, FVector4d Coordinates, UGlobalCoordinates* GlobalCoordinates, FString File);
 
+	/* Only the patches of the heightmaps that were added or overlapped by a new heightmap are triangulated again,
+	 * then the patches are stitched together along their borders */
 	UFUNCTION(BlueprintCallable, Category = "LandscapeMesh")
 	bool RegenerateMesh(double SplitNormalsAngle);
 
+private:
+	int32 NextHeightmapOrder = 0;
 };
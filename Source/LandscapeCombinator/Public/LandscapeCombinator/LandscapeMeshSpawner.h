@@ -40,6 +40,11 @@ public:
 		}
 	}
 
+	virtual TFunction<bool(LCCancellationToken*)> MakePrefetchTask(const TArray<FTile> &Tiles) override
+	{
+		return IsValid(HeightmapDownloader) ? HeightmapDownloader->MakePrefetchTask(Tiles) : nullptr;
+	}
+
 	/********************
 	 * General Settings *
 	 ********************/
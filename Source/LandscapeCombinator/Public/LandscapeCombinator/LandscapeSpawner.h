@@ -94,6 +94,14 @@ public:
 		}
 	}
 
+	virtual TFunction<bool(LCCancellationToken*)> MakePrefetchTask(const TArray<FTile> &Tiles) override
+	{
+		return IsValid(HeightmapDownloader) ? HeightmapDownloader->MakePrefetchTask(Tiles) : nullptr;
+	}
+
+	// tiles extend the same landscape, which cannot be partially deleted
+	virtual bool CanUnloadTiles() const override { return false; }
+
 	virtual TArray<UObject*> GetGeneratedObjects() const override;
 
 	/********************
@@ -37,6 +37,11 @@ public:
 		}
 	}
 
+	virtual TFunction<bool(LCCancellationToken*)> MakePrefetchTask(const TArray<FTile> &Tiles) override
+	{
+		return IsValid(ImageDownloader) ? ImageDownloader->MakePrefetchTask(Tiles) : nullptr;
+	}
+
 	UPROPERTY(
 		EditAnywhere, BlueprintReadWrite, Category = "LandscapeTexturer",
 		meta = (DisplayPriority = "-1")
@@ -0,0 +1,173 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#include "LandscapeUtils/HeightSampler.h"
+#include "LandscapeUtils/LandscapeUtils.h"
+#include "LandscapeUtils/LogLandscapeUtils.h"
+#include "ConcurrencyHelpers/Concurrency.h"
+
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "LandscapeDataAccess.h"
+
+#if WITH_EDITOR
+#include "LandscapeEdit.h"
+#endif
+
+bool HeightSampler::UseLandscapeHeightmap(ALandscape *Landscape)
+{
+	check(IsInGameThread());
+
+	Heights.Empty();
+
+	if (bDrawDebugLines || !IsValid(Landscape)) return false;
+
+#if WITH_EDITOR
+	ULandscapeInfo *LandscapeInfo = Landscape->GetLandscapeInfo();
+	if (!LandscapeInfo) return false;
+
+	int32 MaxX, MaxY;
+	if (!LandscapeInfo->GetLandscapeExtent(MinX, MinY, MaxX, MaxY)) return false;
+
+	SizeX = MaxX - MinX + 1;
+	SizeY = MaxY - MinY + 1;
+	LandscapeTransform = Landscape->GetActorTransform();
+
+	Heights.SetNumUninitialized((int64) SizeX * SizeY);
+	FHeightmapAccessor<false> HeightmapAccessor(LandscapeInfo);
+	HeightmapAccessor.GetDataFast(MinX, MinY, MaxX, MaxY, Heights.GetData());
+
+	UE_LOG(LogLandscapeUtils, Log, TEXT("Sampling heights from the %dx%d heightmap of %s"), SizeX, SizeY, *Landscape->GetActorNameOrLabel());
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool HeightSampler::GetHeightmapZ(double X, double Y, double &OutZ) const
+{
+	const FVector QuadLocation = LandscapeTransform.InverseTransformPosition(FVector(X, Y, 0));
+	const double QX = QuadLocation.X - MinX;
+	const double QY = QuadLocation.Y - MinY;
+
+	if (QX < 0 || QY < 0 || QX > SizeX - 1 || QY > SizeY - 1) return false;
+
+	const int X0 = FMath::Min(FMath::FloorToInt(QX), SizeX - 1);
+	const int Y0 = FMath::Min(FMath::FloorToInt(QY), SizeY - 1);
+	const int X1 = FMath::Min(X0 + 1, SizeX - 1);
+	const int Y1 = FMath::Min(Y0 + 1, SizeY - 1);
+
+	const double Dx = QX - X0;
+	const double Dy = QY - Y0;
+
+	// Bilinear interpolation
+	const double H00 = LandscapeDataAccess::GetLocalHeight(Heights[(int64) Y0 * SizeX + X0]);
+	const double H10 = LandscapeDataAccess::GetLocalHeight(Heights[(int64) Y0 * SizeX + X1]);
+	const double H01 = LandscapeDataAccess::GetLocalHeight(Heights[(int64) Y1 * SizeX + X0]);
+	const double H11 = LandscapeDataAccess::GetLocalHeight(Heights[(int64) Y1 * SizeX + X1]);
+
+	const double LocalHeight =
+		(1 - Dx) * (1 - Dy) * H00 +
+		Dx       * (1 - Dy) * H10 +
+		(1 - Dx) * Dy       * H01 +
+		Dx       * Dy       * H11;
+
+	OutZ = LandscapeTransform.TransformPosition(FVector(QuadLocation.X, QuadLocation.Y, LocalHeight)).Z;
+	return true;
+}
+
+bool HeightSampler::GetHeightmapNormal(double X, double Y, FVector &OutNormal) const
+{
+	double Z;
+	if (!GetHeightmapZ(X, Y, Z)) return false;
+
+	// central differences with a step of one quad, or one-sided differences on the borders of the heightmap
+	const double StepX = FMath::Abs(LandscapeTransform.GetScale3D().X);
+	const double StepY = FMath::Abs(LandscapeTransform.GetScale3D().Y);
+
+	double X1 = X - StepX, X2 = X + StepX, Y1 = Y - StepY, Y2 = Y + StepY;
+	double ZX1, ZX2, ZY1, ZY2;
+	if (!GetHeightmapZ(X1, Y, ZX1)) { X1 = X; ZX1 = Z; }
+	if (!GetHeightmapZ(X2, Y, ZX2)) { X2 = X; ZX2 = Z; }
+	if (!GetHeightmapZ(X, Y1, ZY1)) { Y1 = Y; ZY1 = Z; }
+	if (!GetHeightmapZ(X, Y2, ZY2)) { Y2 = Y; ZY2 = Z; }
+
+	const double DzDx = X2 > X1 ? (ZX2 - ZX1) / (X2 - X1) : 0;
+	const double DzDy = Y2 > Y1 ? (ZY2 - ZY1) / (Y2 - Y1) : 0;
+
+	OutNormal = FVector(-DzDx, -DzDy, 1).GetSafeNormal();
+	return true;
+}
+
+bool HeightSampler::GetNormal(double X, double Y, FVector &OutNormal) const
+{
+	if (IsUsingHeightmap()) return GetHeightmapNormal(X, Y, OutNormal);
+	if (!IsValid(World)) return false;
+
+	FHitResult HitResult;
+	const bool bLineTrace = World->LineTraceSingleByChannel(
+		OUT HitResult,
+		FVector(X, Y, HALF_WORLD_MAX),
+		FVector(X, Y, -HALF_WORLD_MAX),
+		ECollisionChannel::ECC_Visibility,
+		CollisionQueryParams
+	);
+
+	if (!bLineTrace) return false;
+
+	OutNormal = HitResult.Normal;
+	return true;
+}
+
+bool HeightSampler::GetZ(double X, double Y, double &OutZ) const
+{
+	if (IsUsingHeightmap()) return GetHeightmapZ(X, Y, OutZ);
+	if (!IsValid(World)) return false;
+	return LandscapeUtils::GetZ(World, CollisionQueryParams, X, Y, OutZ, bDrawDebugLines);
+}
+
+void HeightSampler::GetZs(const TArray<FVector2D> &Locations, TArray<double> &OutZs, TArray<bool> &OutHits) const
+{
+	const int32 NumLocations = Locations.Num();
+	OutZs.SetNumZeroed(NumLocations);
+	OutHits.SetNumZeroed(NumLocations);
+
+	// debug lines can only be drawn from the game thread, so traces are run there sequentially in that case
+	if (bDrawDebugLines)
+	{
+		Concurrency::RunOnGameThreadAndWait([&]() -> bool
+		{
+			for (int32 i = 0; i < NumLocations; i++)
+			{
+				OutHits[i] = GetZ(Locations[i].X, Locations[i].Y, OutZs[i]);
+			}
+			return true;
+		});
+		return;
+	}
+
+	// heightmap samples are very cheap, so they are grouped in larger batches than line traces
+	const int32 MinBatchSize = IsUsingHeightmap() ? 1024 : 16;
+
+	ParallelFor(TEXT("HeightSampler::GetZs"), NumLocations, MinBatchSize, [&](int32 i)
+	{
+		double Z = 0;
+		OutHits[i] = GetZ(Locations[i].X, Locations[i].Y, Z);
+		OutZs[i] = Z;
+	});
+}
+
+void HeightSampler::GetNormals(const TArray<FVector2D> &Locations, TArray<FVector> &OutNormals, TArray<bool> &OutHits) const
+{
+	const int32 NumLocations = Locations.Num();
+	OutNormals.SetNumZeroed(NumLocations);
+	OutHits.SetNumZeroed(NumLocations);
+
+	const int32 MinBatchSize = IsUsingHeightmap() ? 1024 : 16;
+
+	ParallelFor(TEXT("HeightSampler::GetNormals"), NumLocations, MinBatchSize, [&](int32 i)
+	{
+		FVector Normal = FVector::ZeroVector;
+		OutHits[i] = GetNormal(Locations[i].X, Locations[i].Y, Normal);
+		OutNormals[i] = Normal;
+	});
+}
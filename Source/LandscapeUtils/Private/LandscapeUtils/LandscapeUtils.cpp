@@ -12,6 +12,7 @@
 #include "Kismet/GameplayStatics.h"
 #include "Misc/MessageDialog.h"
 #include "Misc/ScopedSlowTask.h"
+#include "Async/ParallelFor.h"
 #include "Misc/EngineVersionComparison.h"
 #include "Engine/World.h"
 #include "Framework/Docking/TabManager.h"
@@ -524,6 +525,98 @@ bool LandscapeUtils::GetActorCRSBounds(AActor* Actor, UGlobalCoordinates *Global
 	}
 }
 
+bool LandscapeUtils::BuildTiledLayout(TArray<FLandscapeImportTile> &Tiles, TArray<uint16> &OutData, int &OutWidth, int &OutHeight)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("LandscapeUtils::BuildTiledLayout");
+
+	if (Tiles.IsEmpty())
+	{
+		LCReporter::ShowError(LOCTEXT("LandscapeUtils::BuildTiledLayout", "Cannot build a heightmap without tiles."));
+		return false;
+	}
+
+	const int TileWidth = Tiles[0].Width;
+	const int TileHeight = Tiles[0].Height;
+	FIntPoint LastTile(0, 0);
+	TSet<FIntPoint> TileIndices;
+
+	for (const FLandscapeImportTile &Tile : Tiles)
+	{
+		if (Tile.Width != TileWidth || Tile.Height != TileHeight || Tile.Data.Num() != Tile.Width * Tile.Height || Tile.Tile.X < 0 || Tile.Tile.Y < 0)
+		{
+			LCReporter::ShowError(FText::Format(
+				LOCTEXT("LandscapeUtils::BuildTiledLayout::Size", "Heightmap tile ({0}, {1}) has size {2}x{3}, but all tiles must have size {4}x{5}."),
+				FText::AsNumber(Tile.Tile.X),
+				FText::AsNumber(Tile.Tile.Y),
+				FText::AsNumber(Tile.Width),
+				FText::AsNumber(Tile.Height),
+				FText::AsNumber(TileWidth),
+				FText::AsNumber(TileHeight)
+			));
+			return false;
+		}
+
+		bool bIsDuplicate = false;
+		TileIndices.Add(Tile.Tile, &bIsDuplicate);
+		if (bIsDuplicate)
+		{
+			LCReporter::ShowError(FText::Format(
+				LOCTEXT("LandscapeUtils::BuildTiledLayout::Duplicate", "There are several heightmap tiles at position ({0}, {1})."),
+				FText::AsNumber(Tile.Tile.X),
+				FText::AsNumber(Tile.Tile.Y)
+			));
+			return false;
+		}
+
+		LastTile.X = FMath::Max(LastTile.X, Tile.Tile.X);
+		LastTile.Y = FMath::Max(LastTile.Y, Tile.Tile.Y);
+	}
+
+	const int64 NumMissingTiles = (int64) (LastTile.X + 1) * (LastTile.Y + 1) - Tiles.Num();
+	if (NumMissingTiles > 0)
+	{
+		UE_LOG(LogLandscapeUtils, Warning,
+			TEXT("BuildTiledLayout: %lld heightmap tiles are missing in the %dx%d grid of tiles, they are filled with zeros"),
+			NumMissingTiles, LastTile.X + 1, LastTile.Y + 1
+		);
+	}
+
+	if (Tiles.Num() == 1 && LastTile == FIntPoint(0, 0))
+	{
+		OutWidth = TileWidth;
+		OutHeight = TileHeight;
+		OutData = MoveTemp(Tiles[0].Data);
+		return true;
+	}
+
+	OutWidth = (LastTile.X + 1) * TileWidth;
+	OutHeight = (LastTile.Y + 1) * TileHeight;
+	if ((int64) OutWidth * OutHeight > MAX_int32)
+	{
+		LCReporter::ShowError(LOCTEXT("LandscapeUtils::BuildTiledLayout::Large", "The heightmap built from the tiles is too large."));
+		return false;
+	}
+
+	OutData.SetNumZeroed(OutWidth * OutHeight);
+
+	ParallelFor(Tiles.Num(), [&](int32 i)
+	{
+		const FLandscapeImportTile &Tile = Tiles[i];
+		for (int Y = 0; Y < TileHeight; Y++)
+		{
+			FMemory::Memcpy(
+				&OutData[(Tile.Tile.Y * TileHeight + Y) * OutWidth + Tile.Tile.X * TileWidth],
+				&Tile.Data[Y * TileWidth],
+				TileWidth * sizeof(uint16)
+			);
+		}
+	});
+
+	for (FLandscapeImportTile &Tile : Tiles) Tile.Data.Empty();
+
+	return true;
+}
+
 #if WITH_EDITOR
 
 #include "Editor.h"
@@ -563,7 +656,6 @@ bool LandscapeUtils::SpawnLandscape(
 
 	GLevelEditorModeTools().ActivateMode(FBuiltinEditorModes::EM_Landscape);
 	FEdModeLandscape* LandscapeEdMode = (FEdModeLandscape*)GLevelEditorModeTools().GetActiveMode(FBuiltinEditorModes::EM_Landscape);
-	ULandscapeEditorObject* UISettings = LandscapeEdMode->UISettings;
 	ULandscapeSubsystem* LandscapeSubsystem = LandscapeEdMode->GetWorld()->GetSubsystem<ULandscapeSubsystem>();
 	bool bIsGridBased = LandscapeSubsystem->IsGridBased();
 
@@ -654,6 +746,44 @@ bool LandscapeUtils::SpawnLandscape(
 		}
 	}
 
+	return SpawnLandscapeFromData(
+		Data, TotalWidth, TotalHeight, LandscapeLabel, bCreateLandscapeStreamingProxies,
+		bAutoComponents, bDropEdge,
+		QuadsPerSubsection0, SectionsPerComponent0, ComponentCount0,
+		OutSpawnedLandscape, OutSpawnedLandscapeStreamingProxies
+	);
+}
+
+bool LandscapeUtils::SpawnLandscapeFromData(
+	const TArray<uint16> &Data, int TotalWidth, int TotalHeight, FString LandscapeLabel, bool bCreateLandscapeStreamingProxies,
+	bool bAutoComponents, bool bDropEdge,
+	int QuadsPerSubsection0, int SectionsPerComponent0, FIntPoint ComponentCount0,
+	TObjectPtr<ALandscape> &OutSpawnedLandscape, TArray<TSoftObjectPtr<ALandscapeStreamingProxy>> &OutSpawnedLandscapeStreamingProxies
+)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("LandscapeUtils::SpawnLandscapeFromData");
+
+	if (Data.Num() != TotalWidth * TotalHeight)
+	{
+		LCReporter::ShowError(FText::Format(
+			LOCTEXT("SpawnLandscapeFromDataError", "Landscape Combinator Error: Cannot spawn landscape {0}, the heightmap data doesn't match its size {1}x{2}."),
+			FText::FromString(LandscapeLabel),
+			FText::AsNumber(TotalWidth),
+			FText::AsNumber(TotalHeight)
+		));
+		return false;
+	}
+
+	UE_LOG(LogLandscapeUtils, Log, TEXT("Spawning Landscape %s from a heightmap of size %dx%d"), *LandscapeLabel, TotalWidth, TotalHeight);
+
+	// This is to prevent a failed assertion when doing `GetActiveMode`
+	FGlobalTabmanager::Get()->TryInvokeTab(FTabId("LevelEditor"));
+
+	GLevelEditorModeTools().ActivateMode(FBuiltinEditorModes::EM_Landscape);
+	FEdModeLandscape* LandscapeEdMode = (FEdModeLandscape*)GLevelEditorModeTools().GetActiveMode(FBuiltinEditorModes::EM_Landscape);
+	ULandscapeEditorObject* UISettings = LandscapeEdMode->UISettings;
+	ULandscapeSubsystem* LandscapeSubsystem = LandscapeEdMode->GetWorld()->GetSubsystem<ULandscapeSubsystem>();
+
 
 	/* Expand the data to match components */
 
@@ -734,22 +864,6 @@ bool LandscapeUtils::SpawnLandscape(
 	return true;
 }
 
-bool LandscapeUtils::ExtendLandscape(ALandscape *LandscapeToExtend, TArray<FString> Heightmaps)
-{
-	check(IsInGameThread());
-
-	int NumFiles = Heightmaps.Num();
-	FScopedSlowTask SlowTask(NumFiles, LOCTEXT("ExtendingLandscapeTask", "Overwriting Landscape..."));
-	SlowTask.MakeDialog();
-	for (int32 i = 0; i < NumFiles; i++)
-	{
-		SlowTask.EnterProgressFrame();
-		UE_LOG(LogLandscapeUtils, Log, TEXT("Extending Landscape with Heightmap %d/%d: %s"), i + 1, NumFiles, *Heightmaps[i]);
-		if (!ExtendLandscape(LandscapeToExtend, Heightmaps[i])) return false;
-	}
-	return true;
-}
-
 bool LandscapeUtils::CRSToQuadSpace(ALandscape *LandscapeToExtend, ULandscapeInfo *LandscapeInfo, FVector4d &Coordinates, double &OutMinQX, double &OutMaxQX, double &OutMinQY, double &OutMaxQY )
 {
 	const double CRSMinX = Coordinates[0];
@@ -796,7 +910,209 @@ bool LandscapeUtils::CRSToQuadSpace(ALandscape *LandscapeToExtend, ULandscapeInf
 	return true;
 }
 
-bool LandscapeUtils::ExtendLandscape(ALandscape *LandscapeToExtend, FString Heightmap)
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 6)
+
+namespace
+{
+	/* Rectangle of the landscape (in quad space) covered by a heightmap, and the heightmap data resampled to it */
+	struct FExtensionRegion
+	{
+		FString Heightmap;
+		FVector4d Coordinates;
+		int32 MinQX = 0, MinQY = 0, MaxQX = 0, MaxQY = 0;
+		TArray<uint16> Data;
+
+		int32 SizeX() const { return MaxQX - MinQX + 1; }
+		int32 SizeY() const { return MaxQY - MinQY + 1; }
+	};
+
+	/* Bilinear resampling of the heightmap to the region, which doesn't have the same resolution.
+	 * The region is processed in parallel, in blocks of the size of a landscape component. */
+	void ResampleHeightmap(const TArray<float> &HeightmapMeters, int Width, int Height, double LandscapeZ, double LandscapeZScale, int32 BlockSize, FExtensionRegion &Region)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE_STR("ExtendLandscape::ResampleHeightmap");
+
+		const int32 SizeX = Region.SizeX();
+		const int32 SizeY = Region.SizeY();
+		Region.Data.SetNumUninitialized(SizeX * SizeY);
+
+		// the interpolation coordinates only depend on the column or on the row
+		TArray<int32> X0s, X1s, Y0s, Y1s;
+		TArray<float> Dxs, Dys;
+		X0s.SetNumUninitialized(SizeX); X1s.SetNumUninitialized(SizeX); Dxs.SetNumUninitialized(SizeX);
+		Y0s.SetNumUninitialized(SizeY); Y1s.SetNumUninitialized(SizeY); Dys.SetNumUninitialized(SizeY);
+
+		for (int32 X = 0; X < SizeX; X++)
+		{
+			const float SourceX = ((float) X) * (Width - 1) / (SizeX - 1);
+			X0s[X] = FMath::FloorToInt(SourceX);
+			X1s[X] = FMath::Min(X0s[X] + 1, Width - 1);
+			Dxs[X] = SourceX - X0s[X];
+		}
+
+		for (int32 Y = 0; Y < SizeY; Y++)
+		{
+			const float SourceY = ((float) Y) * (Height - 1) / (SizeY - 1);
+			Y0s[Y] = FMath::FloorToInt(SourceY);
+			Y1s[Y] = FMath::Min(Y0s[Y] + 1, Height - 1);
+			Dys[Y] = SourceY - Y0s[Y];
+		}
+
+		const int32 NumBlocksX = FMath::DivideAndRoundUp(SizeX, BlockSize);
+		const int32 NumBlocksY = FMath::DivideAndRoundUp(SizeY, BlockSize);
+
+		ParallelFor(NumBlocksX * NumBlocksY, [&](int32 Block)
+		{
+			const int32 BlockX1 = (Block % NumBlocksX) * BlockSize;
+			const int32 BlockY1 = (Block / NumBlocksX) * BlockSize;
+			const int32 BlockX2 = FMath::Min(BlockX1 + BlockSize, SizeX);
+			const int32 BlockY2 = FMath::Min(BlockY1 + BlockSize, SizeY);
+
+			for (int32 Y = BlockY1; Y < BlockY2; Y++)
+			{
+				const int32 Y0 = Y0s[Y];
+				const int32 Y1 = Y1s[Y];
+				const float Dy = Dys[Y];
+
+				for (int32 X = BlockX1; X < BlockX2; X++)
+				{
+					const int32 X0 = X0s[X];
+					const int32 X1 = X1s[X];
+					const float Dx = Dxs[X];
+
+					// Bilinear interpolation
+					const float H00 = HeightmapMeters[Y0 * Width + X0];
+					const float H10 = HeightmapMeters[Y0 * Width + X1];
+					const float H01 = HeightmapMeters[Y1 * Width + X0];
+					const float H11 = HeightmapMeters[Y1 * Width + X1];
+
+					const float GlobalHeightMeters =
+						(1 - Dx) * (1 - Dy) * H00 +
+						Dx       * (1 - Dy) * H10 +
+						(1 - Dx) * Dy       * H01 +
+						Dx       * Dy       * H11;
+
+					const float LocalHeight = (GlobalHeightMeters * 100.0f - LandscapeZ) / LandscapeZScale;
+					Region.Data[Y * SizeX + X] = LandscapeDataAccess::GetTexHeight(LocalHeight);
+				}
+			}
+		});
+	}
+
+	/* Creates all the new components, then registers them and initializes their edit layers in batches */
+	bool AddLandscapeComponents(ALandscape *LandscapeToExtend, ULandscapeInfo *LandscapeInfo, const TArray<FIntPoint> &ComponentsToAdd)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE_STR("ExtendLandscape::AddLandscapeComponents");
+
+		if (ComponentsToAdd.IsEmpty()) return true;
+
+		const int32 ComponentSizeQuads = LandscapeInfo->ComponentSizeQuads;
+		const int32 ComponentNumSubsections = LandscapeInfo->ComponentNumSubsections;
+		const int32 SubsectionSizeQuads = LandscapeInfo->SubsectionSizeQuads;
+
+		ULandscapeSubsystem* LandscapeSubsystem = LandscapeToExtend->GetWorld()->GetSubsystem<ULandscapeSubsystem>();
+		if (!IsValid(LandscapeSubsystem))
+		{
+			LCReporter::ShowError(LOCTEXT("InvalidLandscapeSubsystem", "Internal Error: Invalid landscape subsystem"));
+			return false;
+		}
+
+		// all new components start with the same (flat) heightmap data
+		TArray<FColor> HeightData;
+		const int32 ComponentVerts = (SubsectionSizeQuads + 1) * ComponentNumSubsections;
+		HeightData.AddZeroed(FMath::Square(ComponentVerts));
+
+		TArray<ULandscapeComponent*> AddedComponents;
+		for (const FIntPoint &CompCoord: ComponentsToAdd)
+		{
+			FIntPoint ComponentBase = CompCoord * ComponentSizeQuads;
+
+			ALandscapeProxy* LandscapeProxy = LandscapeSubsystem->FindOrAddLandscapeProxy(LandscapeInfo, ComponentBase);
+			if (!IsValid(LandscapeProxy))
+			{
+				LCReporter::ShowError(LOCTEXT("InvalidLandscapeProxy", "Internal Error: Invalid landscape proxy"));
+				return false;
+			}
+
+			ULandscapeComponent *LandscapeComponent = NewObject<ULandscapeComponent>(LandscapeProxy, NAME_None, RF_Transactional);
+			if (!IsValid(LandscapeComponent))
+			{
+				LCReporter::ShowError(LOCTEXT("InvalidLandscapeComponent", "Internal Error: Could not create landscape component"));
+				return false;
+			}
+
+			AddedComponents.Add(LandscapeComponent);
+
+			{
+				TRACE_CPUPROFILER_EVENT_SCOPE_STR("ExtendLandscape::LandscapeComponent::Init");
+				LandscapeComponent->Init(
+					ComponentBase.X, ComponentBase.Y,
+					ComponentSizeQuads,
+					ComponentNumSubsections,
+					SubsectionSizeQuads
+				);
+			}
+			
+			{
+				TRACE_CPUPROFILER_EVENT_SCOPE_STR("ExtendLandscape::InitHeightmapData");
+				LandscapeComponent->InitHeightmapData(HeightData, true);
+			}
+			{
+				TRACE_CPUPROFILER_EVENT_SCOPE_STR("ExtendLandscape::UpdateMaterialInstances");
+				LandscapeComponent->UpdateMaterialInstances();
+			}
+
+			LandscapeInfo->XYtoComponentMap.Add(CompCoord, LandscapeComponent);
+			LandscapeInfo->XYtoAddCollisionMap.Remove(CompCoord);
+		}
+
+		UE_LOG(LogLandscapeUtils, Log, TEXT("Added %d new components to Landscape %s"), AddedComponents.Num(), *LandscapeToExtend->GetActorNameOrLabel());
+
+		for (auto &LandscapeComponent: AddedComponents)
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE_STR("ExtendLandscape::RegisterComponent");
+			LandscapeComponent->RegisterComponent();
+		}
+
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION <= 6
+		if (LandscapeToExtend->HasLayersContent())
+		{
+			LandscapeToExtend->RequestLayersInitialization();
+		}
+#else
+		LandscapeToExtend->RequestLayersInitialization();
+#endif
+
+		for (auto &LandscapeComponent: AddedComponents)
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE_STR("ExtendLandscape::Updates");
+
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION <= 6
+			if (LandscapeToExtend->HasLayersContent())
+#else
+			if (true)
+#endif
+			{
+				TArray<ULandscapeComponent*> ComponentsUsingHeightmap;
+				ComponentsUsingHeightmap.Add(LandscapeComponent);
+				for (const ULandscapeEditLayerBase* EditLayer : LandscapeToExtend->GetEditLayersConst())
+				{
+					TMap<UTexture2D*, UTexture2D*> CreatedHeightmapTextures;
+					LandscapeComponent->AddDefaultLayerData(EditLayer->GetGuid(), ComponentsUsingHeightmap, CreatedHeightmapTextures);
+				}
+			}
+			LandscapeComponent->UpdateCachedBounds();
+			LandscapeComponent->UpdateBounds();
+			LandscapeComponent->MarkRenderStateDirty();
+		}
+
+		return true;
+	}
+}
+
+#endif
+
+bool LandscapeUtils::ExtendLandscape(ALandscape *LandscapeToExtend, TArray<FString> Heightmaps)
 {
 	TRACE_CPUPROFILER_EVENT_SCOPE_STR("ExtendLandscape::ExtendLandscape");
 
@@ -824,20 +1140,13 @@ bool LandscapeUtils::ExtendLandscape(ALandscape *LandscapeToExtend, FString Heig
 	}
 
 	const int32 ComponentSizeQuads = LandscapeInfo->ComponentSizeQuads;
-	const int32 ComponentNumSubsections = LandscapeInfo->ComponentNumSubsections;
-	const int32 SubsectionSizeQuads = LandscapeInfo->SubsectionSizeQuads;
+	const int NumFiles = Heightmaps.Num();
 
-	FVector4d FileCoordinates;
-	if (!GDALInterface::GetCoordinates(FileCoordinates, Heightmap)) return false;
+	/* The components needed by all the heightmaps are added at once, then the heightmaps are resampled in parallel
+	 * and written with one transaction per heightmap */
 
-	double FMinQX, FMaxQX, FMinQY, FMaxQY;
-	if (!CRSToQuadSpace(LandscapeToExtend, LandscapeInfo, FileCoordinates, FMinQX, FMaxQX, FMinQY, FMaxQY)) return false;
-
-	// Compute inclusive component index range covering the file bounds
-	const int32 FCompX1 = FMath::FloorToInt(FMinQX / ComponentSizeQuads);
-	const int32 FCompX2 = FMath::CeilToInt (FMaxQX / ComponentSizeQuads) - 1;
-	const int32 FCompY1 = FMath::FloorToInt(FMinQY / ComponentSizeQuads);
-	const int32 FCompY2 = FMath::CeilToInt (FMaxQY / ComponentSizeQuads) - 1;
+	FScopedSlowTask SlowTask(2 * NumFiles + 1, LOCTEXT("ExtendingLandscapeTask", "Overwriting Landscape..."));
+	SlowTask.MakeDialog();
 
 	int LCompX1 = MAX_int32;
 	int LCompX2 = MIN_int32;
@@ -851,12 +1160,30 @@ bool LandscapeUtils::ExtendLandscape(ALandscape *LandscapeToExtend, FString Heig
 		LCompY2 = FMath::Max(XY.Y, LCompY2);
 	}
 
-	const int32 MinCompX = FMath::Min(FCompX1, LCompX1);
-	const int32 MaxCompX = FMath::Max(FCompX2, LCompX2);
-	const int32 MinCompY = FMath::Min(FCompY1, LCompY1);
-	const int32 MaxCompY = FMath::Max(FCompY2, LCompY2);
+	int32 MinCompX = LCompX1;
+	int32 MaxCompX = LCompX2;
+	int32 MinCompY = LCompY1;
+	int32 MaxCompY = LCompY2;
+
+	TArray<FExtensionRegion> Regions;
+	Regions.SetNum(NumFiles);
+	for (int32 i = 0; i < NumFiles; i++)
+	{
+		FExtensionRegion &Region = Regions[i];
+		Region.Heightmap = Heightmaps[i];
+		if (!GDALInterface::GetCoordinates(Region.Coordinates, Region.Heightmap)) return false;
+
+		double FMinQX, FMaxQX, FMinQY, FMaxQY;
+		if (!CRSToQuadSpace(LandscapeToExtend, LandscapeInfo, Region.Coordinates, FMinQX, FMaxQX, FMinQY, FMaxQY)) return false;
+
+		// Compute inclusive component index range covering the file bounds
+		MinCompX = FMath::Min(MinCompX, FMath::FloorToInt(FMinQX / ComponentSizeQuads));
+		MaxCompX = FMath::Max(MaxCompX, FMath::CeilToInt (FMaxQX / ComponentSizeQuads) - 1);
+		MinCompY = FMath::Min(MinCompY, FMath::FloorToInt(FMinQY / ComponentSizeQuads));
+		MaxCompY = FMath::Max(MaxCompY, FMath::CeilToInt (FMaxQY / ComponentSizeQuads) - 1);
+	}
 
-	TSet<FIntPoint> ComponentsToAdd;
+	TArray<FIntPoint> ComponentsToAdd;
 	for (int32 CompX = MinCompX; CompX <= MaxCompX; CompX++)
 	{
 		for (int32 CompY = MinCompY; CompY <= MaxCompY; CompY++)
@@ -873,7 +1200,7 @@ bool LandscapeUtils::ExtendLandscape(ALandscape *LandscapeToExtend, FString Heig
 		FText::Format(
 			LOCTEXT("AddManyComponents", "Extending Landscape {0} with heigthmap {1} requires adding {2} components. Continue?"),
 			FText::FromString(LandscapeToExtend->GetActorNameOrLabel()),
-			FText::FromString(Heightmap),
+			FText::FromString(FString::Join(Heightmaps, TEXT(", "))),
 			ComponentsToAdd.Num()
 		),
 		"SuppressAddManyComponents"
@@ -882,180 +1209,63 @@ bool LandscapeUtils::ExtendLandscape(ALandscape *LandscapeToExtend, FString Heig
 		return false;
 	}
 
-	TArray<ULandscapeComponent*> AddedComponents;
-	for (auto &CompCoord: ComponentsToAdd)
-	{
-		FIntPoint ComponentBase = CompCoord * LandscapeInfo->ComponentSizeQuads;
-		ULandscapeSubsystem* LandscapeSubsystem = LandscapeToExtend->GetWorld()->GetSubsystem<ULandscapeSubsystem>();
-		if (!IsValid(LandscapeSubsystem))
-		{
-			LCReporter::ShowError(LOCTEXT("InvalidLandscapeSubsystem", "Internal Error: Invalid landscape subsystem"));
-			return false;
-		}
-
-		ALandscapeProxy* LandscapeProxy = LandscapeSubsystem->FindOrAddLandscapeProxy(LandscapeInfo, ComponentBase);
-		if (!IsValid(LandscapeProxy))
-		{
-			LCReporter::ShowError(LOCTEXT("InvalidLandscapeProxy", "Internal Error: Invalid landscape proxy"));
-			return false;
-		}
-
-		ULandscapeComponent *LandscapeComponent = NewObject<ULandscapeComponent>(LandscapeProxy, NAME_None, RF_Transactional);
-		if (!IsValid(LandscapeComponent))
-		{
-			LCReporter::ShowError(LOCTEXT("InvalidLandscapeComponent", "Internal Error: Could not create landscape component"));
-			return false;
-		}
-
-		AddedComponents.Add(LandscapeComponent);
-
-		{
-			TRACE_CPUPROFILER_EVENT_SCOPE_STR("ExtendLandscape::LandscapeComponent::Init");
-			LandscapeComponent->Init(
-				ComponentBase.X, ComponentBase.Y,
-				ComponentSizeQuads,
-				ComponentNumSubsections,
-				SubsectionSizeQuads
-			);
-		}
-
-		TArray<FColor> HeightData;
-		const int32 ComponentVerts = (LandscapeComponent->SubsectionSizeQuads + 1) * LandscapeComponent->NumSubsections;
-		HeightData.AddZeroed(FMath::Square(ComponentVerts));
-		
-		{
-			TRACE_CPUPROFILER_EVENT_SCOPE_STR("ExtendLandscape::InitHeightmapData");
-			LandscapeComponent->InitHeightmapData(HeightData, true);
-		}
-		{
-			TRACE_CPUPROFILER_EVENT_SCOPE_STR("ExtendLandscape::UpdateMaterialInstances");
-			LandscapeComponent->UpdateMaterialInstances();
-		}
-
-		LandscapeInfo->XYtoComponentMap.Add(CompCoord, LandscapeComponent);
-		LandscapeInfo->XYtoAddCollisionMap.Remove(CompCoord);
+	SlowTask.EnterProgressFrame();
+	if (!AddLandscapeComponents(LandscapeToExtend, LandscapeInfo, ComponentsToAdd)) return false;
 
-		UE_LOG(LogTemp, Log, TEXT("Added new component at (%d,%d)"), CompCoord.X, CompCoord.Y);
-	}
+	int32 TotalSizeX = LandscapeToExtend->ComputeComponentCounts().X * ComponentSizeQuads + 1;
+	int32 TotalSizeY = LandscapeToExtend->ComputeComponentCounts().Y * ComponentSizeQuads + 1;
+	const double LandscapeZ = LandscapeToExtend->GetActorLocation().Z;
+	const double LandscapeZScale = LandscapeToExtend->GetActorScale3D().Z;
 
-	for (auto &LandscapeComponent: AddedComponents)
+	for (FExtensionRegion &Region : Regions)
 	{
-		TRACE_CPUPROFILER_EVENT_SCOPE_STR("ExtendLandscape::RegisterComponent");
-		LandscapeComponent->RegisterComponent();
-	}
+		SlowTask.EnterProgressFrame();
+		UE_LOG(LogLandscapeUtils, Log, TEXT("Resampling Heightmap %s"), *Region.Heightmap);
 
-#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION <= 6
-	if (LandscapeToExtend->HasLayersContent())
-	{
-		LandscapeToExtend->RequestLayersInitialization();
-	}
-#else
-	LandscapeToExtend->RequestLayersInitialization();
-#endif
+		// recompute the file bounds in quad space after the new components have been added
+		double FMinQX2, FMaxQX2, FMinQY2, FMaxQY2;
+		if (!CRSToQuadSpace(LandscapeToExtend, LandscapeInfo, Region.Coordinates, FMinQX2, FMaxQX2, FMinQY2, FMaxQY2)) return false;
 
-	for (auto &LandscapeComponent: AddedComponents)
-	{
-		TRACE_CPUPROFILER_EVENT_SCOPE_STR("ExtendLandscape::Updates");
+		Region.MinQX = FMath::Min(TotalSizeX - 1, FMath::Max(0, FMath::FloorToInt(FMinQX2)));
+		Region.MaxQX = FMath::Min(TotalSizeX - 1, FMath::Max(0, FMath::CeilToInt(FMaxQX2)));
+		Region.MinQY = FMath::Min(TotalSizeY - 1, FMath::Max(0, FMath::FloorToInt(FMinQY2)));
+		Region.MaxQY = FMath::Min(TotalSizeY - 1, FMath::Max(0, FMath::CeilToInt(FMaxQY2)));
 
-#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION <= 6
-		if (LandscapeToExtend->HasLayersContent())
-#else
-		if (true)
-#endif
+		if (Region.SizeX() > INT32_MAX / Region.SizeY())
 		{
-			TArray<ULandscapeComponent*> ComponentsUsingHeightmap;
-			ComponentsUsingHeightmap.Add(LandscapeComponent);
-			for (const ULandscapeEditLayerBase* EditLayer : LandscapeToExtend->GetEditLayersConst())
-			{
-				TMap<UTexture2D*, UTexture2D*> CreatedHeightmapTextures;
-				LandscapeComponent->AddDefaultLayerData(EditLayer->GetGuid(), ComponentsUsingHeightmap, CreatedHeightmapTextures);
-			}
+			LCReporter::ShowError(
+				LOCTEXT("LandscapeUtils::ExtendLandscape::LargeArea", "The size of the area to edit is too large.")
+			);
+			return false;
 		}
-		LandscapeComponent->UpdateCachedBounds();
-		LandscapeComponent->UpdateBounds();
-		LandscapeComponent->MarkRenderStateDirty();
-	}
-
-	// recompute the file bounds in quad space after the new components have been added
-	double FMinQX2, FMaxQX2, FMinQY2, FMaxQY2;
-	if (!CRSToQuadSpace(LandscapeToExtend, LandscapeInfo, FileCoordinates, FMinQX2, FMaxQX2, FMinQY2, FMaxQY2)) return false;
-
-	int32 TotalSizeX = LandscapeToExtend->ComputeComponentCounts().X * ComponentSizeQuads + 1;
-	int32 TotalSizeY = LandscapeToExtend->ComputeComponentCounts().Y * ComponentSizeQuads + 1;
 
-	FMinQX2 = (int) FMath::Min(TotalSizeX - 1, FMath::Max(0, FMath::FloorToInt(FMinQX2)));
-	FMaxQX2 = (int) FMath::Min(TotalSizeX - 1, FMath::Max(0, FMath::CeilToInt(FMaxQX2)));
-	FMinQY2 = (int) FMath::Min(TotalSizeY - 1, FMath::Max(0, FMath::FloorToInt(FMinQY2)));
-	FMaxQY2 = (int) FMath::Min(TotalSizeY - 1, FMath::Max(0, FMath::CeilToInt(FMaxQY2)));
+		int OutWidth, OutHeight;
+		TArray<float> HeightmapMeters;
+		if (!GDALInterface::ReadHeightmapFromFile(Region.Heightmap, OutWidth, OutHeight, HeightmapMeters)) return false;
 
-	int32 SizeX = FMaxQX2 - FMinQX2 + 1;
-	int32 SizeY = FMaxQY2 - FMinQY2 + 1;
-
-	if (SizeX > INT32_MAX / SizeY)
-	{
-		LCReporter::ShowError(
-			LOCTEXT("LandscapeUtils::ExtendLandscape::LargeArea", "The size of the area to edit is too large.")
-		);
-		return false;
+		ResampleHeightmap(HeightmapMeters, OutWidth, OutHeight, LandscapeZ, LandscapeZScale, ComponentSizeQuads, Region);
 	}
 	
-	uint16* HeightmapDataUE = (uint16*) malloc(SizeX * SizeY * (sizeof (uint16)));
-	if (!HeightmapDataUE)
-	{
-		LCReporter::ShowError(
-			LOCTEXT("LandscapeUtils::ExtendLandscape::NotEnoughMemory", "Not enough memory to allocate for new heightmap data.")
-		);
-		return false;
-	}
-
-	int OutWidth, OutHeight;
-	TArray<float> HeightmapMeters;
-	if (!GDALInterface::ReadHeightmapFromFile(Heightmap, OutWidth, OutHeight, HeightmapMeters)) return false;
+	FHeightmapAccessor<false> HeightmapAccessor(LandscapeInfo);
+	HeightmapAccessor.SetEditLayer(LandscapeToExtend->GetEditLayer(0)->GetGuid());
 
-	// fill the HeightmapDataUE with the data from the heightmap, taking into account the fact
-	// that they don't have the same resolution (bilinear interpolation)
-	for (int32 Y = 0; Y < SizeY; Y++)
+	for (FExtensionRegion &Region : Regions)
 	{
-		for (int32 X = 0; X < SizeX; X++)
-		{
-			const float SourceX = ((float) X) * (OutWidth  - 1) / (SizeX - 1);
-			const float SourceY = ((float) Y) * (OutHeight - 1) / (SizeY - 1);
-
-			const int X0 = FMath::FloorToInt(SourceX);
-			const int Y0 = FMath::FloorToInt(SourceY);
-			const int X1 = FMath::Min(X0 + 1, OutWidth  - 1);
-			const int Y1 = FMath::Min(Y0 + 1, OutHeight - 1);
-
-			const float Dx = SourceX - X0;
-			const float Dy = SourceY - Y0;
-
-			// Bilinear interpolation
-			const float H00 = HeightmapMeters[Y0 * OutWidth + X0];
-			const float H10 = HeightmapMeters[Y0 * OutWidth + X1];
-			const float H01 = HeightmapMeters[Y1 * OutWidth + X0];
-			const float H11 = HeightmapMeters[Y1 * OutWidth + X1];
-
-			const float GlobalHeightMeters =
-				(1 - Dx) * (1 - Dy) * H00 +
-				Dx       * (1 - Dy) * H10 +
-				(1 - Dx) * Dy       * H01 +
-				Dx       * Dy       * H11;
-
-			const float LocalHeight = (GlobalHeightMeters * 100.0f - LandscapeToExtend->GetActorLocation().Z) / LandscapeToExtend->GetActorScale3D().Z;
-			HeightmapDataUE[Y * SizeX + X] = LandscapeDataAccess::GetTexHeight(LocalHeight);
-		}
+		SlowTask.EnterProgressFrame();
+		UE_LOG(LogLandscapeUtils, Log, TEXT("Extending Landscape with Heightmap %s"), *Region.Heightmap);
+
+		HeightmapAccessor.SetData(Region.MinQX, Region.MinQY, Region.MaxQX, Region.MaxQY, Region.Data.GetData());
+		Region.Data.Empty();
 	}
-	
-	FHeightmapAccessor<false> HeightmapAccessor(LandscapeInfo);
-	
-	HeightmapAccessor.SetEditLayer(LandscapeToExtend->GetEditLayer(0)->GetGuid());	
-	HeightmapAccessor.SetData(FMinQX2, FMinQY2, FMaxQX2, FMaxQY2, HeightmapDataUE);
-	free(HeightmapDataUE);
 
 	return true;
 #endif
 }
 
+bool LandscapeUtils::ExtendLandscape(ALandscape *LandscapeToExtend, FString Heightmap)
+{
+	return ExtendLandscape(LandscapeToExtend, TArray<FString>({ Heightmap }));
+}
 
 #endif
 
@@ -0,0 +1,48 @@
+// Copyright 2023-2025 LandscapeCombinator. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "Landscape.h"
+
+/* Computes the ground height at many locations at once.
+ * When the ground is a single landscape, the heights are read from a copy of its heightmap, using bilinear interpolation.
+ * This is much faster than line traces, and can be done from any thread.
+ * For other actors (or at runtime, where heightmaps cannot be read), line traces are used, and they are run in parallel. */
+class LANDSCAPEUTILS_API HeightSampler
+{
+public:
+	HeightSampler(UWorld *World0, FCollisionQueryParams CollisionQueryParams0, bool bDrawDebugLines0 = false) :
+		World(World0), CollisionQueryParams(CollisionQueryParams0), bDrawDebugLines(bDrawDebugLines0) {};
+
+	/* Must be called on the game thread. Returns false when the heightmap cannot be read, in which case line traces are used.
+	 * When debug lines are requested, line traces are always used so that they can be displayed. */
+	bool UseLandscapeHeightmap(ALandscape *Landscape);
+	bool IsUsingHeightmap() const { return !Heights.IsEmpty(); }
+
+	bool GetZ(double X, double Y, double &OutZ) const;
+
+	/* OutZs and OutHits get the same size as Locations, and OutHits[i] is false when no ground was found at Locations[i] */
+	void GetZs(const TArray<FVector2D> &Locations, TArray<double> &OutZs, TArray<bool> &OutHits) const;
+
+	/* Ground normals, computed from the gradient of the heightmap, or from the line trace hits */
+	bool GetNormal(double X, double Y, FVector &OutNormal) const;
+	void GetNormals(const TArray<FVector2D> &Locations, TArray<FVector> &OutNormals, TArray<bool> &OutHits) const;
+
+private:
+	bool GetHeightmapZ(double X, double Y, double &OutZ) const;
+	bool GetHeightmapNormal(double X, double Y, FVector &OutNormal) const;
+
+	UWorld *World = nullptr;
+	FCollisionQueryParams CollisionQueryParams;
+	bool bDrawDebugLines = false;
+
+	// copy of the landscape heightmap, in landscape quad space
+	FTransform LandscapeTransform;
+	int32 MinX = 0;
+	int32 MinY = 0;
+	int32 SizeX = 0;
+	int32 SizeY = 0;
+	TArray<uint16> Heights;
+};
@@ -11,6 +11,15 @@
 
 using namespace UE::Geometry;
 
+/* Heightmap data of one tile of a tiled world, with the tile indices read from file names of the form Filename_x0_y0 */
+struct FLandscapeImportTile
+{
+	FIntPoint Tile = FIntPoint(0, 0);
+	int Width = 0;
+	int Height = 0;
+	TArray<uint16> Data;
+};
+
 class LANDSCAPEUTILS_API LandscapeUtils
 {
 public:
@@ -39,6 +48,11 @@ public:
 	static bool GetActorCRSBounds(AActor *Actor, FString ToCRS, FVector4d &OutCoordinates);
 	static bool GetActorCRSBounds(AActor *Actor, UGlobalCoordinates *GlobalCoordinates, FString ToCRS, FVector4d &OutCoordinates);
 
+	/* Assembles the tiles in a single heightmap, tile (0, 0) being at the top left corner.
+	 * All tiles must have the same size and distinct indices, and missing tiles are filled with zeros (with a warning).
+	 * The data of the tiles is moved to OutData. */
+	static bool BuildTiledLayout(TArray<FLandscapeImportTile> &Tiles, TArray<uint16> &OutData, int &OutWidth, int &OutHeight);
+
 #if WITH_EDITOR
 
 	static bool SpawnLandscape(
@@ -49,6 +63,14 @@ public:
 		TObjectPtr<ALandscape> &OutSpawnedLandscape, TArray<TSoftObjectPtr<ALandscapeStreamingProxy>> &OutSpawnedLandscapeStreamingProxies
 	);
 
+	/* Same as SpawnLandscape, but from heightmap data that is already in memory */
+	static bool SpawnLandscapeFromData(
+		const TArray<uint16> &Data, int TotalWidth, int TotalHeight, FString LandscapeLabel, bool bCreateLandscapeStreamingProxies,
+		bool bAutoComponents, bool bDropData,
+		int QuadsPerSubsection, int SectionsPerComponent, FIntPoint ComponentCount,
+		TObjectPtr<ALandscape> &OutSpawnedLandscape, TArray<TSoftObjectPtr<ALandscapeStreamingProxy>> &OutSpawnedLandscapeStreamingProxies
+	);
+
 	static bool CRSToQuadSpace(ALandscape *LandscapeToExtend, ULandscapeInfo *LandscapeInfo, FVector4d &Coordinates, double &OutMinQX, double &OutMaxQX, double &OutMinQY, double &OutMaxQY);
 	static bool ExtendLandscape(ALandscape *LandscapeToExtend, FString Heightmap);
 	static bool ExtendLandscape(ALandscape *LandscapeToExtend, TArray<FString> Heightmaps);
@@ -10,6 +10,26 @@
 
 #define LOCTEXT_NAMESPACE "FMapboxHelpersModule"
 
+void MapboxHelpers::DecodeHeights(const uint8* RESTRICT Red, const uint8* RESTRICT Green, const uint8* RESTRICT Blue, float* RESTRICT Heights, int64 Num, bool bUseTerrariumFormula)
+{
+	// the formula is chosen outside of the loops so that both loops are straight-line code that the compiler can vectorize
+	if (bUseTerrariumFormula)
+	{
+		for (int64 i = 0; i < Num; i++)
+		{
+			Heights[i] = (Red[i] * 256.0f + Green[i] + Blue[i] / 256.0f) - 32768.0f;
+		}
+	}
+	else
+	{
+		for (int64 i = 0; i < Num; i++)
+		{
+			const int32 Code = (int32(Red[i]) << 16) | (int32(Green[i]) << 8) | int32(Blue[i]);
+			Heights[i] = -10000.0f + Code * 0.1f;
+		}
+	}
+}
+
 bool MapboxHelpers::DecodeMapboxOneBand(FString InputFile, FString OutputFile, bool bUseTerrariumFormula, bool *bShowedDialog)
 {
 	/* Read the RGB bands from `InputFile` */
@@ -335,24 +355,7 @@ bool MapboxHelpers::DecodeMapboxThreeBands(FString InputFile, FString OutputFile
 	}
 
 
-	for (int X = 0; X < SizeX; X++)
-	{
-		for (int Y = 0; Y < SizeY; Y++)
-		{
-			int i = X + Y * SizeX;
-			float R = RedBand[i];
-			float G = GreenBand[i];
-			float B = BlueBand[i];
-			if (bUseTerrariumFormula)
-			{
-				HeightmapData[i] = (R * 256 + G + B / 256) - 32768;			
-			}
-			else
-			{
-				HeightmapData[i] = -10000 + ((R * 256 * 256 + G * 256 + B) * 0.1);
-			}
-		}
-	}
+	DecodeHeights(RedBand, GreenBand, BlueBand, HeightmapData, (int64) SizeX * SizeY, bUseTerrariumFormula);
 	free(RedBand);
 	free(GreenBand);
 	free(BlueBand);
@@ -417,4 +420,135 @@ bool MapboxHelpers::DecodeMapboxThreeBands(FString InputFile, FString OutputFile
 	return true;
 }
 
+bool MapboxHelpers::DecodeMapboxThreeBandsGeoreferenced(
+	FString InputFile, FString OutputFile, bool bUseTerrariumFormula, bool *bShowedDialog,
+	FString CRS, double MinLong, double MaxLong, double MinLat, double MaxLat
+)
+{
+	/* Read the RGB bands from `InputFile` in a single buffer */
+
+	GDALDataset *Dataset = (GDALDataset *) GDALOpen(TCHAR_TO_UTF8(*InputFile), GA_ReadOnly);
+
+	if (!Dataset)
+	{
+		LCReporter::ShowOneError(
+			FText::Format(
+				LOCTEXT("MapboxHelpers::6", "Could not read (three bands) file {0} using GDAL.\n{1}"),
+				FText::FromString(InputFile),
+				FText::FromString(CPLGetLastErrorMsg())
+			),
+			bShowedDialog
+		);
+		return false;
+	}
+
+	if (Dataset->GetRasterCount() < 3)
+	{
+		LCReporter::ShowOneError(
+			FText::Format(
+				LOCTEXT("MapboxHelpers::0", "Expected at least three bands from heightmap {0}, but got {1} instead."),
+				FText::FromString(InputFile),
+				FText::AsNumber(Dataset->GetRasterCount())
+			),
+			bShowedDialog
+		);
+		GDALClose(Dataset);
+		return false;
+	}
+
+	const int SizeX = Dataset->GetRasterXSize();
+	const int SizeY = Dataset->GetRasterYSize();
+	const int64 NumPixels = (int64) SizeX * SizeY;
+
+	TArray<uint8> RGB;
+	RGB.SetNumUninitialized(3 * NumPixels);
+
+	int BandMap[3] = { 1, 2, 3 };
+	CPLErr ReadErr = Dataset->RasterIO(GF_Read, 0, 0, SizeX, SizeY, RGB.GetData(), SizeX, SizeY, GDT_Byte, 3, BandMap, 0, 0, 0, nullptr);
+	GDALClose(Dataset);
+
+	if (ReadErr != CE_None)
+	{
+		LCReporter::ShowOneError(
+			FText::Format(
+				LOCTEXT("MapboxHelpers::7", "There was an error while reading heightmap data from file {0}."),
+				FText::FromString(InputFile)
+			),
+			bShowedDialog
+		);
+		return false;
+	}
+
+
+	/* Decode the heights */
+
+	TArray<float> HeightmapData;
+	HeightmapData.SetNumUninitialized(NumPixels);
+	DecodeHeights(RGB.GetData(), RGB.GetData() + NumPixels, RGB.GetData() + 2 * NumPixels, HeightmapData.GetData(), NumPixels, bUseTerrariumFormula);
+	RGB.Empty();
+
+
+	/* Write a single georeferenced GeoTIFF to `OutputFile` */
+
+	OGRSpatialReference SpatialReference;
+	if (!GDALInterface::SetCRSFromUserInput(SpatialReference, CRS, false))
+	{
+		LCReporter::ShowOneError(
+			FText::Format(
+				LOCTEXT("MapboxHelpers::CRS", "Could not create spatial reference {0} for file {1}."),
+				FText::FromString(CRS),
+				FText::FromString(OutputFile)
+			),
+			bShowedDialog
+		);
+		return false;
+	}
+
+	GDALDriver *TIFDriver = GetGDALDriverManager()->GetDriverByName("GTiff");
+	if (!TIFDriver)
+	{
+		LCReporter::ShowOneError(LOCTEXT("MapboxHelpers::3", "Could not load GDAL drivers."), bShowedDialog);
+		return false;
+	}
+
+	GDALDataset *TIFDataset = TIFDriver->Create(TCHAR_TO_UTF8(*OutputFile), SizeX, SizeY, 1, GDT_Float32, nullptr);
+	if (!TIFDataset)
+	{
+		LCReporter::ShowOneError(
+			FText::Format(
+				LOCTEXT("MapboxHelpers::CreateTIF", "Could not write heightmap to file {0}.\n{1}"),
+				FText::FromString(OutputFile),
+				FText::FromString(CPLGetLastErrorMsg())
+			),
+			bShowedDialog
+		);
+		return false;
+	}
+
+	double GeoTransform[6] = {
+		MinLong, (MaxLong - MinLong) / SizeX, 0,
+		MaxLat, 0, -(MaxLat - MinLat) / SizeY
+	};
+	TIFDataset->SetGeoTransform(GeoTransform);
+	TIFDataset->SetSpatialRef(&SpatialReference);
+
+	CPLErr WriteErr = TIFDataset->GetRasterBand(1)->RasterIO(GF_Write, 0, 0, SizeX, SizeY, HeightmapData.GetData(), SizeX, SizeY, GDT_Float32, 0, 0);
+	GDALClose(TIFDataset);
+
+	if (WriteErr != CE_None)
+	{
+		LCReporter::ShowOneError(
+			FText::Format(
+				LOCTEXT("MapboxHelpers::5", "There was an error while writing heightmap data to file {0}. (Error: {1})"),
+				FText::FromString(OutputFile),
+				FText::AsNumber(WriteErr, &FNumberFormattingOptions::DefaultNoGrouping())
+			),
+			bShowedDialog
+		);
+		return false;
+	}
+
+	return true;
+}
+
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
@@ -9,4 +9,12 @@ class MAPBOXHELPERS_API MapboxHelpers
 public:
 	static bool DecodeMapboxOneBand(FString InputFile, FString OutputFile, bool bUseTerrariumFormula, bool *bShowedDialog);
 	static bool DecodeMapboxThreeBands(FString InputFile, FString OutputFile, bool bUseTerrariumFormula, bool *bShowedDialog);
+
+	/* Decodes `InputFile` and writes a single georeferenced GeoTIFF, without intermediate files */
+	static bool DecodeMapboxThreeBandsGeoreferenced(
+		FString InputFile, FString OutputFile, bool bUseTerrariumFormula, bool *bShowedDialog,
+		FString CRS, double MinLong, double MaxLong, double MinLat, double MaxLat
+	);
+
+	static void DecodeHeights(const uint8* RESTRICT Red, const uint8* RESTRICT Green, const uint8* RESTRICT Blue, float* RESTRICT Heights, int64 Num, bool bUseTerrariumFormula);
 };
@@ -4,6 +4,8 @@
 #include "LCCommon/LCBlueprintLibrary.h"
 #include "ConcurrencyHelpers/LCReporter.h"
 
+#include "Misc/ScopeLock.h"
+
 #if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 7)
 #include "Subsystems/PCGSubsystem.h"
 #endif
@@ -63,15 +65,14 @@ bool AOGRGeometry::OnGenerate(FName SpawnedActorsPathOverride, bool bIsUserIniti
 
 	UE_LOG(LogSplineImporter, Log, TEXT("Got a valid dataset to extract geometries, continuing..."));
 
-	if (bClearGeometryBeforeImporting || !Geometry)
-	{
-		Geometry = OGRGeometryFactory::createGeometry(OGRwkbGeometryType::wkbMultiPolygon);
-	}
+	/* The geometries are collected first and merged with a single cascaded union at the end,
+	 * which is much faster than adding them to the union one by one */
 
-	if (!Geometry)
+	OGRGeometryCollection Geometries;
+
+	if (!bClearGeometryBeforeImporting && Geometry)
 	{
-		LCReporter::ShowError(LOCTEXT("AOGRGeometry::OnGenerate::NoGeometry", "Internal error while creating geometry, please try again."));
-		return false;
+		Geometries.addGeometry(Geometry);
 	}
 	
 	int n = Dataset->GetLayerCount();
@@ -95,34 +96,96 @@ bool AOGRGeometry::OnGenerate(FName SpawnedActorsPathOverride, bool bIsUserIniti
 			{
 				UE_LOG(LogSplineImporter, Warning, TEXT("%s"), *FString(CPLGetLastErrorMsg()));
 				UE_LOG(LogSplineImporter, Warning, TEXT("Obtained invalid geometry from feature, we'll make it valid and continue anyway"));
-				NewGeometry = NewGeometry->MakeValid();
-			}
-
-			OGRGeometry* NewUnion = Geometry->Union(NewGeometry);
-			if (NewUnion)
-			{
-				Geometry = NewUnion;
-				NumGeometries++;
-#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 7)
-				Concurrency::RunOnGameThread([](){
-					if (UPCGSubsystem* PCGSubsystem = UPCGSubsystem::GetSubsystemForCurrentWorld()) PCGSubsystem->FlushCache();
-				});
-#endif
+				OGRGeometry* ValidGeometry = NewGeometry->MakeValid();
+				if (!ValidGeometry)
+				{
+					UE_LOG(LogSplineImporter, Warning, TEXT("Could not make the geometry valid, we'll skip it"));
+					continue;
+				}
+				Geometries.addGeometryDirectly(ValidGeometry);
 			}
 			else
 			{
-				UE_LOG(LogSplineImporter, Warning, TEXT("Error: %s"), *FString(CPLGetLastErrorMsg()));
-				UE_LOG(LogSplineImporter, Warning, TEXT("There was an error while taking union of geometries in OGR, we'll skip a geometry"))
+				Geometries.addGeometry(NewGeometry);
 			}
+
+			NumGeometries++;
 		}
 	}
 
+	UE_LOG(LogSplineImporter, Log, TEXT("Computing the union of %d geometries"), Geometries.getNumGeometries());
+
+	OGRGeometry* NewUnion = Geometries.IsEmpty()
+		? OGRGeometryFactory::createGeometry(OGRwkbGeometryType::wkbMultiPolygon)
+		: Geometries.UnaryUnion();
+
+	if (!NewUnion)
+	{
+		UE_LOG(LogSplineImporter, Error, TEXT("Error: %s"), *FString(CPLGetLastErrorMsg()));
+		LCReporter::ShowError(LOCTEXT("AOGRGeometry::OnGenerate::NoUnion", "There was an error while taking the union of geometries in OGR, please check the logs."));
+		return false;
+	}
+
+	SetGeometry(NewUnion);
+
+#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 7)
+	Concurrency::RunOnGameThread([](){
+		if (UPCGSubsystem* PCGSubsystem = UPCGSubsystem::GetSubsystemForCurrentWorld()) PCGSubsystem->FlushCache();
+	});
+#endif
+
 	UE_LOG(LogSplineImporter, Log, TEXT("Found %d geometries"), NumGeometries);
 	Tags.AddUnique(AreaTag);
 	
 	return true;
 }
 
+void AOGRGeometry::SetGeometry(OGRGeometry *NewGeometry)
+{
+	FScopeLock Lock(&PreparedGeometryLock);
+
+	if (Geometry && Geometry != NewGeometry) OGRGeometryFactory::destroyGeometry(Geometry);
+
+	Geometry = NewGeometry;
+	PreparedGeometry.reset();
+	Envelope = OGREnvelope();
+
+	if (Geometry)
+	{
+		Geometry->getEnvelope(&Envelope);
+		if (OGRHasPreparedGeometrySupport())
+		{
+			PreparedGeometry.reset(OGRCreatePreparedGeometry(OGRGeometry::ToHandle(Geometry)));
+		}
+	}
+}
+
+bool AOGRGeometry::IntersectsPoints(const TArray<FVector2D> &Points, TArray<bool> &OutIntersects) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("AOGRGeometry::IntersectsPoints");
+
+	// GEOS prepared geometries must not be queried concurrently
+	FScopeLock Lock(&PreparedGeometryLock);
+
+	if (!Geometry) return false;
+
+	OutIntersects.Init(false, Points.Num());
+
+	for (int32 i = 0; i < Points.Num(); i++)
+	{
+		const double X = Points[i].X;
+		const double Y = Points[i].Y;
+		if (X < Envelope.MinX || X > Envelope.MaxX || Y < Envelope.MinY || Y > Envelope.MaxY) continue;
+
+		OGRPoint Point(X, Y);
+		OutIntersects[i] = PreparedGeometry
+			? OGRPreparedGeometryIntersects(PreparedGeometry.get(), OGRGeometry::ToHandle(&Point)) != 0
+			: Geometry->Intersects(&Point);
+	}
+
+	return true;
+}
+
 #if WITH_EDITOR
 
 AActor *AOGRGeometry::Duplicate(FName FromName, FName ToName)
@@ -102,19 +102,19 @@ bool FPCGOGRFilterElement::ExecuteInternal(FPCGContext* Context) const
 		return true;
 	}
 
-	OGRGeometry *Geometry = Settings->GeometryActor->Geometry;
-	if (!Geometry)
+	AOGRGeometry *GeometryActor = Settings->GeometryActor;
+	if (!GeometryActor->Geometry)
 	{
 		PCGE_LOG_C(Warning, GraphAndLog, Context,
 			FText::Format(
 				LOCTEXT("NoGeometry", "Unable to get OGR Geometry. Please make sure the OGRGeometry actor {0} is valid and initialized"),
-				FText::FromString(Settings->GeometryActor->GetActorNameOrLabel())
+				FText::FromString(GeometryActor->GetActorNameOrLabel())
 			)
 		);
 		return true;
 	}
 
-	OGRCoordinateTransformation *CoordinateTransformation = GDALInterface::MakeTransform(ThisContext->GlobalCoordinates->CRS, "EPSG:4326");
+	OGRCoordinateTransformation *CoordinateTransformation = GDALInterface::GetCachedTransform(ThisContext->GlobalCoordinates->CRS, "EPSG:4326");
 
 	for (const FPCGTaggedData& Input : Context->InputData.GetInputsByPin(PCGPinConstants::DefaultInputLabel))
 	{
@@ -142,88 +142,38 @@ bool FPCGOGRFilterElement::ExecuteInternal(FPCGContext* Context) const
 
 		Output.Data = FilteredData;
 
-		TMap<const FVector, FVector2D> PCGPointToPoint;
-		TSet<FVector2D> InsideLocations;
-		OGRMultiPoint *AllPoints = (OGRMultiPoint*) OGRGeometryFactory::createGeometry(OGRwkbGeometryType::wkbMultiPoint);
-		
-		if (!AllPoints)
-		{
-			PCGE_LOG_C(Error, GraphAndLog, Context, LOCTEXT("AllPointsNullPointer", "Couldn't create geometry"));
-			return true;
-		}
-
 		UE_LOG(LogSplineImporter, Log, TEXT("Exploring %d PCG points"), PCGPoints.Num());
 		
+		TArray<FVector2D> Locations;
+		Locations.Reserve(PCGPoints.Num());
 		for (const FPCGPoint& PCGPoint : PCGPoints)
 		{
 			const FVector& Location0 = PCGPoint.Transform.GetLocation();
-			const FVector2D& Location = { Location0.X, Location0.Y };
-			FVector2D Coordinates4326;
-
-			if (!ThisContext->GlobalCoordinates->GetCRSCoordinatesFromUnrealLocation(Location, CoordinateTransformation, Coordinates4326))
-			{
-				PCGE_LOG_C(Error, GraphAndLog, Context, LOCTEXT("NoData", "Internal error, unable to convert coordinates, make sure that your LevelCoordinates actor has correct values"));
-				return true;
-			}
-			OGRPoint Point4326(Coordinates4326[0], Coordinates4326[1]);
-			PCGPointToPoint.Add(Location0, Coordinates4326);
-			AllPoints->addGeometry(&Point4326);
-		}
-		UE_LOG(LogSplineImporter, Log, TEXT("Created All Points Geometry"));
-		
-		if (!AllPoints)
-		{
-			PCGE_LOG_C(Error, GraphAndLog, Context, LOCTEXT("AllPointsNullPointer", "Couldn't create geometry"));
-			return true;
-		}
-		OGRGeometry *Intersection = AllPoints->Intersection(Geometry);
-		
-		if (!Intersection)
-		{
-			PCGE_LOG_C(Error, GraphAndLog, Context, LOCTEXT("IntersectionNullPointer", "Couldn't compute intersection"));
-			return true;
+			Locations.Add({ Location0.X, Location0.Y });
 		}
 
-		if (wkbFlatten(Intersection->getGeometryType()) != wkbMultiPoint)
+		TArray<FVector2D> AllCoordinates4326;
+		if (!ThisContext->GlobalCoordinates->GetCRSCoordinatesFromUnrealLocations(Locations, CoordinateTransformation, AllCoordinates4326))
 		{
-			if (!Intersection->IsEmpty() && wkbFlatten(Intersection->getGeometryType()) != wkbPoint)
-			{
-				PCGE_LOG_C(Error, GraphAndLog, Context, FText::Format(LOCTEXT("IntersectionNullPointer", "Unexpected error: Intersection is not a multi-point geometry ({0})"), { wkbFlatten(Intersection->getGeometryType()) }));
-			}
-			UE_LOG(LogSplineImporter, Log, TEXT("Empty Intersection"));
+			PCGE_LOG_C(Error, GraphAndLog, Context, LOCTEXT("NoData", "Internal error, unable to convert coordinates, make sure that your LevelCoordinates actor has correct values"));
 			return true;
 		}
 
-		OGRMultiPoint* IntersectionPoints = Intersection->toMultiPoint();
-		
-		if (!IntersectionPoints)
+		TArray<bool> Inside;
+		if (!GeometryActor->IntersectsPoints(AllCoordinates4326, Inside))
 		{
-			PCGE_LOG_C(Error, GraphAndLog, Context, LOCTEXT("IntersectionNotPoints", "Couldn't compute intersection as a set of points"));
+			PCGE_LOG_C(Error, GraphAndLog, Context, LOCTEXT("IntersectionNullPointer", "Couldn't compute intersection"));
 			return true;
 		}
-		UE_LOG(LogSplineImporter, Log, TEXT("Valid Intersection Points with %d geometries"), IntersectionPoints->getNumGeometries());
-		
-		for (int i = 0, n = IntersectionPoints->getNumGeometries(); i < n; ++i)
-		{
-			OGRGeometry* PointGeometry = IntersectionPoints->getGeometryRef(i);
-			if (!PointGeometry) continue;
-			if (wkbFlatten(PointGeometry->getGeometryType()) != wkbPoint) continue;
-			OGRPoint* Point = PointGeometry->toPoint();
-			if (!Point) continue;
-			InsideLocations.Add(FVector2D(Point->getX(), Point->getY()));
-		}
-
-		UE_LOG(LogSplineImporter, Log, TEXT("Starting AsyncPointProcessing, found %d locations inside"), InsideLocations.Num());
 
+		UE_LOG(LogSplineImporter, Log, TEXT("Starting AsyncPointProcessing"));
 		
 		FPCGAsync::AsyncPointProcessing(Context, PCGPoints.Num(), FilteredPoints,
-			[InsideLocations, PCGPointToPoint, PCGPoints](int32 Index, FPCGPoint &OutPoint)
+			[&Inside, &PCGPoints](int32 Index, FPCGPoint &OutPoint)
 			{
-				const FPCGPoint& PCGPoint = PCGPoints[Index];
-				const FVector& Location = PCGPoint.Transform.GetLocation();
-				if (InsideLocations.Contains(PCGPointToPoint[Location]))
+				if (Inside[Index])
 				{
-					OutPoint = PCGPoint;
+					OutPoint = PCGPoints[Index];
 					return true;
 				}
 				else
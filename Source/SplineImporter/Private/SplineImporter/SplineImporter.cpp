@@ -4,6 +4,7 @@
 #include "SplineImporter/LogSplineImporter.h"
 #include "SplineImporter/Overpass.h"
 #include "LandscapeUtils/LandscapeUtils.h"
+#include "LandscapeUtils/HeightSampler.h"
 #include "GDALInterface/GDALInterface.h"
 #include "OSMUserData/OSMUserData.h"
 #include "LCCommon/LCSettings.h"
@@ -199,6 +200,15 @@ bool ASplineImporter::OnGenerate(FName SpawnedActorsPathOverride, bool bIsUserIn
 		return false;
 	}
 
+	// when splines are placed on a single landscape, heights are read from its heightmap instead of using line traces
+	HeightSampler Sampler(GetWorld(), CollisionQueryParams, bDebugLineTraces);
+	if (ActorsOrLandscapesToPlaceSplines.Num() == 1 && ActorsOrLandscapesToPlaceSplines[0]->IsA<ALandscape>())
+	{
+		Concurrency::RunOnGameThreadAndWait([&]() {
+			return Sampler.UseLandscapeHeightmap(Cast<ALandscape>(ActorsOrLandscapesToPlaceSplines[0]));
+		});
+	}
+
 	UGlobalCoordinates *GlobalCoordinates = ALevelCoordinates::GetGlobalCoordinates(this->GetWorld(), true);
 	if (!GlobalCoordinates) return false;
 
@@ -212,77 +222,166 @@ bool ASplineImporter::OnGenerate(FName SpawnedActorsPathOverride, bool bIsUserIn
 		return false;
 	}
 
-#if WITH_EDITOR
+#if !WITH_EDITOR
 	if (bUseLandscapeSplines)
 	{
-		return Concurrency::RunOnGameThreadAndWait([&]() {
-			if (GenerateLandscapeSplines(bIsUserInitiated, Landscape, CollisionQueryParams, OGRTransform, GlobalCoordinates, PointLists))
-			{
-#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 7)
-				if (bFlushPCGCacheAfterImport)
-					if (UPCGSubsystem* PCGSubsystem = UPCGSubsystem::GetSubsystemForCurrentWorld())
-						PCGSubsystem->FlushCache();
-#endif
-				return true;
-			}
-			else
-			{
-				return false;
-			}
-		});
+		UE_LOG(LogSplineImporter, Error, TEXT("Cannot create landscape splines at runtime"));
+		return false;
 	}
-	else
-	{
-		return Concurrency::RunOnGameThreadAndWait([&]() {
-			if (GenerateRegularSplines(bIsUserInitiated, SpawnedActorsPathOverride, CollisionQueryParams, OGRTransform, GlobalCoordinates, PointLists))
-			{
-#if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 7)
-				if (bFlushPCGCacheAfterImport)
-					if (UPCGSubsystem* PCGSubsystem = UPCGSubsystem::GetSubsystemForCurrentWorld())
-						PCGSubsystem->FlushCache();
 #endif
-				return true;
-			}
-			else
-			{
-				return false;
-			}
-		});
-	}
-#else
 
-	if (bUseLandscapeSplines)
+	// coordinates and heights are computed on this thread, and only the spline components are created on the game thread
+	TArray<FSampledPointList> SampledPointLists;
+	if (!SamplePointLists(Sampler, OGRTransform, GlobalCoordinates, !bUseLandscapeSplines, PointLists, SampledPointLists))
 	{
-		UE_LOG(LogSplineImporter, Error, TEXT("Cannot create landscape splines at runtime"));
 		return false;
 	}
+
 	return Concurrency::RunOnGameThreadAndWait([&]() {
-		if (GenerateRegularSplines(bIsUserInitiated, SpawnedActorsPathOverride, CollisionQueryParams, OGRTransform, GlobalCoordinates, PointLists))
-		{
+#if WITH_EDITOR
+		const bool bSuccess = bUseLandscapeSplines ?
+			GenerateLandscapeSplines(bIsUserInitiated, Landscape, PointLists, SampledPointLists) :
+			GenerateRegularSplines(bIsUserInitiated, SpawnedActorsPathOverride, PointLists, SampledPointLists);
+#else
+		const bool bSuccess = GenerateRegularSplines(bIsUserInitiated, SpawnedActorsPathOverride, PointLists, SampledPointLists);
+#endif
+		if (!bSuccess) return false;
+
 #if ENGINE_MAJOR_VERSION > 5 || (ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 7)
-			if (bFlushPCGCacheAfterImport)
-				if (UPCGSubsystem* PCGSubsystem = UPCGSubsystem::GetSubsystemForCurrentWorld())
-					PCGSubsystem->FlushCache();
+		if (bFlushPCGCacheAfterImport)
+			if (UPCGSubsystem* PCGSubsystem = UPCGSubsystem::GetSubsystemForCurrentWorld())
+				PCGSubsystem->FlushCache();
 #endif
-			return true;
+		return true;
+	});
+}
+
+bool ASplineImporter::SamplePointLists(
+	const HeightSampler &Sampler,
+	OGRCoordinateTransformation *OGRTransform,
+	UGlobalCoordinates *GlobalCoordinates,
+	bool bRegularSplines,
+	const TArray<FPointList> &PointLists,
+	TArray<FSampledPointList> &OutSampledPointLists
+)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE_STR("ASplineImporter::SamplePointLists");
+
+	const bool bResample = bRegularSplines && bResamplePointsAtDistance;
+	if (bResample && ResampleDistance <= 0)
+	{
+		LCReporter::ShowError(LOCTEXT("ResampleDistance", "Resample Distance must be positive."));
+		return false;
+	}
+
+	OutSampledPointLists.Empty();
+	OutSampledPointLists.SetNum(PointLists.Num());
+
+	// all the points are sent to the sampler at once, so that heights are computed in parallel over all splines
+	TArray<FVector2D> AllPoints;
+	for (int i = 0; i < PointLists.Num(); i++)
+	{
+		const TArray<OGRPoint> &Points = PointLists[i].Points;
+		TArray<FVector2D> &UE2DPoints = OutSampledPointLists[i].Points;
+
+		int NumPoints = Points.Num();
+		if (NumPoints == 0) continue;
+
+		// don't add last point in case a regular spline is a closed loop
+		if (bRegularSplines && Points[0] == Points.Last()) NumPoints--;
+
+		UE2DPoints.Reserve(NumPoints);
+		for (int j = 0; j < NumPoints; j++)
+		{
+			double x = 0;
+			double y = 0;
+			if (!GetUECoordinates(Points[j].getX(), Points[j].getY(), OGRTransform, GlobalCoordinates, x, y))
+			{
+				UE2DPoints.Empty();
+				break;
+			}
+			UE2DPoints.Add({ x, y });
 		}
-		else
+
+		if (bResample && !UE2DPoints.IsEmpty())
 		{
-			return false;
+			ResamplePoints(UE2DPoints);
 		}
-	});
 
+		AllPoints.Append(UE2DPoints);
+	}
 
-#endif
+	TArray<double> AllZs;
+	TArray<bool> AllHits;
+	Sampler.GetZs(AllPoints, AllZs, AllHits);
+
+	int Offset = 0;
+	for (FSampledPointList &SampledPointList : OutSampledPointLists)
+	{
+		const int NumPoints = SampledPointList.Points.Num();
+		SampledPointList.Zs = TArray<double>(AllZs.GetData() + Offset, NumPoints);
+		SampledPointList.Hits = TArray<bool>(AllHits.GetData() + Offset, NumPoints);
+		Offset += NumPoints;
+	}
+
+	return true;
+}
+
+void ASplineImporter::ResamplePoints(TArray<FVector2D> &UE2DPoints) const
+{
+	// the points are resampled along the curve that a spline component would make with them,
+	// using the spline curves directly instead of a temporary component, so that this can run on any thread
+	FSplineCurves Curves;
+	for (int i = 0; i < UE2DPoints.Num(); i++)
+	{
+		const FVector Location(UE2DPoints[i].X, UE2DPoints[i].Y, 0);
+		Curves.Position.Points.Emplace(i, Location, FVector::ZeroVector, FVector::ZeroVector, CIM_CurveAuto);
+		Curves.Rotation.Points.Emplace(i, FQuat::Identity, FQuat::Identity, FQuat::Identity, CIM_CurveAuto);
+		Curves.Scale.Points.Emplace(i, FVector::OneVector, FVector::ZeroVector, FVector::ZeroVector, CIM_CurveAuto);
+	}
+	Curves.UpdateSpline();
+
+	auto GetLocationAtDistance = [&Curves](float Distance) {
+		const float Key = Curves.ReparamTable.Eval(Distance, 0.0f);
+		const FVector V = Curves.Position.Eval(Key, FVector::ZeroVector);
+		return FVector2D(V.X, V.Y);
+	};
+
+	float SplineLength = Curves.GetSplineLength();
+	UE2DPoints.Empty(SplineLength / ResampleDistance + 1);
+
+	float CurrentDistance = 0;
+
+	if (bExactDistance)
+	{
+		while (CurrentDistance <= SplineLength)
+		{
+			UE2DPoints.Add(GetLocationAtDistance(CurrentDistance));
+			CurrentDistance += ResampleDistance;
+		}
+
+		// if the last sampled pointed is not at the end of the spline, add one point
+		if (CurrentDistance - ResampleDistance < SplineLength)
+		{
+			UE2DPoints.Add(GetLocationAtDistance(SplineLength));
+		}
+	}
+	else
+	{
+		int n = FMath::FloorToInt(SplineLength / ResampleDistance) + 2;
+		float Interval = SplineLength / (n - 1);
+		for (int i = 0; i < n; i++)
+		{
+			UE2DPoints.Add(GetLocationAtDistance(i * Interval));
+		}
+	}
 }
 
 bool ASplineImporter::GenerateRegularSplines(
 	bool bIsUserInitiated,
 	FName SpawnedActorsPathOverride,
-	FCollisionQueryParams CollisionQueryParams,
-	OGRCoordinateTransformation *OGRTransform,
-	UGlobalCoordinates *GlobalCoordinates,
-	TArray<FPointList> &PointLists
+	TArray<FPointList> &PointLists,
+	const TArray<FSampledPointList> &SampledPointLists
 )
 {
 	UWorld *World = GetWorld();
@@ -328,6 +427,7 @@ bool ASplineImporter::GenerateRegularSplines(
 	bool bAtLeastOneSuccess = false;
 	for (auto &PointList : PointLists)
 	{
+		const FSampledPointList &SampledPointList = SampledPointLists[i];
 		i++;
 		if (SplineOwnerKind == ESplineOwnerKind::ManySplineCollections)
 		{
@@ -388,7 +488,7 @@ bool ASplineImporter::GenerateRegularSplines(
 			SplineOwners.Add(SplineOwner);
 		}
 
-		if (AddRegularSpline(SplineOwner, CollisionQueryParams, OGRTransform, GlobalCoordinates, PointList))
+		if (AddRegularSpline(SplineOwner, PointList, SampledPointList))
 			bAtLeastOneSuccess = true;
 	}
 
@@ -407,14 +507,10 @@ bool ASplineImporter::GenerateRegularSplines(
 
 bool ASplineImporter::AddRegularSpline(
 	AActor* SplineOwner,
-	FCollisionQueryParams CollisionQueryParams,
-	OGRCoordinateTransformation *OGRTransform,
-	UGlobalCoordinates *GlobalCoordinates,
-	FPointList &PointList
+	FPointList &PointList,
+	const FSampledPointList &SampledPointList
 )
 {
-	UWorld *World = SplineOwner->GetWorld();
-	
 	int NumPoints = PointList.Points.Num();
 	if (NumPoints == 0) return false;
 
@@ -464,83 +560,19 @@ bool ASplineImporter::AddRegularSpline(
 	int ExpectedNumPoints = NumPoints;
 	if (bIsLoop) ExpectedNumPoints--;  // don't add last point in case the spline is a closed loop
 
-	TArray<FVector2D> UE2DPoints;
-	for (int i = 0; i < ExpectedNumPoints; i++)
-	{
-		OGRPoint Point = PointList.Points[i];
-		double Longitude = Point.getX();
-		double Latitude = Point.getY();
-
-		double x = 0;
-		double y = 0;
-
-		if (!GetUECoordinates(Longitude, Latitude, OGRTransform, GlobalCoordinates, x, y)) return false;
-		
-		UE2DPoints.Add({ x, y });
-	}
-
-	if (bResamplePointsAtDistance)
-	{
-		if (ResampleDistance <= 0)
-		{
-			LCReporter::ShowError(LOCTEXT("ResampleDistance", "Resample Distance must be positive."));
-			return false;
-		}
-
-		TObjectPtr<USplineComponent> TemporarySpline = NewObject<USplineComponent>();
-		TemporarySpline->ClearSplinePoints();
-		for (auto &UE2DPoint: UE2DPoints)
-		{
-			TemporarySpline->AddSplinePoint( { UE2DPoint.X, UE2DPoint.Y, 0 }, ESplineCoordinateSpace::World, false);
-		}
-		TemporarySpline->UpdateSpline();
-
-		float SplineLength = TemporarySpline->GetSplineLength();
-		UE2DPoints.Empty(SplineLength / ResampleDistance + 1);
-
-		float CurrentDistance = 0;
-
-		if (bExactDistance)
-		{
-			while (CurrentDistance <= SplineLength)
-			{
-				FVector V = TemporarySpline->GetLocationAtDistanceAlongSpline(CurrentDistance, ESplineCoordinateSpace::World);
-				UE2DPoints.Add({ V.X, V.Y });
-				CurrentDistance += ResampleDistance;
-			}
-
-			// if the last sampled pointed is not at the end of the spline, add one point
-			if (CurrentDistance - ResampleDistance < SplineLength)
-			{
-				FVector V = TemporarySpline->GetLocationAtDistanceAlongSpline(SplineLength, ESplineCoordinateSpace::World);
-				UE2DPoints.Add({ V.X, V.Y });
-			}
-		}
-		else
-		{
-			int n = FMath::FloorToInt(SplineLength / ResampleDistance) + 2;
-			float Interval = SplineLength / (n - 1);
-			for (int i = 0; i < n; i++)
-			{
-				FVector V = TemporarySpline->GetLocationAtDistanceAlongSpline(i * Interval, ESplineCoordinateSpace::World);
-				UE2DPoints.Add({ V.X, V.Y });
-			}
-		}
-
-		TemporarySpline->MarkAsGarbage();
-	}
-
-
-
 	TArray<FVector> SplinePoints;
 	TArray<FVector2D> SplinePoints2D;
 
-	for (auto &UE2DPoint: UE2DPoints)
+	const TArray<FVector2D> &UE2DPoints = SampledPointList.Points;
+	const TArray<double> &Zs = SampledPointList.Zs;
+	const TArray<bool> &Hits = SampledPointList.Hits;
+
+	for (int i = 0; i < UE2DPoints.Num(); i++)
 	{
-		double z = 0;
-		if (LandscapeUtils::GetZ(World, CollisionQueryParams, UE2DPoint.X, UE2DPoint.Y, z, bDebugLineTraces))
+		const FVector2D &UE2DPoint = UE2DPoints[i];
+		if (Hits[i])
 		{
-			FVector Location = FVector(UE2DPoint.X, UE2DPoint.Y, z) + SplinePointsOffset;
+			FVector Location = FVector(UE2DPoint.X, UE2DPoint.Y, Zs[i]) + SplinePointsOffset;
 			SplinePoints.Add(Location);
 			SplinePoints2D.Add( { Location.X, Location.Y });
 		}
@@ -671,10 +703,8 @@ bool ASplineImporter::Cleanup_Implementation(bool bSkipPrompt)
 bool ASplineImporter::GenerateLandscapeSplines(
 	bool bIsUserInitiated,
 	ALandscape* Landscape,
-	FCollisionQueryParams CollisionQueryParams,
-	OGRCoordinateTransformation* OGRTransform,
-	UGlobalCoordinates* GlobalCoordinates,
-	TArray<FPointList>& PointLists
+	TArray<FPointList>& PointLists,
+	const TArray<FSampledPointList>& SampledPointLists
 )
 {
 	FString LandscapeLabel = Landscape->GetActorNameOrLabel();
@@ -734,9 +764,9 @@ bool ASplineImporter::GenerateLandscapeSplines(
 
 	const int NumLists = PointLists.Num();
 
-	for (auto& PointList : PointLists)
+	for (int i = 0; i < NumLists; i++)
 	{
-		AddLandscapeSplinesPoints(CollisionQueryParams, OGRTransform, GlobalCoordinates, LandscapeSplinesComponent, PointList, Points);
+		AddLandscapeSplinesPoints(LandscapeSplinesComponent, PointLists[i], SampledPointLists[i], Points);
 	}
 
 	UE_LOG(LogSplineImporter, Log, TEXT("Found %d control points"), Points.Num());
@@ -784,32 +814,29 @@ bool ASplineImporter::GenerateLandscapeSplines(
 }
 
 void ASplineImporter::AddLandscapeSplinesPoints(
-	FCollisionQueryParams CollisionQueryParams,
-	OGRCoordinateTransformation* OGRTransform,
-	UGlobalCoordinates* GlobalCoordinates,
 	ULandscapeSplinesComponent* LandscapeSplinesComponent,
 	FPointList& PointList,
+	const FSampledPointList& SampledPointList,
 	TMap<FVector2D, ULandscapeSplineControlPoint*>& ControlPoints
 )
 {
 	if (!IsValid(LandscapeSplinesComponent)) return;
-	UWorld* World = LandscapeSplinesComponent->GetWorld();
-	if (!IsValid(World)) return;
 	FTransform WorldToComponent = LandscapeSplinesComponent->GetComponentToWorld().Inverse();
 
-	for (OGRPoint& Point : PointList.Points)
-	{
-		double Longitude = Point.getX();
-		double Latitude = Point.getY();
+	const TArray<FVector2D> &UE2DPoints = SampledPointList.Points;
+	const TArray<double> &Zs = SampledPointList.Zs;
+	const TArray<bool> &Hits = SampledPointList.Hits;
 
-		double x = 0;
-		double y = 0;
-		if (!GetUECoordinates(Longitude, Latitude, OGRTransform, GlobalCoordinates, x, y)) return;
+	for (int i = 0; i < UE2DPoints.Num(); i++)
+	{
+		double Longitude = PointList.Points[i].getX();
+		double Latitude = PointList.Points[i].getY();
+		double x = UE2DPoints[i].X;
+		double y = UE2DPoints[i].Y;
 
-		double z = 0;
-		if (LandscapeUtils::GetZ(World, CollisionQueryParams, x, y, z, bDebugLineTraces))
+		if (Hits[i])
 		{
-			FVector Location = FVector(x, y, z) + SplinePointsOffset;
+			FVector Location = FVector(x, y, Zs[i]) + SplinePointsOffset;
 			FVector LocalLocation = LandscapeSplinesComponent->GetComponentToWorld().InverseTransformPosition(Location);
 			ULandscapeSplineControlPoint* ControlPoint = NewObject<ULandscapeSplineControlPoint>(LandscapeSplinesComponent, NAME_None, RF_Transactional);
 			ControlPoint->Location = LocalLocation;
@@ -33,15 +33,27 @@ public:
 
 	virtual bool Cleanup_Implementation(bool bSkipPrompt) override {
 		Modify();
-		Geometry = nullptr;
+		SetGeometry(nullptr);
 		AlreadyHandledFeatures.Empty();
 		return true;
 	}
 
+	/* Tests which points (in EPSG:4326) intersect the geometry, using a prepared geometry.
+	 * Returns false when there is no geometry. Can be called from any thread. */
+	bool IntersectsPoints(const TArray<FVector2D> &Points, TArray<bool> &OutIntersects) const;
+
 #if WITH_EDITOR
 	virtual AActor* Duplicate(FName FromName, FName ToName) override;
 #endif
 
 protected:
 	virtual void SetOverpassShortQuery() override;
+
+private:
+	/* Replaces Geometry (which is then owned by this actor) and its prepared geometry */
+	void SetGeometry(OGRGeometry *NewGeometry);
+
+	mutable FCriticalSection PreparedGeometryLock;
+	OGRPreparedGeometryUniquePtr PreparedGeometry;
+	OGREnvelope Envelope;
 };
@@ -19,6 +19,16 @@
 
 #define LOCTEXT_NAMESPACE "FSplineImporterModule"
 
+class HeightSampler;
+
+/* Points of a FPointList converted to Unreal coordinates, with their ground heights */
+struct FSampledPointList
+{
+	TArray<FVector2D> Points;
+	TArray<double> Zs;
+	TArray<bool> Hits;
+};
+
 UENUM(BlueprintType)
 enum class ESplineOwnerKind : uint8
 {
@@ -194,39 +204,44 @@ protected:
 
 	virtual void SetOverpassShortQuery() override;
 
+	/* Converts the points to Unreal coordinates, resamples them for regular splines, and computes their heights.
+	 * This doesn't touch any component, so that it can be done before going to the game thread. */
+	bool SamplePointLists(
+		const HeightSampler &Sampler,
+		OGRCoordinateTransformation *OGRTransform,
+		UGlobalCoordinates *GlobalCoordinates,
+		bool bRegularSplines,
+		const TArray<FPointList> &PointLists,
+		TArray<FSampledPointList> &OutSampledPointLists
+	);
+
+	void ResamplePoints(TArray<FVector2D> &UE2DPoints) const;
+
 	bool GenerateRegularSplines(
 		bool bIsUserInitiated,
 		FName SpawnedActorsPathOverride,
-		FCollisionQueryParams CollisionQueryParams,
-		OGRCoordinateTransformation *OGRTransform,
-		UGlobalCoordinates *GlobalCoordinates,
-		TArray<FPointList> &PointLists
+		TArray<FPointList> &PointLists,
+		const TArray<FSampledPointList> &SampledPointLists
 	);
 
 	bool AddRegularSpline(
 		AActor* SplineOwner,
-		FCollisionQueryParams CollisionQueryParams,
-		OGRCoordinateTransformation *OGRTransform,
-		UGlobalCoordinates *GlobalCoordinates,
-		FPointList &PointList
+		FPointList &PointList,
+		const FSampledPointList &SampledPointList
 	);
 
 #if WITH_EDITOR
 	bool GenerateLandscapeSplines(
 		bool bIsUserInitiated,
 		ALandscape* Landscape,
-		FCollisionQueryParams CollisionQueryParams,
-		OGRCoordinateTransformation* OGRTransform,
-		UGlobalCoordinates* GlobalCoordinates,
-		TArray<FPointList>& PointLists
+		TArray<FPointList>& PointLists,
+		const TArray<FSampledPointList>& SampledPointLists
 	);
 
 	void AddLandscapeSplinesPoints(
-		FCollisionQueryParams CollisionQueryParams,
-		OGRCoordinateTransformation* OGRTransform,
-		UGlobalCoordinates* GlobalCoordinates,
 		ULandscapeSplinesComponent* LandscapeSplinesComponent,
 		FPointList& PointList,
+		const FSampledPointList& SampledPointList,
 		TMap<FVector2D, ULandscapeSplineControlPoint*>& Points
 	);
 